@@ -0,0 +1,138 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkOMEZarrNGFFBatchWriter_h
+#define itkOMEZarrNGFFBatchWriter_h
+
+#include <deque>
+#include <string>
+#include <type_traits>
+#include "itkImage.h"
+#include "itkOMEZarrNGFFImageIO.h"
+
+namespace itk
+{
+/** \class OMEZarrNGFFBatchWriter
+ *
+ * \brief Write many small images of the same size into one OME-Zarr store.
+ *
+ * The images are stacked along the leading "t" axis of a TCZYX store holding NumberOfImages
+ * images, each of them at the next index. The store is created on the first Append, with
+ * the size and spacing of the first image, so the group and array metadata are written once.
+ * Each Append then writes only the chunks of its image, through one IO object which keeps
+ * the array and its context open. The chunks are encoded and stored asynchronously,
+ * while the next images are produced, with at most MaximumNumberOfPendingImages images in flight:
+ * once that many are pending, Append waits for the oldest one only.
+ *
+ * Images which are not written hold 0. The origins of the images are not stored.
+ * Not supported for zip archives. Append is not thread-safe.
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+template <typename TImage>
+class ITK_TEMPLATE_EXPORT OMEZarrNGFFBatchWriter : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(OMEZarrNGFFBatchWriter);
+
+  /** Standard class typedefs. */
+  using Self = OMEZarrNGFFBatchWriter;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(OMEZarrNGFFBatchWriter, Object);
+
+  static constexpr unsigned ImageDimension = TImage::ImageDimension;
+  static_assert(ImageDimension <= 3, "Images span the spatial axes only");
+  static_assert(std::is_arithmetic_v<typename TImage::PixelType>, "Only scalar pixel types are supported");
+
+  using ImageType = TImage;
+  using PixelType = typename ImageType::PixelType;
+  using SizeType = typename ImageType::SizeType;
+
+  itkSetStringMacro(FileName);
+  itkGetStringMacro(FileName);
+
+  /** Number of images the store holds. Must be set before the first Append. */
+  itkSetMacro(NumberOfImages, SizeValueType);
+  itkGetConstMacro(NumberOfImages, SizeValueType);
+
+  /** Chunk size of the store over the spatial axes. Zero entries take the size of the images,
+   * which is the default, so that each image is one chunk. */
+  itkSetMacro(ChunkSize, SizeType);
+  itkGetConstReferenceMacro(ChunkSize, SizeType);
+
+  /** Compressor of the store, see OMEZarrNGFFImageIO. Empty for the default. */
+  itkSetStringMacro(Compressor);
+  itkGetStringMacro(Compressor);
+
+  /** Number of appended images whose chunks may still be encoded and stored,
+   * each holding a copy of its pixels. 64 by default. */
+  itkSetMacro(MaximumNumberOfPendingImages, SizeValueType);
+  itkGetConstMacro(MaximumNumberOfPendingImages, SizeValueType);
+
+  /** Write the buffered region of `image` at the next index, creating the store on the first call.
+   * All images must have the size of the first one. Returns the index of the image in the store. */
+  SizeValueType
+  Append(const ImageType * image);
+
+  /** Wait until the appended images have been stored. Throws if any of them failed. */
+  void
+  Flush();
+
+  /** Flush, and release the store. The next Append creates a new store. */
+  void
+  Close();
+
+  /** Number of images appended to the current store. */
+  itkGetConstMacro(NumberOfAppendedImages, SizeValueType);
+
+protected:
+  OMEZarrNGFFBatchWriter() = default;
+  ~OMEZarrNGFFBatchWriter() override;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Create the store for images like `image`, and the IO which writes into it. */
+  void
+  CreateStore(const ImageType * image);
+
+private:
+  std::string   m_FileName;
+  SizeValueType m_NumberOfImages = 0;
+  SizeType      m_ChunkSize{};
+  std::string   m_Compressor;
+  SizeValueType m_MaximumNumberOfPendingImages = 64;
+
+  OMEZarrNGFFImageIO::Pointer m_ImageIO; // created on the first Append
+  SizeType                    m_ImageSize{};
+  SizeValueType               m_NumberOfAppendedImages = 0;
+  std::deque<SizeValueType>   m_PendingChunkWrites; // number of chunk writes of each pending image, oldest first
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkOMEZarrNGFFBatchWriter.hxx"
+#endif
+
+#endif // itkOMEZarrNGFFBatchWriter_h
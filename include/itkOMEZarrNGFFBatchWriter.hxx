@@ -0,0 +1,168 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkOMEZarrNGFFBatchWriter_hxx
+#define itkOMEZarrNGFFBatchWriter_hxx
+
+#include <algorithm>
+#include <vector>
+
+namespace itk
+{
+template <typename TImage>
+OMEZarrNGFFBatchWriter<TImage>::~OMEZarrNGFFBatchWriter()
+{
+  try
+  {
+    this->Flush();
+  }
+  catch (const ExceptionObject & e)
+  {
+    itkWarningMacro(<< "Failed to store appended images: " << e.GetDescription());
+  }
+}
+
+
+template <typename TImage>
+void
+OMEZarrNGFFBatchWriter<TImage>::CreateStore(const ImageType * image)
+{
+  if (m_NumberOfImages == 0)
+  {
+    itkExceptionMacro(<< "NumberOfImages must be set before the first Append");
+  }
+
+  // TCZYX, with the unused spatial axes of size 1
+  const SizeType imageSize = image->GetBufferedRegion().GetSize();
+  auto           imageIO = OMEZarrNGFFImageIO::New();
+  imageIO->SetFileName(m_FileName);
+  imageIO->SetNumberOfDimensions(5);
+  std::vector<SizeValueType> chunkSize(3, 1); // and 1 along c and t
+  for (unsigned d = 0; d < ImageDimension; ++d)
+  {
+    imageIO->SetDimensions(d, imageSize[d]);
+    imageIO->SetSpacing(d, image->GetSpacing()[d]);
+    chunkSize[d] = m_ChunkSize[d] > 0 ? m_ChunkSize[d] : imageSize[d];
+  }
+  for (unsigned d = ImageDimension; d < 4; ++d)
+  {
+    imageIO->SetDimensions(d, 1);
+  }
+  imageIO->SetDimensions(4, m_NumberOfImages);
+  imageIO->SetPixelTypeInfo(static_cast<const PixelType *>(nullptr));
+  imageIO->SetChunkSize(chunkSize);
+  if (!m_Compressor.empty())
+  {
+    imageIO->SetCompressor(m_Compressor);
+  }
+  imageIO->CreateStore();
+
+  // Chunks along t hold one image, so the images are written as aligned regions of a store which is not resized
+  imageIO->SetWriteMode(OMEZarrNGFFImageIOEnums::WriteMode::Parallel);
+  imageIO->SetChannelIndex(0);
+  imageIO->AsynchronousWriteOn();
+  m_ImageIO = imageIO;
+  m_ImageSize = imageSize;
+  m_NumberOfAppendedImages = 0;
+  m_PendingChunkWrites.clear();
+}
+
+
+template <typename TImage>
+SizeValueType
+OMEZarrNGFFBatchWriter<TImage>::Append(const ImageType * image)
+{
+  if (!m_ImageIO)
+  {
+    this->CreateStore(image);
+  }
+  const auto & region = image->GetBufferedRegion();
+  if (region.GetSize() != m_ImageSize)
+  {
+    itkExceptionMacro(<< "The image size " << region.GetSize() << " differs from the size " << m_ImageSize
+                      << " of the images in " << m_FileName);
+  }
+  if (m_NumberOfAppendedImages >= m_NumberOfImages)
+  {
+    itkExceptionMacro(<< "The store " << m_FileName << " is full, it holds " << m_NumberOfImages << " images");
+  }
+
+  ImageIORegion ioRegion(3);
+  for (unsigned d = 0; d < 3; ++d)
+  {
+    ioRegion.SetSize(d, d < ImageDimension ? region.GetSize(d) : 1);
+  }
+  m_ImageIO->SetTimeIndex(m_NumberOfAppendedImages);
+  m_ImageIO->SetIORegion(ioRegion);
+  const SizeValueType pendingBefore = m_ImageIO->GetNumberOfPendingWrites();
+  m_ImageIO->Write(image->GetBufferPointer());
+  m_PendingChunkWrites.push_back(m_ImageIO->GetNumberOfPendingWrites() - pendingBefore);
+
+  // Keep the later images in flight while the oldest one completes
+  while (m_PendingChunkWrites.size() >= std::max<SizeValueType>(m_MaximumNumberOfPendingImages, 1))
+  {
+    const SizeValueType oldestChunkWrites = m_PendingChunkWrites.front();
+    m_PendingChunkWrites.pop_front();
+    m_ImageIO->WaitForOldestPendingWrites(oldestChunkWrites);
+  }
+  return m_NumberOfAppendedImages++;
+}
+
+
+template <typename TImage>
+void
+OMEZarrNGFFBatchWriter<TImage>::Flush()
+{
+  m_PendingChunkWrites.clear();
+  if (m_ImageIO)
+  {
+    m_ImageIO->WaitForPendingWrites();
+  }
+}
+
+
+template <typename TImage>
+void
+OMEZarrNGFFBatchWriter<TImage>::Close()
+{
+  auto imageIO = m_ImageIO;
+  m_ImageIO = nullptr; // released even if the pending writes failed
+  m_NumberOfAppendedImages = 0;
+  m_PendingChunkWrites.clear();
+  if (imageIO)
+  {
+    imageIO->WaitForPendingWrites();
+  }
+}
+
+
+template <typename TImage>
+void
+OMEZarrNGFFBatchWriter<TImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "NumberOfImages: " << m_NumberOfImages << std::endl;
+  os << indent << "ChunkSize: " << m_ChunkSize << std::endl;
+  os << indent << "Compressor: " << m_Compressor << std::endl;
+  os << indent << "MaximumNumberOfPendingImages: " << m_MaximumNumberOfPendingImages << std::endl;
+  os << indent << "NumberOfAppendedImages: " << m_NumberOfAppendedImages << std::endl;
+}
+} // end namespace itk
+
+#endif // itkOMEZarrNGFFBatchWriter_hxx
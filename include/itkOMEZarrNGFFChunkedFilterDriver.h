@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkOMEZarrNGFFChunkedFilterDriver_h
+#define itkOMEZarrNGFFChunkedFilterDriver_h
+
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "itkImage.h"
+#include "itkImageToImageFilter.h"
+#include "itkOMEZarrNGFFImageIO.h"
+
+namespace itk
+{
+/** \class OMEZarrNGFFChunkedFilterDriver
+ *
+ * \brief Apply a filter to an OME-Zarr image out of core, one output chunk at a time.
+ *
+ * The output store is created with the spatial shape, spacing and origin of the input
+ * dataset, at the selected time point and channel. Then, for each chunk of the output
+ * chunk grid, the input tile covering the chunk and a halo around it (clipped to the image)
+ * is read, the tile function computes the output chunk from it, and the result is written
+ * to the output store. Tiles are processed in parallel, each reading through ReadRegion
+ * of one shared input IO, and writing through its own output IO in WriteMode Parallel,
+ * so memory use is bounded by the number of work units times the padded tile size.
+ *
+ * The halo must cover the neighborhood the filter uses for each output pixel,
+ * e.g. the kernel radius of a smoothing filter, for the result to match filtering
+ * the whole image. At the image boundary, the filter's own boundary condition applies.
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+template <typename TInputImage, typename TOutputImage = TInputImage>
+class ITK_TEMPLATE_EXPORT OMEZarrNGFFChunkedFilterDriver : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(OMEZarrNGFFChunkedFilterDriver);
+
+  /** Standard class typedefs. */
+  using Self = OMEZarrNGFFChunkedFilterDriver;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(OMEZarrNGFFChunkedFilterDriver, Object);
+
+  static constexpr unsigned ImageDimension = TInputImage::ImageDimension;
+  static_assert(TOutputImage::ImageDimension == ImageDimension, "Input and output dimensions must match");
+  static_assert(ImageDimension <= 3, "Tiles span the spatial axes only");
+  static_assert(std::is_arithmetic_v<typename TInputImage::PixelType> &&
+                  std::is_arithmetic_v<typename TOutputImage::PixelType>,
+                "Only scalar pixel types are supported");
+
+  using InputImageType = TInputImage;
+  using OutputImageType = TOutputImage;
+  using OutputImagePointer = typename OutputImageType::Pointer;
+  using RegionType = typename OutputImageType::RegionType;
+  using SizeType = typename OutputImageType::SizeType;
+  using FilterType = ImageToImageFilter<InputImageType, OutputImageType>;
+
+  /** Computes an output tile from a padded input tile. The input tile has the geometry of
+   * the input image, and its buffered region is the padded region. The returned image must
+   * contain the requested output region in its buffered region. Called concurrently. */
+  using TileFunctionType = std::function<OutputImagePointer(const InputImageType * paddedTile, const RegionType &)>;
+
+  /** Creates a new filter. One filter is created per tile, so that tiles are independent. */
+  using FilterFactoryType = std::function<typename FilterType::Pointer()>;
+
+  itkSetStringMacro(InputFileName);
+  itkGetStringMacro(InputFileName);
+  itkSetStringMacro(OutputFileName);
+  itkGetStringMacro(OutputFileName);
+
+  /** Time point and channel of the input dataset to process, when it has these axes. 0 by default. */
+  itkSetMacro(TimeIndex, int);
+  itkGetConstMacro(TimeIndex, int);
+  itkSetMacro(ChannelIndex, int);
+  itkGetConstMacro(ChannelIndex, int);
+
+  /** Padding read around each output chunk. Zero by default. */
+  itkSetMacro(Halo, SizeType);
+  itkGetConstReferenceMacro(Halo, SizeType);
+
+  /** Chunk size of the output store, which is also the tile size. 64 along each axis by default. */
+  itkSetMacro(ChunkSize, SizeType);
+  itkGetConstReferenceMacro(ChunkSize, SizeType);
+
+  /** Compressor of the output store, see OMEZarrNGFFImageIO. Empty for the default. */
+  itkSetStringMacro(Compressor);
+  itkGetStringMacro(Compressor);
+
+  /** Number of tiles processed concurrently. By default, the global default number of threads. */
+  itkSetMacro(NumberOfWorkUnits, unsigned);
+  itkGetConstMacro(NumberOfWorkUnits, unsigned);
+
+  /** Set the tile function. */
+  void
+  SetTileFunction(const TileFunctionType & tileFunction)
+  {
+    m_TileFunction = tileFunction;
+    this->Modified();
+  }
+
+  /** Set a tile function which runs a new filter from the factory on each tile,
+   * requesting just the output tile. */
+  void
+  SetFilterFactory(const FilterFactoryType & filterFactory);
+
+  /** Process all tiles. Throws if reading, filtering or writing any tile fails,
+   * after the tiles in progress have been completed. */
+  void
+  Update();
+
+protected:
+  OMEZarrNGFFChunkedFilterDriver();
+  ~OMEZarrNGFFChunkedFilterDriver() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** An output IO with the image information of the output store. */
+  OMEZarrNGFFImageIO::Pointer
+  MakeOutputImageIO(const OMEZarrNGFFImageIO * inputIO) const;
+
+  /** Read, filter and write the tile of one output chunk. */
+  void
+  ProcessTile(const OMEZarrNGFFImageIO * inputIO, OMEZarrNGFFImageIO * outputIO, const RegionType & tileRegion) const;
+
+private:
+  std::string      m_InputFileName;
+  std::string      m_OutputFileName;
+  int              m_TimeIndex = 0;
+  int              m_ChannelIndex = 0;
+  SizeType         m_Halo{};
+  SizeType         m_ChunkSize;
+  std::string      m_Compressor;
+  unsigned         m_NumberOfWorkUnits;
+  TileFunctionType m_TileFunction;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkOMEZarrNGFFChunkedFilterDriver.hxx"
+#endif
+
+#endif // itkOMEZarrNGFFChunkedFilterDriver_h
@@ -0,0 +1,270 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkOMEZarrNGFFChunkedFilterDriver_hxx
+#define itkOMEZarrNGFFChunkedFilterDriver_hxx
+
+#include <atomic>
+#include <mutex>
+#include "itkImageAlgorithm.h"
+#include "itkMultiThreaderBase.h"
+
+namespace itk
+{
+template <typename TInputImage, typename TOutputImage>
+OMEZarrNGFFChunkedFilterDriver<TInputImage, TOutputImage>::OMEZarrNGFFChunkedFilterDriver()
+  : m_NumberOfWorkUnits(MultiThreaderBase::GetGlobalDefaultNumberOfThreads())
+{
+  m_ChunkSize.Fill(64);
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+OMEZarrNGFFChunkedFilterDriver<TInputImage, TOutputImage>::SetFilterFactory(const FilterFactoryType & filterFactory)
+{
+  this->SetTileFunction([filterFactory](const InputImageType * paddedTile, const RegionType & outputRegion) {
+    typename FilterType::Pointer filter = filterFactory();
+    filter->SetInput(paddedTile);
+    filter->GetOutput()->SetRequestedRegion(outputRegion);
+    filter->Update();
+    OutputImagePointer output = filter->GetOutput();
+    output->DisconnectPipeline();
+    return output;
+  });
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+OMEZarrNGFFImageIO::Pointer
+OMEZarrNGFFChunkedFilterDriver<TInputImage, TOutputImage>::MakeOutputImageIO(const OMEZarrNGFFImageIO * inputIO) const
+{
+  auto outputIO = OMEZarrNGFFImageIO::New();
+  outputIO->SetFileName(m_OutputFileName);
+  outputIO->SetNumberOfDimensions(ImageDimension);
+  for (unsigned d = 0; d < ImageDimension; ++d)
+  {
+    outputIO->SetDimensions(d, inputIO->GetDimensions(d));
+    outputIO->SetSpacing(d, inputIO->GetSpacing(d));
+    outputIO->SetOrigin(d, inputIO->GetOrigin(d));
+  }
+  outputIO->SetPixelTypeInfo(static_cast<const typename OutputImageType::PixelType *>(nullptr));
+  outputIO->SetChunkSize(std::vector<SizeValueType>(m_ChunkSize.begin(), m_ChunkSize.end()));
+  if (!m_Compressor.empty())
+  {
+    outputIO->SetCompressor(m_Compressor);
+  }
+  outputIO->SetWriteMode(OMEZarrNGFFImageIOEnums::WriteMode::Parallel);
+  return outputIO;
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+OMEZarrNGFFChunkedFilterDriver<TInputImage, TOutputImage>::ProcessTile(const OMEZarrNGFFImageIO * inputIO,
+                                                                       OMEZarrNGFFImageIO *       outputIO,
+                                                                       const RegionType &         tileRegion) const
+{
+  RegionType largestRegion;
+  for (unsigned d = 0; d < ImageDimension; ++d)
+  {
+    largestRegion.SetSize(d, inputIO->GetDimensions(d));
+  }
+  RegionType paddedRegion = tileRegion;
+  paddedRegion.PadByRadius(m_Halo);
+  paddedRegion.Crop(largestRegion);
+
+  typename InputImageType::SpacingType   spacing;
+  typename InputImageType::PointType     origin;
+  typename InputImageType::DirectionType direction;
+  for (unsigned d = 0; d < ImageDimension; ++d)
+  {
+    spacing[d] = inputIO->GetSpacing(d);
+    origin[d] = inputIO->GetOrigin(d);
+    for (unsigned k = 0; k < ImageDimension; ++k)
+    {
+      direction[k][d] = inputIO->GetDirection(d)[k];
+    }
+  }
+  auto paddedTile = InputImageType::New();
+  paddedTile->SetRegions(paddedRegion);
+  paddedTile->SetSpacing(spacing);
+  paddedTile->SetOrigin(origin);
+  paddedTile->SetDirection(direction);
+  paddedTile->Allocate();
+
+  ImageIORegion ioRegion(ImageDimension);
+  for (unsigned d = 0; d < ImageDimension; ++d)
+  {
+    ioRegion.SetIndex(d, paddedRegion.GetIndex(d));
+    ioRegion.SetSize(d, paddedRegion.GetSize(d));
+  }
+  inputIO->ReadRegion(ioRegion, m_TimeIndex, m_ChannelIndex, paddedTile->GetBufferPointer());
+
+  const OutputImagePointer output = m_TileFunction(paddedTile, tileRegion);
+  if (!output || !output->GetBufferedRegion().IsInside(tileRegion))
+  {
+    itkExceptionMacro(<< "The tile function did not produce the output tile " << tileRegion);
+  }
+
+  // Writes need the tile in a contiguous buffer
+  const typename OutputImageType::PixelType * buffer = output->GetBufferPointer();
+  auto                                        contiguousTile = OutputImageType::New();
+  if (output->GetBufferedRegion() != tileRegion)
+  {
+    contiguousTile->SetRegions(tileRegion);
+    contiguousTile->Allocate();
+    ImageAlgorithm::Copy(output.GetPointer(), contiguousTile.GetPointer(), tileRegion, tileRegion);
+    buffer = contiguousTile->GetBufferPointer();
+  }
+  for (unsigned d = 0; d < ImageDimension; ++d)
+  {
+    ioRegion.SetIndex(d, tileRegion.GetIndex(d));
+    ioRegion.SetSize(d, tileRegion.GetSize(d));
+  }
+  outputIO->SetIORegion(ioRegion);
+  outputIO->Write(buffer);
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+OMEZarrNGFFChunkedFilterDriver<TInputImage, TOutputImage>::Update()
+{
+  if (!m_TileFunction)
+  {
+    itkExceptionMacro(<< "A tile function or filter factory must be set");
+  }
+
+  auto inputIO = OMEZarrNGFFImageIO::New();
+  inputIO->SetFileName(m_InputFileName);
+  inputIO->ReadImageInformation();
+  // Tiles are read and written over the spatial axes, at the selected time point and channel
+  if (inputIO->GetNumberOfSpatialDimensions() != ImageDimension)
+  {
+    itkExceptionMacro(<< "The input image " << m_InputFileName << " has " << inputIO->GetNumberOfSpatialDimensions()
+                      << " spatial dimensions, but the input image type has " << ImageDimension);
+  }
+  if (inputIO->GetComponentType() != ImageIOBase::MapPixelType<typename InputImageType::PixelType>::CType)
+  {
+    itkExceptionMacro(<< "The component type " << ImageIOBase::GetComponentTypeAsString(inputIO->GetComponentType())
+                      << " of " << m_InputFileName << " does not match the pixel type of the input image type");
+  }
+
+  // The writers fill the output store created here, one chunk each
+  this->MakeOutputImageIO(inputIO)->CreateStore();
+
+  std::vector<RegionType> tiles;
+  RegionType              tile;
+  Index<ImageDimension>   gridIndex{};
+  for (;;)
+  {
+    for (unsigned d = 0; d < ImageDimension; ++d)
+    {
+      tile.SetIndex(d, gridIndex[d] * m_ChunkSize[d]);
+      tile.SetSize(d, std::min<SizeValueType>(m_ChunkSize[d], inputIO->GetDimensions(d) - tile.GetIndex(d)));
+    }
+    tiles.push_back(tile);
+    unsigned d = 0;
+    for (; d < ImageDimension; ++d)
+    {
+      if (static_cast<SizeValueType>(++gridIndex[d] * m_ChunkSize[d]) < inputIO->GetDimensions(d))
+      {
+        break;
+      }
+      gridIndex[d] = 0;
+    }
+    if (d == ImageDimension)
+    {
+      break;
+    }
+  }
+
+  // Each output IO is used by one tile at a time
+  std::mutex                               outputIOMutex;
+  std::vector<OMEZarrNGFFImageIO::Pointer> idleOutputIOs;
+  std::atomic<bool>                        failed{ false };
+  std::string                              errors;
+
+  auto multiThreader = MultiThreaderBase::New();
+  multiThreader->SetNumberOfWorkUnits(m_NumberOfWorkUnits);
+  multiThreader->ParallelizeArray(
+    0,
+    tiles.size(),
+    [&](const SizeValueType tileIndex) {
+      if (failed)
+      {
+        return; // skip the remaining tiles
+      }
+      OMEZarrNGFFImageIO::Pointer outputIO;
+      {
+        const std::lock_guard<std::mutex> lock(outputIOMutex);
+        if (!idleOutputIOs.empty())
+        {
+          outputIO = idleOutputIOs.back();
+          idleOutputIOs.pop_back();
+        }
+      }
+      try
+      {
+        if (!outputIO)
+        {
+          outputIO = this->MakeOutputImageIO(inputIO);
+        }
+        this->ProcessTile(inputIO, outputIO, tiles[tileIndex]);
+      }
+      catch (const std::exception & e)
+      {
+        failed = true;
+        const std::lock_guard<std::mutex> lock(outputIOMutex);
+        errors += "\n" + std::string(e.what());
+        return;
+      }
+      const std::lock_guard<std::mutex> lock(outputIOMutex);
+      idleOutputIOs.push_back(outputIO);
+    },
+    nullptr);
+
+  for (auto & outputIO : idleOutputIOs)
+  {
+    outputIO->FinalizeWrite();
+  }
+  if (failed)
+  {
+    itkExceptionMacro(<< "Processing tiles of " << m_InputFileName << " failed:" << errors);
+  }
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+void
+OMEZarrNGFFChunkedFilterDriver<TInputImage, TOutputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "InputFileName: " << m_InputFileName << std::endl;
+  os << indent << "OutputFileName: " << m_OutputFileName << std::endl;
+  os << indent << "TimeIndex: " << m_TimeIndex << std::endl;
+  os << indent << "ChannelIndex: " << m_ChannelIndex << std::endl;
+  os << indent << "Halo: " << m_Halo << std::endl;
+  os << indent << "ChunkSize: " << m_ChunkSize << std::endl;
+  os << indent << "Compressor: " << m_Compressor << std::endl;
+  os << indent << "NumberOfWorkUnits: " << m_NumberOfWorkUnits << std::endl;
+}
+} // end namespace itk
+
+#endif // itkOMEZarrNGFFChunkedFilterDriver_hxx
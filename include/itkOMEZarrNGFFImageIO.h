@@ -21,14 +21,20 @@
 #include "IOOMEZarrNGFFExport.h"
 
 
+#include <array>
 #include <fstream>
+#include <functional>
+#include <limits>
 #include <memory> // For unique_ptr.
 #include <string>
 #include <vector>
 #include "itkImageIOBase.h"
+#include "itkWeakPointer.h"
 
 namespace itk
 {
+class ProcessObject;
+
 /** \class OMEZarrNGFFAxis
  *
  * \brief Represent an OME-Zarr NGFF axis
@@ -45,6 +51,207 @@ struct IOOMEZarrNGFF_EXPORT OMEZarrNGFFAxis
   std::string unit;
 };
 
+/** \class OMEZarrNGFFReadStatistics
+ *
+ * \brief I/O statistics of reads from an OME-Zarr NGFF store
+ *
+ * The statistics are measured by each read for its own chunks, so reads which run concurrently
+ * do not count each other's. Chunks which are decoded block-wise (see PartialChunkDecoding) are fetched
+ * and decoded by the IO, so their bytes, fetch latency, decoding and copying are measured separately.
+ * Tensorstore fetches, decodes and copies the other chunks in a single step, which is only included
+ * in readSeconds. fetchSeconds sums the latencies of the individual chunk fetches,
+ * which overlap as chunks are fetched concurrently.
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+struct IOOMEZarrNGFF_EXPORT OMEZarrNGFFReadStatistics
+{
+  uint64_t bytesFetched = 0;           // encoded bytes of the chunks decoded block-wise
+  uint64_t chunksRequested = 0;        // chunks intersecting the requested region
+  uint64_t cacheHits = 0;              // chunks of sequential reads already in the cache when requested
+  uint64_t cacheMisses = 0;            // chunks of sequential reads not read yet, or still being read ahead
+  uint64_t readAheadHits = 0;          // sequential reads whose chunks had all been read ahead
+  uint64_t readAheadMisses = 0;        // sequential reads which had to wait for some of their chunks
+  uint64_t chunksReadAhead = 0;        // chunks requested in the background for the next reads
+  uint64_t chunksDecodedBlockwise = 0; // chunks fetched and decoded by the IO
+  double   openSeconds = 0.0;          // reading metadata and opening the array
+  double   fetchSeconds = 0.0;         // summed fetch latency of the chunks decoded block-wise
+  double   decodeSeconds = 0.0;        // decoding their blosc blocks
+  double   copySeconds = 0.0;          // copying their decoded pixels into the buffer
+  double   readSeconds = 0.0;          // the whole read
+
+  OMEZarrNGFFReadStatistics &
+  operator+=(const OMEZarrNGFFReadStatistics & other);
+};
+extern IOOMEZarrNGFF_EXPORT std::ostream &
+                            operator<<(std::ostream & out, const OMEZarrNGFFReadStatistics & statistics);
+
+/** \class OMEZarrNGFFChannelStatistics
+ *
+ * \brief Intensity statistics of one channel of an OME-Zarr NGFF image
+ *
+ * Stored in .zattrs as the display window of the channel in the "omero" block,
+ * and in full in the "itk_channel_statistics" block. Stores written by other
+ * software may only have the window, in which case the count is zero.
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+struct IOOMEZarrNGFF_EXPORT OMEZarrNGFFChannelStatistics
+{
+  double                minimum = 0.0;
+  double                maximum = 0.0;
+  double                mean = 0.0;
+  uint64_t              count = 0;         // number of pixels
+  double                windowStart = 0.0; // display window, the 0.1 and 99.9 percentiles
+  double                windowEnd = 0.0;
+  double                histogramMinimum = 0.0;
+  double                histogramMaximum = 0.0;
+  std::vector<uint64_t> histogram; // bins of equal width over [histogramMinimum, histogramMaximum]
+};
+
+/** \class OMEZarrNGFFRegionStatistics
+ *
+ * \brief Reduction of the pixels of a region of an OME-Zarr NGFF dataset
+ *
+ * Produced by OMEZarrNGFFImageIO::ComputeRegionStatistics. NaN pixels are not counted.
+ * The histogram, when requested, has bins of equal width over
+ * [histogramMinimum, histogramMaximum], and pixels outside of this range
+ * are counted in the first or last bin.
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+struct IOOMEZarrNGFF_EXPORT OMEZarrNGFFRegionStatistics
+{
+  uint64_t              count = 0;
+  double                minimum = std::numeric_limits<double>::infinity();
+  double                maximum = -std::numeric_limits<double>::infinity();
+  double                sum = 0.0;
+  double                sumOfSquares = 0.0;
+  double                histogramMinimum = 0.0;
+  double                histogramMaximum = 0.0;
+  std::vector<uint64_t> histogram;
+
+  double
+  GetMean() const;
+  double
+  GetVariance() const; // of the population
+  double
+  GetStandardDeviation() const;
+
+  /** Merges the statistics of another part of the region, with the same histogram bins. */
+  OMEZarrNGFFRegionStatistics &
+  operator+=(const OMEZarrNGFFRegionStatistics & other);
+};
+extern IOOMEZarrNGFF_EXPORT std::ostream &
+                            operator<<(std::ostream & out, const OMEZarrNGFFRegionStatistics & statistics);
+
+/** \class OMEZarrNGFFDatasetGeometry
+ *
+ * \brief Size and physical placement of one dataset (resolution level) of an OME-Zarr NGFF image
+ *
+ * All members are in ITK axis order over all axes of the image.
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+struct IOOMEZarrNGFF_EXPORT OMEZarrNGFFDatasetGeometry
+{
+  std::string                path; // of the array, relative to the image
+  std::vector<SizeValueType> size;
+  std::vector<double>        spacing;
+  std::vector<double>        origin;
+  std::vector<SizeValueType> chunkSize; // of the array
+};
+
+/** \class OMEZarrNGFFLevelRegion
+ *
+ * \brief Pixels of a physical box read from one dataset by OMEZarrNGFFImageIO::ReadPhysicalRegionAtDatasets
+ *
+ * The geometry spans the spatial axes, with the origin at the first pixel of the buffer.
+ * The pixels are of the component type of the image, with the first axis the fastest moving.
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+struct IOOMEZarrNGFF_EXPORT OMEZarrNGFFLevelRegion
+{
+  unsigned                   datasetIndex = 0;
+  OMEZarrNGFFDatasetGeometry geometry;
+  std::vector<char>          buffer;
+};
+
+/** \class OMEZarrNGFFField
+ *
+ * \brief A field of view of a high-content screening plate or well, found by OMEZarrNGFFImageIO
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+struct IOOMEZarrNGFF_EXPORT OMEZarrNGFFField
+{
+  std::string path;             // of the image, relative to the plate or well, e.g. "A/1/0"
+  std::string row;              // name of the row of the well in the plate, e.g. "A", empty when reading a well
+  std::string column;           // name of the column, e.g. "1"
+  int         acquisition = -1; // of the plate, when given
+};
+
+/** \class OMEZarrNGFFReslicePlane
+ *
+ * \brief A plane of pixels in physical space, resampled by OMEZarrNGFFImageIO::ReadObliqueSlice
+ *
+ * Output pixel (i, j) is at origin + i * spacing[0] * uDirection + j * spacing[1] * vDirection,
+ * where the directions are unit vectors along x, y, z.
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+struct IOOMEZarrNGFF_EXPORT OMEZarrNGFFReslicePlane
+{
+  std::array<double, 3>        origin{ { 0.0, 0.0, 0.0 } };
+  std::array<double, 3>        uDirection{ { 1.0, 0.0, 0.0 } };
+  std::array<double, 3>        vDirection{ { 0.0, 1.0, 0.0 } };
+  std::array<SizeValueType, 2> size{ { 0, 0 } };
+  std::array<double, 2>        spacing{ { 1.0, 1.0 } };
+};
+
+/** \class OMEZarrNGFFImageIOEnums
+ *
+ * \brief Enums used by OMEZarrNGFFImageIO
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+class OMEZarrNGFFImageIOEnums
+{
+public:
+  /** \class WriteMode
+   * \ingroup IOOMEZarrNGFF
+   * How Write treats the store at the output file name.
+   * Overwrite: delete any existing store and create a new one with the shape of the image.
+   * Update: write the image into an existing store at the selected time point and channel,
+   * growing the time axis when needed. Only the affected chunks are written.
+   * Parallel: like Update, for one of several writers (typically processes) which write disjoint
+   * regions into a store made by CreateStore. The store is not resized, and the IORegion must be
+   * aligned to the chunk grid, so that no two writers modify the same chunk. */
+  enum class WriteMode : uint8_t
+  {
+    Overwrite,
+    Update,
+    Parallel
+  };
+
+  /** \class Projection
+   * \ingroup IOOMEZarrNGFF
+   * How ComputeProjection combines the pixels along the projected axis. */
+  enum class Projection : uint8_t
+  {
+    Maximum,
+    Minimum,
+    Mean,
+    Sum
+  };
+};
+// Define how to print enumeration
+extern IOOMEZarrNGFF_EXPORT std::ostream &
+                            operator<<(std::ostream & out, const OMEZarrNGFFImageIOEnums::WriteMode value);
+extern IOOMEZarrNGFF_EXPORT std::ostream &
+                            operator<<(std::ostream & out, const OMEZarrNGFFImageIOEnums::Projection value);
+
 /** \class OMEZarrNGFFImageIO
  *
  * \brief Read and write OMEZarrNGFF images.
@@ -75,6 +282,8 @@ public:
   static constexpr unsigned MaximumDimension = 5; // OME-NGFF specifies up to 5D data
   static constexpr int      INVALID_INDEX = -1;   // for specifying enumerated axis slice indices
   using AxesCollectionType = std::vector<OMEZarrNGFFAxis>;
+  using WriteModeEnum = OMEZarrNGFFImageIOEnums::WriteMode;
+  using ProjectionEnum = OMEZarrNGFFImageIOEnums::Projection;
 
   /** The different types of ImageIO's can support data of varying
    * dimensionality. For example, some file formats are strictly 2D
@@ -140,6 +349,351 @@ public:
   void
   Write(const void * buffer) override;
 
+  /** Chunk size of newly written arrays, in ITK axis order. Axes beyond the
+   * given sizes use chunks of size 1. Empty by default, letting tensorstore choose.
+   *
+   * The compressor is selected with SetCompressor: "blosc" (the default),
+   * "zstd", "zlib", "gzip", "bz2", or "none". CompressionLevel is used, clamped
+   * to the range of the codec, once a compressor has been selected explicitly. */
+  void
+  SetChunkSize(const std::vector<SizeValueType> & chunkSize)
+  {
+    if (m_ChunkSize != chunkSize)
+    {
+      m_ChunkSize = chunkSize;
+      this->Modified();
+    }
+  }
+  const std::vector<SizeValueType> &
+  GetChunkSize() const
+  {
+    return m_ChunkSize;
+  }
+
+  /** Should Write return as soon as the buffer has been copied?
+   * Compression and storage then continue in the background,
+   * overlapping with the computation of the next stream division or time point.
+   * Zip archives are always written synchronously. Off by default. */
+  itkGetConstMacro(AsynchronousWrite, bool);
+  itkSetMacro(AsynchronousWrite, bool);
+  itkBooleanMacro(AsynchronousWrite);
+
+  /** How Write treats an existing store. In Update mode the image is written
+   * into the existing store at TimeIndex and ChannelIndex, which must be set if the
+   * store has the corresponding axis. The time axis grows to accommodate new time points.
+   * Overwrite by default. */
+  itkGetConstMacro(WriteMode, WriteModeEnum);
+  itkSetMacro(WriteMode, WriteModeEnum);
+
+  /** Create the store at FileName from the image information of this IO (dimensions, spacing,
+   * origin, component type, chunk size and compressor), replacing any existing store.
+   * The group and array metadata are written, but no chunks. Several writers, each with its
+   * own IO object and possibly in its own process, can then fill the store using WriteMode
+   * Parallel, each writing a chunk-aligned region. Without a ChunkSize, the chunks along the
+   * channel and time axes hold one channel and time point, like the single channel and time
+   * point of each parallel write. Not supported for zip archives. */
+  void
+  CreateStore();
+
+  /** Should Write compute the minimum, maximum, mean and a 256 bin histogram of each channel,
+   * and store them in .zattrs? The pixels are scanned while the chunks are being encoded.
+   * With streamed writes, .zattrs is written after the last stream division, and histogram
+   * bins are merged approximately when a division widens the range of the earlier ones.
+   * Writes in Update and Parallel mode do not change the statistics. Off by default. */
+  itkGetConstMacro(ComputeChannelStatistics, bool);
+  itkSetMacro(ComputeChannelStatistics, bool);
+  itkBooleanMacro(ComputeChannelStatistics);
+
+  /** Statistics of each channel, read by ReadImageInformation without reading any pixels,
+   * or computed by the most recent Write. Empty if the store has none. */
+  const std::vector<OMEZarrNGFFChannelStatistics> &
+  GetChannelStatistics() const
+  {
+    return m_ChannelStatistics;
+  }
+
+  /** Reads and writes proceed chunk by chunk. As chunks complete, UpdateProgress is
+   * called with the fraction of chunks done, invoking ProgressEvent on this IO
+   * (from the thread which called Read or Write). Setting AbortGenerateData,
+   * e.g. from an observer or another thread, cancels the remaining chunks:
+   * the chunks in flight are completed, and ProcessAborted is thrown.
+   * AbortGenerateData is cleared at the start of each Read and Write.
+   *
+   * The progress source, typically the reader or writer using this IO, also receives
+   * UpdateProgress calls, and its AbortGenerateData cancels as well. It is held by a WeakPointer,
+   * as it typically holds this IO, and it is reset to nullptr when it is deleted before this IO. */
+  void
+  SetProgressSource(ProcessObject * source);
+  ProcessObject *
+  GetProgressSource() const
+  {
+    return m_ProgressSource.GetPointer();
+  }
+
+  /** Record a timeline of metadata reads, chunk reads and writes, and zip entry copies
+   * in the Chrome trace event format, for viewing in chrome://tracing or Perfetto.
+   * Chunks decoded block-wise (see PartialChunkDecoding) are fetched and decoded by the IO,
+   * and traced as separate fetch, decode and copy spans. Tensorstore fetches, decodes and copies
+   * the other chunks in one step, whose stages it does not expose, so their spans last from the request
+   * until the chunk has been copied. IO objects tracing into the same file share it. The file is written
+   * as events accumulate and completed when the last of these IO objects is destroyed. Throws if the file
+   * cannot be opened. Empty (no tracing) by default, unless the ITK_OMEZARRNGFF_TRACE environment variable
+   * names a file, in which case a file which cannot be opened disables tracing with a warning. */
+  void
+  SetTraceFileName(const std::string & traceFileName);
+  itkGetStringMacro(TraceFileName);
+
+  /** Statistics of the most recent Read. The time spent in ReadImageInformation
+   * is attributed to the first Read which follows it. The statistics are also
+   * stored in the MetaDataDictionary, under keys starting with "OMEZarrNGFFLastRead". */
+  itkGetConstReferenceMacro(LastReadStatistics, OMEZarrNGFFReadStatistics);
+
+  /** Statistics accumulated over all reads by this IO object. */
+  itkGetConstReferenceMacro(CumulativeReadStatistics, OMEZarrNGFFReadStatistics);
+
+  /** Read-ahead of sequential reads. When consecutive Read calls step through the image
+   * along one axis, as when reading it slice by slice along z or t, the next ReadAheadDepth
+   * layers of chunks along that axis are read in the background into a chunk cache,
+   * so the following reads find their chunks decoded in memory. The cache holds at most
+   * ReadAheadCacheSize bytes, which also limits the number of layers read ahead.
+   * Both take effect at the next ReadImageInformation. ReadAheadDepth is 0 by default,
+   * which disables read-ahead. The cache is only used with read-ahead or in follow mode.
+   * The hits and misses are counted in the read statistics. */
+  itkSetMacro(ReadAheadDepth, unsigned);
+  itkGetConstMacro(ReadAheadDepth, unsigned);
+  itkSetMacro(ReadAheadCacheSize, SizeValueType);
+  itkGetConstMacro(ReadAheadCacheSize, SizeValueType);
+
+  /** Should Read, ReadRegion and ReadDatasetRegion decode only the blosc blocks of each chunk which overlap
+   * the region? Blosc divides a chunk into blocks which are compressed independently, so reading
+   * a small region of large chunks then decodes a small part of them. This applies to regions which cover
+   * part of some chunk, of arrays compressed with blosc, without filters, in C order and in the byte order
+   * of this machine. The chunks which the region covers entirely are still read through tensorstore.
+   * Other regions and arrays, and all arrays when read-ahead or follow mode is enabled, are read through
+   * the chunk cache. On by default. */
+  itkSetMacro(PartialChunkDecoding, bool);
+  itkGetConstMacro(PartialChunkDecoding, bool);
+  itkBooleanMacro(PartialChunkDecoding);
+
+  /** Number of chunks which the reads of this IO object decoded from their blosc frames,
+   * as described for PartialChunkDecoding, rather than through tensorstore. Reset by ResetReadStatistics. */
+  SizeValueType
+  GetNumberOfChunksDecodedBlockwise() const;
+
+  /** Follow mode, for stores which grow while they are read, such as the store of a running acquisition.
+   * Read rechecks the array metadata and the cached chunks as Refresh does when the last check
+   * is older than FollowInterval seconds, so the dimensions follow the store. The chunks which did not change
+   * are reused from a chunk cache of ReadAheadCacheSize bytes, so following the store costs only the new data.
+   * Takes effect at the next ReadImageInformation. Off by default, when the metadata and chunks
+   * which were read once are assumed not to change. */
+  itkSetMacro(Follow, bool);
+  itkGetConstMacro(Follow, bool);
+  itkBooleanMacro(Follow);
+
+  /** Seconds between the rechecks of Read in follow mode. 1 by default. */
+  itkSetMacro(FollowInterval, double);
+  itkGetConstMacro(FollowInterval, double);
+
+  /** Rechecks the .zarray of the opened dataset and updates the dimensions when the store grew or shrank.
+   * Chunks cached before the recheck are revalidated when they are next read, and reread if they changed.
+   * The other metadata of the image is not reread. This may be called whether or not follow mode is on,
+   * but not concurrently with other methods. Returns whether the dimensions changed. */
+  bool
+  Refresh();
+
+  /** Reset both last and cumulative read statistics. */
+  void
+  ResetReadStatistics();
+
+  /** Block until all asynchronous writes have been stored.
+   * Throws if any of them failed. */
+  void
+  WaitForPendingWrites();
+
+  /** Number of the chunk writes issued asynchronously which have not been waited for yet.
+   * Each asynchronous Write adds the number of chunks it stores. */
+  SizeValueType
+  GetNumberOfPendingWrites() const;
+
+  /** Block until the `numberOfWrites` oldest pending chunk writes have been stored,
+   * leaving the later ones in flight. Throws if any of them failed. */
+  void
+  WaitForOldestPendingWrites(SizeValueType numberOfWrites);
+
+  /** Complete the current write: wait for pending writes, and close the zip archive
+   * being written, if any. A zip archive is closed automatically by the Write of the
+   * stream division which contains the last pixel of the image. Call this after
+   * writing a subset of the divisions. Also invoked on destruction. */
+  void
+  FinalizeWrite();
+
+  /** Read `region` of the dataset opened by ReadImageInformation, at the given time point
+   * and channel, into `buffer`. Like the IORegion of Read, the region is given in ITK axis order
+   * over the spatial axes (x, y, z). The indices are ignored for axes the dataset does not have.
+   *
+   * This does not modify the IO object, so it may be called concurrently from multiple threads,
+   * sharing the opened store and its cache. It must not run concurrently with calls which
+   * do modify the IO object, such as ReadImageInformation, Read, Write and the setters.
+   * No progress events or read statistics are produced. */
+  void
+  ReadRegion(const ImageIORegion & region, int timeIndex, int channelIndex, void * buffer) const;
+
+  /** Number of datasets (resolution levels) of the image opened by ReadImageInformation,
+   * from the finest to the coarsest. */
+  unsigned
+  GetNumberOfDatasets() const;
+
+  /** Size, spacing and origin of a dataset of the opened image. The geometry of all datasets
+   * is parsed by ReadImageInformation, and the array of a dataset other than DatasetIndex
+   * is opened on first use and kept open. Like ReadRegion, this may be called concurrently. */
+  OMEZarrNGFFDatasetGeometry
+  GetDatasetGeometry(unsigned datasetIndex) const;
+
+  /** Like ReadRegion, from another dataset of the opened image. */
+  void
+  ReadDatasetRegion(unsigned              datasetIndex,
+                    const ImageIORegion & region,
+                    int                   timeIndex,
+                    int                   channelIndex,
+                    void *                buffer) const;
+
+  /** Number of spatial axes (x, y, z) of the opened image. They are the first axes in ITK order. */
+  unsigned
+  GetNumberOfSpatialDimensions() const;
+
+  /** The coarsest dataset whose spacing along each spatial axis does not exceed `targetSpacing`
+   * (one entry per spatial axis, in ITK order), or the finest dataset if none does. */
+  unsigned
+  SelectDataset(const std::vector<double> & targetSpacing) const;
+
+  /** The smallest region of dataset `datasetIndex` over the spatial axes which contains
+   * the pixels containing the physical box [lower, upper], cropped to the dataset.
+   * The corners have one entry per spatial axis, in ITK order. Throws if the box is outside of the dataset. */
+  ImageIORegion
+  ComputePhysicalRegion(unsigned                    datasetIndex,
+                        const std::vector<double> & lower,
+                        const std::vector<double> & upper) const;
+
+  /** Reads the region computed by ComputePhysicalRegion into `buffer`, which must be large
+   * enough for it, and returns the geometry of the buffer over the spatial axes:
+   * its size, and the spacing and origin (position of the first pixel) of the dataset.
+   * Like ReadRegion, this may be called concurrently. */
+  OMEZarrNGFFDatasetGeometry
+  ReadPhysicalRegion(unsigned                    datasetIndex,
+                     const std::vector<double> & lower,
+                     const std::vector<double> & upper,
+                     int                         timeIndex,
+                     int                         channelIndex,
+                     void *                      buffer) const;
+
+  /** Reads the physical box [lower, upper] from each of the datasets `datasetIndices` at once,
+   * as ReadPhysicalRegion would. The reads of all datasets are started before any is awaited,
+   * so they run concurrently on the threads of tensorstore.
+   * Returns one buffer per dataset, in the order of `datasetIndices`.
+   * Like ReadRegion, this may be called concurrently. */
+  std::vector<OMEZarrNGFFLevelRegion>
+  ReadPhysicalRegionAtDatasets(const std::vector<unsigned> & datasetIndices,
+                               const std::vector<double> &   lower,
+                               const std::vector<double> &   upper,
+                               int                           timeIndex,
+                               int                           channelIndex) const;
+
+  /** Called by ReadProgressive as each dataset has been read, with the index of the dataset,
+   * and the geometry and pixels of the box read from it. The pixels are only valid during the call.
+   * Returning false cancels the reads of the finer datasets. */
+  using ProgressiveReadCallback =
+    std::function<bool(unsigned datasetIndex, const OMEZarrNGFFDatasetGeometry & geometry, const void * buffer)>;
+
+  /** Reads the physical box [lower, upper] from the datasets from the coarsest to `finestDatasetIndex`,
+   * calling `callback` as each of them completes, so a coarse view can be shown long before
+   * the fine one arrives. The metadata parsed by ReadImageInformation is shared by all datasets.
+   * Like ReadRegion, this may be called concurrently. Returns the number of datasets read. */
+  unsigned
+  ReadProgressive(const std::vector<double> &     lower,
+                  const std::vector<double> &     upper,
+                  int                             timeIndex,
+                  int                             channelIndex,
+                  const ProgressiveReadCallback & callback,
+                  unsigned                        finestDatasetIndex = 0) const;
+
+  /** Fields of view found by ReadImageInformation when the file is a high-content screening plate or well,
+   * in the order of the wells of the plate and of the images of each well. Empty for a single image.
+   * The metadata of the wells are read concurrently, and the image of field FieldIndex is the one opened. */
+  const std::vector<OMEZarrNGFFField> &
+  GetFields() const
+  {
+    return m_Fields;
+  }
+
+  /** Reads the same region, time point and channel of dataset `datasetIndex` from each of the fields
+   * `fieldIndices`, as ReadDatasetRegion reads it from the opened image. All fields are assumed
+   * to have the axes, datasets and component type of the opened image, so only their arrays are opened.
+   * The arrays are opened on first use and kept open, sharing the context and chunk cache of the IO,
+   * and the opens and reads of all fields run concurrently.
+   * Returns one buffer per field, in the order of `fieldIndices`. Like ReadRegion, this may be called concurrently. */
+  std::vector<std::vector<char>>
+  ReadFieldsRegion(const std::vector<unsigned> & fieldIndices,
+                   unsigned                      datasetIndex,
+                   const ImageIORegion &         region,
+                   int                           timeIndex,
+                   int                           channelIndex) const;
+
+  /** Resamples the opened image on an oblique plane with trilinear interpolation, into `buffer`
+   * of plane.size[0] * plane.size[1] floats, with the first plane axis the fastest moving.
+   * Pixels outside of the image are 0. The dataset is `datasetIndex`, or when it is negative,
+   * the coarsest dataset whose spacing along x, y and z does not exceed the smaller plane spacing.
+   * Only the pixels needed for the interpolation are read, as the box bounding them in each chunk,
+   * concurrently and as floats.
+   * Requires x, y and z axes. Like ReadRegion, this may be called concurrently.
+   * Returns the index of the dataset which was resampled. */
+  unsigned
+  ReadObliqueSlice(const OMEZarrNGFFReslicePlane & plane,
+                   int                             timeIndex,
+                   int                             channelIndex,
+                   float *                         buffer,
+                   int                             datasetIndex = -1) const;
+
+  /** Computes the minimum, maximum, sum, sum of squares and optionally a histogram of the pixels
+   * in `region` of the dataset opened by ReadImageInformation, without reading the region into memory.
+   * Unlike ReadRegion, the region spans all axes of the dataset in ITK axis order,
+   * including the channel and time axes, so a whole 4D or 5D dataset can be reduced at once.
+   *
+   * The chunks intersecting the region are read and reduced by `numberOfThreads` work units of
+   * a MultiThreaderBase (by default the global default number of threads), each holding one chunk at a time,
+   * and their partial results are merged. A histogram with `numberOfHistogramBins` bins
+   * over [histogramMinimum, histogramMaximum] is computed when the number of bins is not zero.
+   * Like ReadRegion, this may be called concurrently with other const methods. */
+  OMEZarrNGFFRegionStatistics
+  ComputeRegionStatistics(const ImageIORegion & region,
+                          unsigned              numberOfHistogramBins = 0,
+                          double                histogramMinimum = 0.0,
+                          double                histogramMaximum = 0.0,
+                          unsigned              numberOfThreads = 0) const;
+
+  /** Projects `region` of the dataset opened by ReadImageInformation along the axis named `axisName`
+   * ("x", "y", "z", "c" or "t"), e.g. for a maximum-intensity projection along z. As for
+   * ComputeRegionStatistics, the region spans all axes of the dataset in ITK axis order.
+   * `buffer` receives the region with the projected axis collapsed to size 1, in ITK axis order.
+   * For Maximum and Minimum, it holds pixels of the component type of the dataset,
+   * and for Sum and Mean, it holds doubles. NaN pixels are ignored, so Mean divides by the number
+   * of the other pixels projected onto each output pixel, and is NaN where there are none.
+   *
+   * The chunks are read by `numberOfThreads` work units of a MultiThreaderBase (by default the global
+   * default number of threads). Each work unit projects a column of chunks along the axis into its own
+   * part of the result, holding one chunk and one projected chunk at a time, so memory use follows
+   * the size of the result.
+   * Like ReadRegion, this may be called concurrently with other const methods. */
+  void
+  ComputeProjection(const ImageIORegion & region,
+                    const std::string &   axisName,
+                    ProjectionEnum        projection,
+                    void *                buffer,
+                    unsigned              numberOfThreads = 0) const;
+
+  /** Chunk size of the dataset opened by ReadImageInformation, in ITK axis order. */
+  std::vector<SizeValueType>
+  GetStoreChunkSize() const;
+
   /** Method for supporting streaming.  Given a requested region, determine what
    * could be the region that we can read from the file. This is called the
    * streamable region, which will be smaller than the LargestPossibleRegion and
@@ -155,6 +709,10 @@ public:
   itkGetConstMacro(DatasetIndex, int);
   itkSetMacro(DatasetIndex, int);
 
+  /** When reading a high-content screening plate or well, which field of view should be read? */
+  itkGetConstMacro(FieldIndex, unsigned);
+  itkSetMacro(FieldIndex, unsigned);
+
   /** If there is a time axis, at what index should it be sliced? */
   itkGetConstMacro(TimeIndex, int);
   itkSetMacro(TimeIndex, int);
@@ -188,14 +746,70 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  void
+  InternalSetCompressor(const std::string & _compressor) override;
+
+  /** Called by the DeleteEvent of the progress source. */
+  void
+  ForgetProgressSource()
+  {
+    m_ProgressSource = nullptr;
+  }
+
+  /** Detect whether a Read of `storeIORegion` continues a sequential access along one axis,
+   * count it as a read-ahead hit or miss, and request the next chunk layers in the background. */
+  void
+  ReadAhead(const ImageIORegion & storeIORegion, OMEZarrNGFFReadStatistics & statistics);
+
+  /** Store the statistics of a completed read, and mirror them into the MetaDataDictionary. */
+  void
+  UpdateReadStatistics(const OMEZarrNGFFReadStatistics & statistics);
+
   /** Read a single array and set relevant metadata. */
   void
   ReadArrayMetadata(std::string path, std::string driver);
 
-  /** Process requested store region for given configuration */
+  /** Open the existing array at DatasetIndex for writing and parse its axes. */
+  void
+  OpenStoreForUpdate();
+
+  /** Write .zattrs, including the channel statistics when they have been computed. */
+  void
+  WriteGroupAttributes();
+
+  /** Add the pixels of a stream division to the channel statistics, scanning its channels as work units
+   * of a MultiThreaderBase. */
+  void
+  AccumulateChannelStatistics(const void * buffer, const ImageIORegion & ioRegion);
+
+  /** Write into the existing store at the configured time point and channel. */
+  void
+  WriteIntoExistingStore(const void * buffer);
+
+  /** Start streaming a new zip archive to disk. */
+  void
+  BeginZipArchive();
+
+  /** Append a chunk (given by its grid index, in store order) which has just been written
+   * to the zip archive, if it lies entirely within the written store region. Otherwise another
+   * stream division may still modify it, and it stays staged until the archive is closed. */
+  void
+  AppendWrittenChunkToZipArchive(const ImageIORegion & storeIORegion, const std::vector<IndexValueType> & chunkIndex);
+
+  /** Move the staged entries (paths relative to the archive root) into the zip archive. */
+  void
+  AppendStagedEntriesToZipArchive(const std::vector<std::string> & keys);
+
+  /** Process requested store region for given configuration, warning when a time point or channel
+   * of the store is not specified */
   ImageIORegion
   ConfigureTensorstoreIORegion(const ImageIORegion & ioRegion) const;
 
+  /** Process requested store region at the given time point and channel, the first one when not specified.
+   * It does not warn, as it may be called concurrently. */
+  ImageIORegion
+  ConfigureTensorstoreIORegion(const ImageIORegion & ioRegion, int timeIndex, int channelIndex) const;
+
   /** Helper method to get axes in tensorstore C-style order*/
   AxesCollectionType
   GetAxesInStoreOrder() const
@@ -237,8 +851,29 @@ protected:
 
 private:
   int                m_DatasetIndex = 0; // first, highest resolution scale by default
+  unsigned           m_FieldIndex = 0;
   int                m_TimeIndex = INVALID_INDEX;
   int                m_ChannelIndex = INVALID_INDEX;
+  bool               m_AsynchronousWrite = false;
+  WriteModeEnum      m_WriteMode = WriteModeEnum::Overwrite;
+  bool               m_ComputeChannelStatistics = false;
+  unsigned           m_ReadAheadDepth = 0;
+  SizeValueType      m_ReadAheadCacheSize = 256 * 1024 * 1024;
+  bool               m_PartialChunkDecoding = true;
+  bool               m_Follow = false;
+  double             m_FollowInterval = 1.0;
+
+  std::vector<SizeValueType> m_ChunkSize;
+  OMEZarrNGFFReadStatistics  m_LastReadStatistics;
+  OMEZarrNGFFReadStatistics  m_CumulativeReadStatistics;
+  double                     m_PendingOpenSeconds = 0.0; // of ReadImageInformation, until the next Read
+  WeakPointer<ProcessObject> m_ProgressSource;
+  unsigned long              m_ProgressSourceDeleteTag = 0;
+  std::string                m_TraceFileName;
+
+  std::vector<OMEZarrNGFFChannelStatistics> m_ChannelStatistics;
+  std::vector<OMEZarrNGFFField>             m_Fields;
+
   AxesCollectionType m_StoreAxes;
 
   // An empty zip file consists of 22 bytes of "end of central directory" record. More:
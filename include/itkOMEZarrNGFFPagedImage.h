@@ -0,0 +1,192 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkOMEZarrNGFFPagedImage_h
+#define itkOMEZarrNGFFPagedImage_h
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "itkImageRegion.h"
+#include "itkMatrix.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkPoint.h"
+#include "itkVector.h"
+
+namespace itk
+{
+/** \class OMEZarrNGFFPagedImage
+ *
+ * \brief Random pixel access to an OME-Zarr image much larger than memory.
+ *
+ * The image is divided into pages, one per chunk of the store. A page is read
+ * on the first access to one of its pixels, and kept in a least recently used cache
+ * holding at most MaximumNumberOfPages pages, so memory use follows the working set
+ * rather than the size of the image. When the image is writable, SetPixel marks
+ * the page dirty, and dirty pages are written back when evicted, on Flush and on
+ * destruction. Pages are aligned to the chunks, so writing one back rewrites whole chunks.
+ *
+ * Unlike itk::Image, the pixels are not in one contiguous buffer, so image iterators
+ * and filters cannot be used. Access is thread-safe, with page faults serialized.
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+template <typename TPixel, unsigned int VImageDimension = 3>
+class ITK_TEMPLATE_EXPORT OMEZarrNGFFPagedImage : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(OMEZarrNGFFPagedImage);
+
+  /** Standard class typedefs. */
+  using Self = OMEZarrNGFFPagedImage;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(OMEZarrNGFFPagedImage, Object);
+
+  static constexpr unsigned ImageDimension = VImageDimension;
+  static_assert(ImageDimension <= 3, "Pages span the spatial axes only");
+
+  using PixelType = TPixel;
+  using RegionType = ImageRegion<ImageDimension>;
+  using IndexType = typename RegionType::IndexType;
+  using SizeType = typename RegionType::SizeType;
+  using SpacingType = Vector<SpacePrecisionType, ImageDimension>;
+  using PointType = Point<SpacePrecisionType, ImageDimension>;
+  using DirectionType = Matrix<SpacePrecisionType, ImageDimension, ImageDimension>;
+
+  /** Time point and channel of the dataset, when it has these axes. 0 by default. */
+  itkSetMacro(TimeIndex, int);
+  itkGetConstMacro(TimeIndex, int);
+  itkSetMacro(ChannelIndex, int);
+  itkGetConstMacro(ChannelIndex, int);
+
+  /** Should SetPixel be allowed, writing modified pages back to the store? Off by default. */
+  itkSetMacro(Writable, bool);
+  itkGetConstMacro(Writable, bool);
+  itkBooleanMacro(Writable);
+
+  /** Maximum number of pages kept in memory. 64 by default. */
+  void
+  SetMaximumNumberOfPages(SizeValueType maximumNumberOfPages);
+  itkGetConstMacro(MaximumNumberOfPages, SizeValueType);
+
+  /** Open the store. Pages of an earlier store are flushed and released. */
+  void
+  Open(const std::string & fileName);
+
+  /** Geometry of the opened image. */
+  itkGetConstReferenceMacro(LargestPossibleRegion, RegionType);
+  itkGetConstReferenceMacro(Spacing, SpacingType);
+  itkGetConstReferenceMacro(Origin, PointType);
+  itkGetConstReferenceMacro(Direction, DirectionType);
+
+  /** Size of the pages, which is the chunk size of the store. */
+  itkGetConstReferenceMacro(PageSize, SizeType);
+
+  /** Pixel access. The index must be inside the largest possible region. */
+  PixelType
+  GetPixel(const IndexType & index);
+  void
+  SetPixel(const IndexType & index, const PixelType & value);
+
+  /** Write all dirty pages back to the store, keeping them cached. */
+  void
+  Flush();
+
+  /** Number of pixel accesses which found their page in memory, and which had to read it. */
+  SizeValueType
+  GetNumberOfPageHits() const;
+  SizeValueType
+  GetNumberOfPageFaults() const;
+
+  /** Number of pages currently in memory. */
+  SizeValueType
+  GetNumberOfResidentPages() const;
+
+protected:
+  OMEZarrNGFFPagedImage() = default;
+  ~OMEZarrNGFFPagedImage() override;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  struct Page
+  {
+    SizeValueType       key;
+    RegionType          region;
+    std::vector<TPixel> pixels;
+    bool                dirty = false;
+
+    SizeValueType
+    Offset(const IndexType & index) const
+    {
+      SizeValueType offset = 0;
+      for (unsigned d = ImageDimension; d > 0; --d)
+      {
+        offset = offset * region.GetSize(d - 1) + (index[d - 1] - region.GetIndex(d - 1));
+      }
+      return offset;
+    }
+  };
+  using PageList = std::list<Page>;
+
+  /** The page holding the pixel at `index`, moved to the front of the LRU list.
+   * Reads it, evicting the least recently used page if needed. Must hold m_Mutex. */
+  Page &
+  FaultIn(const IndexType & index);
+
+  /** Must hold m_Mutex. */
+  void
+  WriteBack(Page & page);
+  void
+  FlushAndRelease();
+
+  int           m_TimeIndex = 0;
+  int           m_ChannelIndex = 0;
+  bool          m_Writable = false;
+  SizeValueType m_MaximumNumberOfPages = 64;
+  RegionType    m_LargestPossibleRegion;
+  SpacingType   m_Spacing{};
+  PointType     m_Origin{};
+  DirectionType m_Direction{ DirectionType::GetIdentity() };
+  SizeType      m_PageSize{};
+
+  OMEZarrNGFFImageIO::Pointer m_ReadIO;
+  OMEZarrNGFFImageIO::Pointer m_WriteIO; // created on the first write back
+
+  mutable std::mutex                                             m_Mutex;
+  PageList                                                       m_Pages; // most recently used first
+  std::unordered_map<SizeValueType, typename PageList::iterator> m_PageMap;
+  SizeValueType                                                  m_NumberOfPageHits = 0;
+  SizeValueType                                                  m_NumberOfPageFaults = 0;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkOMEZarrNGFFPagedImage.hxx"
+#endif
+
+#endif // itkOMEZarrNGFFPagedImage_h
@@ -0,0 +1,300 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkOMEZarrNGFFPagedImage_hxx
+#define itkOMEZarrNGFFPagedImage_hxx
+
+#include <algorithm>
+
+namespace itk
+{
+template <typename TPixel, unsigned int VImageDimension>
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::~OMEZarrNGFFPagedImage()
+{
+  try
+  {
+    this->FlushAndRelease();
+  }
+  catch (const ExceptionObject & e)
+  {
+    itkWarningMacro(<< "Failed to write modified pages back: " << e.GetDescription());
+  }
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::SetMaximumNumberOfPages(const SizeValueType maximumNumberOfPages)
+{
+  itkAssertOrThrowMacro(maximumNumberOfPages > 0, "At least one page must fit in memory");
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  m_MaximumNumberOfPages = maximumNumberOfPages;
+  while (m_Pages.size() > m_MaximumNumberOfPages)
+  {
+    this->WriteBack(m_Pages.back());
+    m_PageMap.erase(m_Pages.back().key);
+    m_Pages.pop_back();
+  }
+  this->Modified();
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::Open(const std::string & fileName)
+{
+  this->FlushAndRelease();
+
+  auto readIO = OMEZarrNGFFImageIO::New();
+  readIO->SetFileName(fileName);
+  readIO->ReadImageInformation();
+  if (readIO->GetNumberOfDimensions() < ImageDimension)
+  {
+    itkExceptionMacro(<< "The image " << fileName << " has " << readIO->GetNumberOfDimensions()
+                      << " dimensions, fewer than the " << ImageDimension << " of this paged image");
+  }
+  if (readIO->GetComponentType() != ImageIOBase::MapPixelType<TPixel>::CType)
+  {
+    itkExceptionMacro(<< "The component type " << ImageIOBase::GetComponentTypeAsString(readIO->GetComponentType())
+                      << " of " << fileName << " does not match the pixel type of this paged image");
+  }
+
+  const auto chunkSize = readIO->GetStoreChunkSize();
+  for (unsigned d = 0; d < ImageDimension; ++d)
+  {
+    m_LargestPossibleRegion.SetIndex(d, 0);
+    m_LargestPossibleRegion.SetSize(d, readIO->GetDimensions(d));
+    m_PageSize[d] = chunkSize[d];
+    m_Spacing[d] = readIO->GetSpacing(d);
+    m_Origin[d] = readIO->GetOrigin(d);
+    for (unsigned k = 0; k < ImageDimension; ++k)
+    {
+      m_Direction[k][d] = readIO->GetDirection(d)[k];
+    }
+  }
+  m_ReadIO = readIO;
+  m_WriteIO = nullptr;
+  this->Modified();
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+auto
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::FaultIn(const IndexType & index) -> Page &
+{
+  if (!m_ReadIO)
+  {
+    itkExceptionMacro(<< "Open must be called before accessing pixels");
+  }
+  if (!m_LargestPossibleRegion.IsInside(index))
+  {
+    itkExceptionMacro(<< "Index " << index << " is outside of the image region " << m_LargestPossibleRegion);
+  }
+
+  // Pages are numbered in the order of the page grid, with the first axis the fastest moving
+  IndexType     pageIndex;
+  SizeValueType key = 0;
+  SizeValueType stride = 1;
+  for (unsigned d = 0; d < ImageDimension; ++d)
+  {
+    pageIndex[d] = index[d] / static_cast<IndexValueType>(m_PageSize[d]);
+    key += pageIndex[d] * stride;
+    stride *= (m_LargestPossibleRegion.GetSize(d) + m_PageSize[d] - 1) / m_PageSize[d];
+  }
+
+  const auto found = m_PageMap.find(key);
+  if (found != m_PageMap.end())
+  {
+    ++m_NumberOfPageHits;
+    m_Pages.splice(m_Pages.begin(), m_Pages, found->second);
+    return m_Pages.front();
+  }
+
+  ++m_NumberOfPageFaults;
+  if (m_Pages.size() >= m_MaximumNumberOfPages)
+  {
+    // Reuse the pixel buffer of the least recently used page
+    Page & evicted = m_Pages.back();
+    this->WriteBack(evicted);
+    m_PageMap.erase(evicted.key);
+    m_Pages.splice(m_Pages.begin(), m_Pages, std::prev(m_Pages.end()));
+  }
+  else
+  {
+    m_Pages.emplace_front();
+  }
+  Page & page = m_Pages.front();
+  page.key = key;
+  page.dirty = false;
+  for (unsigned d = 0; d < ImageDimension; ++d)
+  {
+    page.region.SetIndex(d, pageIndex[d] * m_PageSize[d]);
+    page.region.SetSize(d, m_PageSize[d]);
+  }
+  page.region.Crop(m_LargestPossibleRegion);
+  page.pixels.resize(page.region.GetNumberOfPixels());
+
+  ImageIORegion ioRegion(ImageDimension);
+  for (unsigned d = 0; d < ImageDimension; ++d)
+  {
+    ioRegion.SetIndex(d, page.region.GetIndex(d));
+    ioRegion.SetSize(d, page.region.GetSize(d));
+  }
+  try
+  {
+    m_ReadIO->ReadRegion(ioRegion, m_TimeIndex, m_ChannelIndex, page.pixels.data());
+  }
+  catch (...)
+  {
+    m_Pages.pop_front();
+    throw;
+  }
+  m_PageMap[key] = m_Pages.begin();
+  return page;
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::WriteBack(Page & page)
+{
+  if (!page.dirty)
+  {
+    return;
+  }
+  if (!m_WriteIO)
+  {
+    auto writeIO = OMEZarrNGFFImageIO::New();
+    writeIO->SetFileName(m_ReadIO->GetFileName());
+    writeIO->SetNumberOfDimensions(ImageDimension);
+    for (unsigned d = 0; d < ImageDimension; ++d)
+    {
+      writeIO->SetDimensions(d, m_LargestPossibleRegion.GetSize(d));
+    }
+    writeIO->SetPixelTypeInfo(static_cast<const TPixel *>(nullptr));
+    writeIO->SetTimeIndex(m_TimeIndex);
+    writeIO->SetChannelIndex(m_ChannelIndex);
+    writeIO->SetWriteMode(OMEZarrNGFFImageIOEnums::WriteMode::Update);
+    m_WriteIO = writeIO;
+  }
+
+  ImageIORegion ioRegion(ImageDimension);
+  for (unsigned d = 0; d < ImageDimension; ++d)
+  {
+    ioRegion.SetIndex(d, page.region.GetIndex(d));
+    ioRegion.SetSize(d, page.region.GetSize(d));
+  }
+  m_WriteIO->SetIORegion(ioRegion);
+  m_WriteIO->Write(page.pixels.data());
+  page.dirty = false;
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+auto
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::GetPixel(const IndexType & index) -> PixelType
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  const Page &                      page = this->FaultIn(index);
+  return page.pixels[page.Offset(index)];
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::SetPixel(const IndexType & index, const PixelType & value)
+{
+  if (!m_Writable)
+  {
+    itkExceptionMacro(<< "SetPixel requires a writable paged image");
+  }
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  Page &                            page = this->FaultIn(index);
+  page.pixels[page.Offset(index)] = value;
+  page.dirty = true;
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::Flush()
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  for (auto & page : m_Pages)
+  {
+    this->WriteBack(page);
+  }
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::FlushAndRelease()
+{
+  this->Flush();
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Pages.clear();
+  m_PageMap.clear();
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+SizeValueType
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::GetNumberOfResidentPages() const
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Pages.size();
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+SizeValueType
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::GetNumberOfPageHits() const
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfPageHits;
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+SizeValueType
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::GetNumberOfPageFaults() const
+{
+  const std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfPageFaults;
+}
+
+
+template <typename TPixel, unsigned int VImageDimension>
+void
+OMEZarrNGFFPagedImage<TPixel, VImageDimension>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "TimeIndex: " << m_TimeIndex << std::endl;
+  os << indent << "ChannelIndex: " << m_ChannelIndex << std::endl;
+  os << indent << "Writable: " << (m_Writable ? "On" : "Off") << std::endl;
+  os << indent << "MaximumNumberOfPages: " << m_MaximumNumberOfPages << std::endl;
+  os << indent << "LargestPossibleRegion: " << m_LargestPossibleRegion << std::endl;
+  os << indent << "PageSize: " << m_PageSize << std::endl;
+  os << indent << "NumberOfPageHits: " << this->GetNumberOfPageHits() << std::endl;
+  os << indent << "NumberOfPageFaults: " << this->GetNumberOfPageFaults() << std::endl;
+  os << indent << "NumberOfResidentPages: " << this->GetNumberOfResidentPages() << std::endl;
+}
+} // end namespace itk
+
+#endif // itkOMEZarrNGFFPagedImage_hxx
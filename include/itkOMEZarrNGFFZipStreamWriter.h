@@ -0,0 +1,91 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkOMEZarrNGFFZipStreamWriter_h
+#define itkOMEZarrNGFFZipStreamWriter_h
+#include "IOOMEZarrNGFFExport.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+/** \class OMEZarrNGFFZipStreamWriter
+ *
+ * \brief Append entries to a zip archive on disk as they become available.
+ *
+ * Entries are stored without additional compression, as zarr chunks are
+ * already compressed. Only the central directory records are kept in memory,
+ * and they are written by Close. ZIP64 records are used when needed,
+ * so archives and entries may exceed 4 GB.
+ *
+ * \ingroup IOOMEZarrNGFF
+ */
+class IOOMEZarrNGFF_EXPORT OMEZarrNGFFZipStreamWriter
+{
+public:
+  /** Create (or truncate) the archive file. Throws if the file cannot be opened. */
+  explicit OMEZarrNGFFZipStreamWriter(const std::string & fileName);
+
+  /** Closes the archive if Close has not been called yet. As a destructor does not throw,
+   * an error is reported as a warning. Call Close to handle it. */
+  ~OMEZarrNGFFZipStreamWriter();
+
+  OMEZarrNGFFZipStreamWriter(const OMEZarrNGFFZipStreamWriter &) = delete;
+  OMEZarrNGFFZipStreamWriter &
+  operator=(const OMEZarrNGFFZipStreamWriter &) = delete;
+
+  /** Append an entry with the given name (path within the archive) and content. */
+  void
+  AddEntry(const std::string & name, const char * data, uint64_t size);
+
+  /** Write the central directory and close the file. */
+  void
+  Close();
+
+  bool
+  IsOpen() const
+  {
+    return m_Stream.is_open();
+  }
+
+  const std::string &
+  GetFileName() const
+  {
+    return m_FileName;
+  }
+
+private:
+  struct Entry
+  {
+    std::string name;
+    uint32_t    crc;
+    uint64_t    size;
+    uint64_t    offset;
+  };
+
+  std::string        m_FileName;
+  std::ofstream      m_Stream;
+  std::vector<Entry> m_Entries;
+  uint64_t           m_Offset = 0;
+};
+} // end namespace itk
+
+#endif // itkOMEZarrNGFFZipStreamWriter_h
@@ -17,21 +17,54 @@
  *=========================================================================*/
 
 #include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFZipStreamWriter.h"
+#include "itkCommand.h"
 #include "itkIOCommon.h"
 #include "itkIntTypes.h"
 #include "itkByteSwapper.h"
 #include "itkMacro.h"
+#include "itkMetaDataObject.h"
+#include "itkMultiThreaderBase.h"
+#include "itkProcessObject.h"
+#include "itksys/SystemTools.hxx"
 
+#include "tensorstore/cast.h"
 #include "tensorstore/container_kind.h"
 #include "tensorstore/context.h"
 #include "tensorstore/index_space/dim_expression.h"
 #include "tensorstore/open.h"
+#include "tensorstore/tensorstore.h"
 #include "tensorstore/index_space/index_domain.h"
 #include "tensorstore/index_space/index_domain_builder.h"
 #include "tensorstore/index_space/dim_expression.h"
+#include "tensorstore/kvstore/generation.h"
+#include "tensorstore/kvstore/kvstore.h"
+#include "tensorstore/kvstore/key_range.h"
+#include "tensorstore/kvstore/operations.h"
+#include "tensorstore/util/executor.h"
+#include "tensorstore/util/future.h"
 
+#include "absl/strings/cord.h"
+#include "absl/time/time.h"
+#include "blosc.h"
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
 // Evaluate tensorstore future (statement) and error-check the result.
 #define TS_EVAL_CHECK(statement)                                          \
   {                                                                       \
@@ -172,6 +205,12 @@ MakePath(const int datasetIndex)
   return 's' + std::to_string(datasetIndex);
 }
 
+bool
+hasSuffix(const std::string & path, const std::string & suffix)
+{
+  return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
 // Returns TensorStore KvStore driver name appropriate for this path.
 // Options are file, zip. TODO: http, gcs (GoogleCouldStorage), etc.
 std::string
@@ -192,575 +231,3549 @@ getKVstoreDriver(std::string path)
   return "file";
 }
 
-template <typename TPixel>
-void
-ReadFromStore(const tensorstore::TensorStore<> & store, const ImageIORegion & storeIORegion, TPixel * buffer)
+// Returns TensorStore KvStore driver name used for writing to this path.
+// Zip archives on disk are staged in an in-memory key-value store,
+// from which completed chunks are streamed into the archive.
+std::string
+getKVstoreWriteDriver(const std::string & path)
 {
-  if (store.domain().num_elements() == storeIORegion.GetNumberOfPixels())
+  if (hasSuffix(path, ".zip"))
   {
-    // Read the entire available voxel region.
-    // Allow tensorstore to perform any axis permutations or other index operations
-    // to map from store axes to ITK image axes.
-    auto arr = tensorstore::Array(buffer, store.domain().shape(), tensorstore::c_order);
-    tensorstore::Read(store, tensorstore::UnownedToShared(arr)).value();
-  }
-  else
-  {
-    // Read a requested voxel subregion.
-    // We cannot infer axis permutations by matching requested axis sizes.
-    // Therefore we assume that tensorstore axes are in "C-style" order
-    // with the last index as the fastest moving axis, aka "z,y,x" order,
-    // and must inverted to match ITK's "Fortran-style" order of axis indices
-    // with the first index as the fastest moving axis, aka "x,y,z" order.
-    // "C-style" is generally the default layout for new tensorstore arrays.
-    // Refer to https://google.github.io/tensorstore/driver/zarr/index.html#json-driver/zarr.metadata.order
-    //
-    // In the future this may be extended to permute axes based on
-    // OME-Zarr NGFF axis labels.
-    const auto                      dimension = store.rank();
-    std::vector<tensorstore::Index> indices(dimension);
-    std::vector<tensorstore::Index> sizes(dimension);
-    for (size_t dim = 0; dim < dimension; ++dim)
-    {
-      // Input IO region is assumed to already be reversed from ITK requested region
-      // to match assumed C-style Zarr storage
-      indices[dim] = storeIORegion.GetIndex(dim);
-      sizes[dim] = storeIORegion.GetSize(dim);
-    }
-    auto indexDomain = tensorstore::IndexDomainBuilder(dimension).origin(indices).shape(sizes).Finalize().value();
-
-    auto arr = tensorstore::Array(buffer, indexDomain.shape(), tensorstore::c_order);
-    auto indexedStore = store | tensorstore::AllDims().SizedInterval(indices, sizes);
-    tensorstore::Read(indexedStore, tensorstore::UnownedToShared(arr)).value();
+    return "memory";
   }
+  return getKVstoreDriver(path);
 }
 
-// Reads from the store if the specified pixel type and the ITK component type match.
-template <typename TPixel>
-bool
-ReadFromStoreIfTypesMatch(const IOComponentEnum              componentType,
-                          const tensorstore::TensorStore<> & store,
-                          const ImageIORegion &              storeIORegion,
-                          void *                             buffer)
+// Zarr v2 array metadata (except for the dtype) for a new array.
+// `compressor` is the upper-case name set through ImageIOBase::SetCompressor.
+// `compressionLevel` is clamped to the range supported by the selected codec.
+// `chunkSize` is in ITK order, and may be shorter than `shape` (in C order).
+nlohmann::json
+makeArrayMetadata(const std::vector<int64_t> &       shape,
+                  const std::string &                compressor,
+                  const int                          compressionLevel,
+                  const std::vector<SizeValueType> & chunkSize)
 {
-  if (tensorstoreToITKComponentType(tensorstore::dtype_v<TPixel>) == componentType)
+  nlohmann::json metadata = { { "shape", shape } };
+
+  if (compressor.empty())
   {
-    ReadFromStore(store, storeIORegion, static_cast<TPixel *>(buffer));
-    return true;
+    metadata["compressor"] = { { "id", "blosc" } }; // tensorstore defaults
+  }
+  else if (compressor == "BLOSC")
+  {
+    metadata["compressor"] = {
+      { "id", "blosc" }, { "cname", "lz4" }, { "clevel", std::min(std::max(compressionLevel, 0), 9) }, { "shuffle", -1 }
+    };
+  }
+  else if (compressor == "ZSTD" || compressor == "ZLIB" || compressor == "GZIP")
+  {
+    std::string id = compressor;
+    std::transform(id.begin(), id.end(), id.begin(), ::tolower);
+    const int maxLevel = (compressor == "ZSTD" ? 22 : 9);
+    metadata["compressor"] = { { "id", id }, { "level", std::min(std::max(compressionLevel, 0), maxLevel) } };
+  }
+  else if (compressor == "BZ2")
+  {
+    metadata["compressor"] = { { "id", "bz2" }, { "level", std::min(std::max(compressionLevel, 1), 9) } };
+  }
+  else // "NONE"
+  {
+    metadata["compressor"] = nullptr;
   }
-  return false;
-}
 
-// Tries to read from the specified store, trying any of the specified pixel types.
-template <typename... TPixel>
-bool
-TryToReadFromStore(TypeList<TPixel...>,
-                   const IOComponentEnum              componentType,
-                   const tensorstore::TensorStore<> & store,
-                   const ImageIORegion &              storeIORegion,
-                   void *                             buffer)
-{
-  return (ReadFromStoreIfTypesMatch<TPixel>(componentType, store, storeIORegion, buffer) || ...);
+  if (!chunkSize.empty())
+  {
+    const size_t         rank = shape.size();
+    std::vector<int64_t> chunks(rank, 1);
+    for (size_t d = 0; d < rank && d < chunkSize.size(); ++d)
+    {
+      // reverse indices IJK into KJI, and do not exceed the array extent
+      chunks[rank - 1 - d] = std::min<int64_t>(chunkSize[d], std::max<int64_t>(shape[rank - 1 - d], 1));
+    }
+    metadata["chunks"] = chunks;
+  }
+  return metadata;
 }
 
-// Writes to the store if the specified pixel type and the ITK component type match.
-template <typename TPixel>
-bool
-WriteToStoreIfTypesMatch(const IOComponentEnum        componentType,
-                         tensorstore::TensorStore<> & store,
-                         tensorstore::Context &       tsContext,
-                         const std::string &          fileName,
-                         const std::string &          path,
-                         const std::vector<int64_t> & shape,
-                         const void * const           buffer)
+// Calls `function` with the grid cell of each chunk which intersects the box [start, start + size).
+// Grid cells are visited in C order.
+template <typename TFunction>
+void
+forEachChunk(const std::vector<tensorstore::Index> & start,
+             const std::vector<tensorstore::Index> & size,
+             const std::vector<tensorstore::Index> & chunkShape,
+             TFunction &&                            function)
 {
-  if (tensorstoreToITKComponentType(tensorstore::dtype_v<TPixel>) == componentType)
+  const size_t                    rank = start.size();
+  std::vector<tensorstore::Index> first(rank);
+  std::vector<tensorstore::Index> last(rank);
+  for (size_t d = 0; d < rank; ++d)
   {
-    std::string dtype;
-    // we prefer to write using our own endianness, so no conversion is necessary
-    if (ByteSwapper<int>::SystemIsBigEndian())
+    if (size[d] <= 0)
     {
-      dtype = ">";
-    }
-    else
-    {
-      dtype = "<";
+      return;
     }
+    first[d] = start[d] / chunkShape[d];
+    last[d] = (start[d] + size[d] - 1) / chunkShape[d];
+  }
 
-    if (sizeof(TPixel) == 1)
-    {
-      dtype = "|";
-    }
-    if (std::numeric_limits<TPixel>::is_integer)
+  std::vector<tensorstore::Index> cell(first);
+  for (;;)
+  {
+    function(static_cast<const std::vector<tensorstore::Index> &>(cell));
+    size_t d = rank;
+    for (; d > 0; --d)
     {
-      if (std::numeric_limits<TPixel>::is_signed)
-      {
-        dtype += 'i';
-      }
-      else
+      if (++cell[d - 1] <= last[d - 1])
       {
-        dtype += 'u';
+        break;
       }
+      cell[d - 1] = first[d - 1];
     }
-    else
+    if (d == 0)
     {
-      dtype += 'f';
+      return;
     }
-    dtype += std::to_string(sizeof(TPixel));
-
-    auto openFuture = tensorstore::Open(
-      {
-        { "driver", "zarr" },
-        { "kvstore", { { "driver", getKVstoreDriver(fileName) }, { "path", fileName + "/" + path } } },
-        { "metadata",
-          {
-            { "compressor", { { "id", "blosc" } } },
-            { "dtype", dtype },
-            { "shape", shape },
-          } },
-      },
-      tsContext,
-      tensorstore::OpenMode::create | tensorstore::OpenMode::delete_existing,
-      tensorstore::ReadWriteMode::read_write);
-    TS_EVAL_CHECK(openFuture);
-
-    auto   writeStore = openFuture.value();
-    auto * p = static_cast<TPixel const *>(buffer);
-    auto   arr = tensorstore::Array(p, shape, tensorstore::c_order);
-    auto   writeFuture = tensorstore::Write(tensorstore::UnownedToShared(arr), writeStore);
-    TS_EVAL_CHECK(writeFuture);
-    return true;
   }
-  return false;
 }
 
-// Tries to write to the specified store, trying any of the specified pixel types.
-template <typename... TPixel>
-bool
-TryToWriteToStore(TypeList<TPixel...>,
-                  const IOComponentEnum        componentType,
-                  tensorstore::TensorStore<> & store,
-                  tensorstore::Context &       tsContext,
-                  const std::string &          fileName,
-                  const std::string &          path,
-                  const std::vector<int64_t> & shape,
-                  const void * const           buffer)
+// Zarr v2 key of a chunk, relative to its array, e.g. "2.0.1"
+std::string
+makeChunkKey(const std::vector<tensorstore::Index> & cell, const std::string & separator = ".")
 {
-  return (WriteToStoreIfTypesMatch<TPixel>(componentType, store, tsContext, fileName, path, shape, buffer) || ...);
+  std::string key;
+  for (size_t d = 0; d < cell.size(); ++d)
+  {
+    key += (d > 0 ? separator : "") + std::to_string(cell[d]);
+  }
+  return cell.empty() ? "0" : key;
 }
 
-// Update an existing "read" specification for an "http" driver to retrieve remote files.
-// Note that an "http" driver specification may operate on an HTTP or HTTPS connection.
-void
-MakeKVStoreHTTPDriverSpec(nlohmann::json & spec, const std::string & fullPath)
+std::vector<tensorstore::Index>
+getChunkShape(const tensorstore::TensorStore<> & store)
 {
-  // Decompose path into a base URL and reference subpath according to TensorStore HTTP KVStore driver spec
-  // https://google.github.io/tensorstore/kvstore/http/index.html
-  spec["kvstore"] = { { "driver", "http" } };
-
-  // Naively decompose the URL into "base" and "resource" components.
-  // Generally assumes that the spec will only be used once to access a specific resource.
-  // For example, the URL "http://localhost/path/to/resource.json" will be split
-  // into components "http://localhost/path/to" and "resource.json".
-  //
-  // Could be revisited for a better root "base_url" at the top level allowing acces
-  // to multiple subpaths. For instance, decomposing the example above into
-  // "http://localhost/" and "path/to/resource.json" would allow for a given HTTP spec
-  // to be more easily reused with different subpaths.
-  //
-  spec["kvstore"]["base_url"] = fullPath.substr(0, fullPath.find_last_of("/"));
-  spec["kvstore"]["path"] = fullPath.substr(fullPath.find_last_of("/") + 1);
+  auto layout = store.chunk_layout();
+  if (!layout.ok())
+  {
+    itkGenericExceptionMacro("tensorstore error: " << layout.status());
+  }
+  auto readChunkShape = layout->read_chunk_shape();
+  return std::vector<tensorstore::Index>(readChunkShape.begin(), readChunkShape.end());
 }
 
-// JSON file path, e.g. "C:/Dev/ITKIOOMEZarrNGFF/v0.4/cyx.ome.zarr/.zgroup"
-void
-writeJson(nlohmann::json json, std::string path, std::string driver, tensorstore::Context& tsContext)
+// Number of chunks which intersect the box [start, start + size).
+uint64_t
+countChunks(const ImageIORegion & storeIORegion, const std::vector<tensorstore::Index> & chunkShape)
 {
-  auto attrs_store = tensorstore::Open<nlohmann::json, 0>(
-                       { { "driver", "json" }, { "kvstore", { { "driver", driver }, { "path", path } } } },
-                       tsContext,
-                       tensorstore::OpenMode::create | tensorstore::OpenMode::delete_existing,
-                       tensorstore::ReadWriteMode::read_write)
-                       .result()
-                       .value();
-  auto writeFuture = tensorstore::Write(tensorstore::MakeScalarArray(json), attrs_store); // preferably pretty-print
-
-  auto result = writeFuture.result();
-  if (!result.ok())
+  uint64_t count = 1;
+  for (size_t d = 0; d < chunkShape.size(); ++d)
   {
-    itkGenericExceptionMacro(<< "There was an error writing metadata to file '" << path
-                             << ". Error details: " << result.status());
+    const auto start = storeIORegion.GetIndex(d);
+    const auto size = static_cast<tensorstore::Index>(storeIORegion.GetSize(d));
+    if (size <= 0)
+    {
+      return 0;
+    }
+    count *= (start + size - 1) / chunkShape[d] - start / chunkShape[d] + 1;
   }
+  return count;
 }
 
-// JSON file path, e.g. "C:/Dev/ITKIOOMEZarrNGFF/v0.4/cyx.ome.zarr/.zattrs"
-bool
-jsonRead(const std::string path, nlohmann::json & result, std::string driver, tensorstore::Context& tsContext)
+// Separator of the chunk keys of a zarr v2 array whose chunks are blosc frames of its pixels in C order,
+// in the byte order of this machine, so that blocks of them can be decoded directly. Otherwise empty.
+std::string
+getPartiallyDecodableChunkKeySeparator(const tensorstore::TensorStore<> & store)
 {
-  // Reading JSON via TensorStore allows it to be in the cloud
-  nlohmann::json readSpec = { { "driver", "json" }, { "kvstore", { { "driver", driver }, { "path", path } } } };
-  if (driver == "http")
+  auto spec = store.spec();
+  if (!spec.ok())
   {
-    MakeKVStoreHTTPDriverSpec(readSpec, path);
+    return {};
   }
-
-  auto attrs_store = tensorstore::Open<nlohmann::json, 0>(readSpec, tsContext).result().value();
-
-  auto attrs_array_result = tensorstore::Read(attrs_store).result();
-
-  nlohmann::json attrs;
-  if (attrs_array_result.ok())
+  auto json = spec->ToJson();
+  if (!json.ok() || !json->contains("metadata"))
   {
-    result = attrs_array_result.value()();
-    return true;
+    return {};
   }
-  else if (absl::IsNotFound(attrs_array_result.status()))
+  const nlohmann::json & metadata = json->at("metadata");
+  const auto             compressor = metadata.value("compressor", nlohmann::json{});
+  if (!compressor.is_object() || compressor.value("id", "") != "blosc" || metadata.value("order", "C") != "C" ||
+      !metadata.value("filters", nlohmann::json{}).is_null())
   {
-    result = nlohmann::json::object_t();
-    return false;
+    return {};
   }
-  else // another error
+  const auto dtype = metadata.value("dtype", nlohmann::json{}); // structured data types are arrays
+  if (!dtype.is_string() || dtype.get<std::string>().empty())
   {
-    result = nlohmann::json::object_t();
-    return false;
+    return {};
+  }
+  const char byteOrder = dtype.get<std::string>()[0];
+  if (byteOrder != '|' && byteOrder != (ByteSwapper<int>::SystemIsLittleEndian() ? '<' : '>'))
+  {
+    return {};
   }
+  return metadata.value("dimension_separator", ".");
 }
 
-void
-addCoordinateTransformations(OMEZarrNGFFImageIO * io, nlohmann::json ct)
+// Writes events in the Chrome trace event format ("JSON Array Format"), which can be loaded
+// into chrome://tracing or https://ui.perfetto.dev. One writer is shared by all IO objects
+// tracing into the same file. The closing bracket is written on destruction;
+// the format allows it to be missing if the process ends early.
+class TraceWriter
 {
-  itkAssertOrThrowMacro(ct.is_array(), "Failed to parse coordinate transforms");
-  itkAssertOrThrowMacro(ct.size() >= 1, "Expected at least one coordinate transform");
-  itkAssertOrThrowMacro(ct[0].at("type") == "scale",
-                        ("Expected first transform to be \"scale\" but found " +
-                         std::string(ct[0].at("type")))); // first transformation must be scale
+public:
+  static std::shared_ptr<TraceWriter>
+  ForFile(const std::string & fileName)
+  {
+    static std::mutex                                         registryMutex;
+    static std::map<std::string, std::weak_ptr<TraceWriter>> registry;
+    std::lock_guard<std::mutex>                               lock(registryMutex);
 
-  nlohmann::json s = ct[0].at("scale");
-  itkAssertOrThrowMacro(s.is_array(), "Failed to parse scale transform");
-  unsigned dim = s.size();
-  itkAssertOrThrowMacro(dim == io->GetNumberOfDimensions(), "Found dimension mismatch in scale transform");
+    std::shared_ptr<TraceWriter> writer = registry[fileName].lock();
+    if (!writer)
+    {
+      writer = std::make_shared<TraceWriter>(fileName);
+      registry[fileName] = writer;
+    }
+    return writer;
+  }
 
-  for (unsigned d = 0; d < dim; ++d)
+  explicit TraceWriter(const std::string & fileName)
+    : m_Stream(fileName, std::ios::trunc)
   {
-    double dS = s[dim - d - 1].get<double>(); // reverse indices KJI into IJK
-    io->SetSpacing(d, dS * io->GetSpacing(d));
-    io->SetOrigin(d, dS * io->GetOrigin(d)); // TODO: should we update origin like this?
+    if (!m_Stream.is_open())
+    {
+      itkGenericExceptionMacro(<< "Could not open trace file for writing: " << fileName);
+    }
+    m_Stream << "[";
   }
 
-  if (ct.size() > 1) // there is also a translation
+  ~TraceWriter()
   {
-    itkAssertOrThrowMacro(ct[1].at("type") == "translation",
-                          ("Expected second transform to be \"translation\" but found " +
-                           std::string(ct[1].at("type")))); // first transformation must be scale
-    nlohmann::json tr = ct[1].at("translation");
-    itkAssertOrThrowMacro(tr.is_array(), "Failed to parse translation transform");
-    dim = tr.size();
-    itkAssertOrThrowMacro(dim == io->GetNumberOfDimensions(), "Found dimension mismatch in translation transform");
+    this->Flush();
+    m_Stream << "\n]\n";
+  }
 
-    for (unsigned d = 0; d < dim; ++d)
+  // Microseconds since the first call in this process
+  static int64_t
+  Now()
+  {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+  }
+
+  // A span on the calling thread, from `start` until now
+  void
+  Complete(const std::string & name, const char * category, int64_t start, const nlohmann::json & args)
+  {
+    nlohmann::json event = { { "name", name }, { "cat", category },      { "ph", "X" },
+                             { "ts", start },  { "dur", Now() - start }, { "pid", 1 },
+                             { "tid", ThreadId() } };
+    if (!args.empty())
     {
-      double dOrigin = tr[dim - d - 1].get<double>(); // reverse indices KJI into IJK
-      io->SetOrigin(d, dOrigin + io->GetOrigin(d));
+      event["args"] = args;
     }
+    this->Append({ event });
   }
 
-  if (ct.size() > 2)
+  // An asynchronous span, which may overlap with others on the same thread
+  void
+  AsyncSpan(const std::string & name, const char * category, int64_t start, int64_t end, const nlohmann::json & args)
   {
-    itkGenericOutputMacro(<< "A sequence of more than 2 transformations is specified in '" << io->GetFileName()
-                          << "'. This is currently not supported. Extra transformations are ignored.");
+    const uint64_t id = ++m_NextId;
+    nlohmann::json begin = { { "name", name }, { "cat", category }, { "ph", "b" }, { "ts", start },
+                             { "id", id },     { "pid", 1 },        { "tid", ThreadId() } };
+    if (!args.empty())
+    {
+      begin["args"] = args;
+    }
+    nlohmann::json finish = begin;
+    finish["ph"] = "e";
+    finish["ts"] = end;
+    finish.erase("args");
+    this->Append({ begin, finish });
   }
-}
 
-} // namespace
+  void
+  Flush()
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    this->FlushLocked();
+  }
 
-struct OMEZarrNGFFImageIO::TensorStoreData
-{
-  tensorstore::Context       tsContext{ tensorstore::Context::Default() };
-  tensorstore::TensorStore<> store{};
+private:
+  static uint64_t
+  ThreadId()
+  {
+    return std::hash<std::thread::id>{}(std::this_thread::get_id()) % 1000000;
+  }
+
+  void
+  Append(const std::vector<nlohmann::json> & events)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const auto & event : events)
+    {
+      m_Events.push_back(event.dump());
+    }
+    if (m_Events.size() >= 4096)
+    {
+      this->FlushLocked();
+    }
+  }
+
+  void
+  FlushLocked()
+  {
+    for (const auto & event : m_Events)
+    {
+      m_Stream << (m_Empty ? "\n" : ",\n") << event;
+      m_Empty = false;
+    }
+    m_Events.clear();
+    m_Stream.flush();
+  }
+
+  std::mutex               m_Mutex;
+  std::ofstream            m_Stream;
+  std::vector<std::string> m_Events;
+  bool                     m_Empty = true;
+  std::atomic<uint64_t>    m_NextId{ 0 };
 };
 
-OMEZarrNGFFImageIO::OMEZarrNGFFImageIO()
-  : m_TensorStoreData(std::make_unique<TensorStoreData>())
+// Records a span from construction to destruction, when tracing is enabled (`writer` is not null).
+class TraceSpan
 {
-  this->AddSupportedWriteExtension(".zarr");
-  this->AddSupportedWriteExtension(".zr2");
-  this->AddSupportedWriteExtension(".zr3");
-  this->AddSupportedWriteExtension(".zip");
-  this->AddSupportedWriteExtension(".memory");
+public:
+  TraceSpan(TraceWriter * writer, std::string name, const char * category, nlohmann::json args = {})
+    : m_Writer(writer)
+    , m_Name(std::move(name))
+    , m_Category(category)
+    , m_Args(std::move(args))
+    , m_Start(writer != nullptr ? TraceWriter::Now() : 0)
+  {}
 
-  this->AddSupportedReadExtension(".zarr");
-  this->AddSupportedReadExtension(".zr2");
-  this->AddSupportedReadExtension(".zr3");
-  this->AddSupportedReadExtension(".zip");
-  this->AddSupportedWriteExtension(".memory");
+  ~TraceSpan() { this->End(); }
 
-  this->Self::SetCompressor("");
-  this->Self::SetMaximumCompressionLevel(9);
-  this->Self::SetCompressionLevel(2);
-}
+  // Ends the span before its destruction
+  void
+  End()
+  {
+    if (m_Writer != nullptr)
+    {
+      m_Writer->Complete(m_Name, m_Category, m_Start, m_Args);
+      m_Writer = nullptr;
+    }
+  }
 
-OMEZarrNGFFImageIO::~OMEZarrNGFFImageIO() = default;
+  ITK_DISALLOW_COPY_AND_MOVE(TraceSpan);
 
+private:
+  TraceWriter *  m_Writer;
+  std::string    m_Name;
+  const char *   m_Category;
+  nlohmann::json m_Args;
+  int64_t        m_Start;
+};
 
-void
-OMEZarrNGFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
+// Progress reporting and cancellation of chunk-wise reads and writes.
+struct ChunkProgress
 {
-  Superclass::PrintSelf(os, indent);
-  os << indent << "DatasetIndex: " << m_DatasetIndex << std::endl;
-  os << indent << "TimeIndex: " << m_TimeIndex << std::endl;
-  os << indent << "ChannelIndex: " << m_ChannelIndex << std::endl;
-}
+  std::function<void(float)>   report;    // called with the fraction of completed chunks
+  std::function<bool()>        isAborted; // polled while waiting for chunks
+  std::shared_ptr<TraceWriter> trace;     // records a span per chunk operation, if set
+  const char *                 traceName = "chunk";
 
-bool
-OMEZarrNGFFImageIO::CanReadFile(const char * filename)
+  // Called on the calling thread with the grid index of each chunk whose operation succeeded, in order
+  std::function<void(const std::vector<tensorstore::Index> &)> written;
+};
+
+// Bounds the number of chunk operations which must still complete after a cancellation.
+constexpr size_t MaximumChunkOperationsInFlight = 64;
+
+// Calls `operation(chunkStart, chunkSize)` for the part of the box [start, start + size) within each chunk.
+// The returned futures are awaited in order, with a bounded number in flight, and progress is reported
+// as they complete. After a cancellation or an error (including one thrown by `progress.written`),
+// the operations in flight are awaited, as they may still access the caller's buffer,
+// and ProcessAborted or an exception is thrown.
+template <typename TOperation>
+void
+runChunkOperations(const std::vector<tensorstore::Index> & start,
+                   const std::vector<tensorstore::Index> & size,
+                   const std::vector<tensorstore::Index> & chunkShape,
+                   TOperation &&                           operation,
+                   const ChunkProgress &                   progress)
 {
-  try
+  uint64_t numberOfChunks = 1;
+  for (size_t d = 0; d < start.size(); ++d)
   {
-    std::string    driver = getKVstoreDriver(filename);
-    nlohmann::json json;
-    if (!jsonRead(std::string(filename) + "/.zgroup", json, driver, m_TensorStoreData->tsContext))
+    numberOfChunks *= size[d] > 0 ? (start[d] + size[d] - 1) / chunkShape[d] - start[d] / chunkShape[d] + 1 : 0;
+  }
+
+  struct Operation
+  {
+    tensorstore::Future<void>             future;
+    int64_t                               traceStart; // when traced
+    std::shared_ptr<std::atomic<int64_t>> traceEnd;   // set once ready, by the thread completing the operation
+    std::vector<tensorstore::Index>       cell;
+  };
+  std::deque<Operation> inFlight;
+  uint64_t              completed = 0;
+  absl::Status          status;
+  std::exception_ptr    failure;
+  bool                  aborted = false;
+
+  const auto pollAbort = [&]() { aborted = aborted || (progress.isAborted && progress.isAborted()); };
+  const auto completeFirst = [&]() {
+    auto & first = inFlight.front();
+    while (!first.future.WaitFor(absl::Milliseconds(20)))
     {
-      return false;
+      pollAbort();
     }
-    if (json.at("zarr_format").get<int>() != 2)
+    const auto & result = first.future.result();
+    if (!result.ok() && status.ok())
     {
-      return false; // unsupported zarr format
+      status = result.status();
     }
-    if (!jsonRead(std::string(filename) + "/.zattrs", json, driver, m_TensorStoreData->tsContext))
+    if (result.ok() && progress.written && !failure && !aborted)
     {
-      return false;
+      try
+      {
+        progress.written(first.cell);
+      }
+      catch (...)
+      {
+        failure = std::current_exception();
+      }
     }
-    if (!json.at("multiscales").is_array())
+    if (progress.trace)
     {
-      return false; // multiscales attribute array must be present
+      // Spans are recorded here, as the callbacks might still be running after the wait
+      const int64_t  end = first.traceEnd->load();
+      nlohmann::json args = { { "chunk", makeChunkKey(first.cell) } };
+      if (!result.ok())
+      {
+        args["error"] = result.status().ToString();
+      }
+      progress.trace->AsyncSpan(
+        progress.traceName, "chunk", first.traceStart, end > 0 ? end : TraceWriter::Now(), args);
+    }
+    inFlight.pop_front();
+    ++completed;
+    if (progress.report && status.ok() && !failure && !aborted)
+    {
+      progress.report(static_cast<float>(completed) / numberOfChunks);
+    }
+  };
+
+  std::vector<tensorstore::Index> chunkStart(start.size());
+  std::vector<tensorstore::Index> chunkSize(start.size());
+  forEachChunk(start, size, chunkShape, [&](const std::vector<tensorstore::Index> & cell) {
+    pollAbort();
+    if (aborted || !status.ok() || failure)
+    {
+      return; // skip the remaining chunks
+    }
+    for (size_t d = 0; d < cell.size(); ++d)
+    {
+      chunkStart[d] = std::max(start[d], cell[d] * chunkShape[d]);
+      chunkSize[d] = std::min(start[d] + size[d], (cell[d] + 1) * chunkShape[d]) - chunkStart[d];
+    }
+    if (progress.trace)
+    {
+      const int64_t traceStart = TraceWriter::Now();
+      auto          traceEnd = std::make_shared<std::atomic<int64_t>>(0);
+      inFlight.push_back({ operation(chunkStart, chunkSize), traceStart, traceEnd, cell });
+      inFlight.back().future.ExecuteWhenReady(
+        [traceEnd](tensorstore::ReadyFuture<void>) { traceEnd->store(TraceWriter::Now()); });
+    }
+    else
+    {
+      inFlight.push_back({ operation(chunkStart, chunkSize), 0, nullptr, cell });
+    }
+    while (inFlight.size() >= MaximumChunkOperationsInFlight)
+    {
+      completeFirst();
+    }
+  });
+  while (!inFlight.empty())
+  {
+    completeFirst();
+  }
+
+  if (aborted)
+  {
+    throw ProcessAborted(__FILE__, __LINE__);
+  }
+  if (!status.ok())
+  {
+    itkGenericExceptionMacro("tensorstore error: " << status);
+  }
+  if (failure)
+  {
+    std::rethrow_exception(failure);
+  }
+}
+
+// Reports progress through the IO (and its progress source), and polls both for cancellation.
+// Chunk operations are traced with `traceName`, if `trace` is set.
+ChunkProgress
+makeChunkProgress(OMEZarrNGFFImageIO * io, const std::shared_ptr<TraceWriter> & trace, const char * traceName)
+{
+  io->SetAbortGenerateData(false);
+  io->UpdateProgress(0.0f);
+
+  ChunkProgress progress;
+  progress.report = [io](float fraction) {
+    io->UpdateProgress(fraction);
+    if (ProcessObject * source = io->GetProgressSource())
+    {
+      source->UpdateProgress(fraction);
+    }
+  };
+  progress.isAborted = [io]() {
+    const ProcessObject * source = io->GetProgressSource();
+    return io->GetAbortGenerateData() || (source != nullptr && source->GetAbortGenerateData());
+  };
+  progress.trace = trace;
+  progress.traceName = traceName;
+  return progress;
+}
+
+double
+secondsSince(const std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Copies the box [boxStart, boxStart + boxSize) of a chunk, given relative to the chunk, from the blosc frame
+// of the chunk into `buffer`, whose strides are in bytes. Only the blosc blocks which overlap the box are decoded.
+// They are decoded before the box is copied, and the time of both steps is added to `statistics`,
+// and traced as spans with `traceArgs` when `trace` is not null.
+void
+decodeOverlappingBlocks(const absl::string_view                 frame,
+                        const std::vector<tensorstore::Index> & chunkShape,
+                        const std::vector<tensorstore::Index> & boxStart,
+                        const std::vector<tensorstore::Index> & boxSize,
+                        const size_t                            itemSize,
+                        char *                                  buffer,
+                        const std::vector<tensorstore::Index> & bufferStrides,
+                        OMEZarrNGFFReadStatistics &             statistics,
+                        TraceWriter *                           trace,
+                        const nlohmann::json &                  traceArgs)
+{
+  const size_t                    rank = chunkShape.size();
+  std::vector<tensorstore::Index> chunkStrides(rank);
+  size_t                          chunkBytes = itemSize;
+  for (size_t d = rank; d > 0; --d)
+  {
+    chunkStrides[d - 1] = chunkBytes;
+    chunkBytes *= chunkShape[d - 1];
+  }
+
+  size_t nbytes = 0;
+  size_t cbytes = 0;
+  size_t blocksize = 0;
+  size_t typesize = 0;
+  int    flags = 0;
+  if (frame.size() >= BLOSC_MIN_HEADER_LENGTH)
+  {
+    blosc_cbuffer_sizes(frame.data(), &nbytes, &cbytes, &blocksize);
+    blosc_cbuffer_metainfo(frame.data(), &typesize, &flags);
+  }
+  if (nbytes != chunkBytes || cbytes > frame.size())
+  {
+    itkGenericExceptionMacro("Corrupt blosc chunk of " << frame.size() << " bytes, expected " << chunkBytes
+                                                       << " decoded bytes");
+  }
+
+  // Calls `function(chunkOffset, bufferOffset)` for each row of the box along the last axis
+  const size_t rowBytes = boxSize[rank - 1] * itemSize;
+  const auto   forEachRow = [&](const auto & function) {
+    std::vector<tensorstore::Index> position(rank, 0);
+    for (;;)
+    {
+      size_t chunkOffset = 0;
+      size_t bufferOffset = 0;
+      for (size_t d = 0; d < rank; ++d)
+      {
+        chunkOffset += (boxStart[d] + position[d]) * chunkStrides[d];
+        bufferOffset += position[d] * bufferStrides[d];
+      }
+      function(chunkOffset, bufferOffset);
+
+      size_t d = rank - 1;
+      for (; d > 0; --d)
+      {
+        if (++position[d - 1] < boxSize[d - 1])
+        {
+          break;
+        }
+        position[d - 1] = 0;
+      }
+      if (d == 0)
+      {
+        return;
+      }
+    }
+  };
+
+  // Decode the blocks which the rows overlap. Frames which cannot be split at items are decoded whole.
+  const auto                    decodeStart = std::chrono::steady_clock::now();
+  const std::unique_ptr<char[]> decoded(new char[nbytes]);
+  const bool blockwise = blocksize > 0 && typesize > 0 && blocksize % typesize == 0 && nbytes % typesize == 0;
+  TraceSpan  decodeSpan(trace, "decode chunk", "chunk", traceArgs);
+  if (blockwise)
+  {
+    std::vector<bool> isDecoded((nbytes + blocksize - 1) / blocksize);
+    forEachRow([&](const size_t chunkOffset, size_t) {
+      for (size_t block = chunkOffset / blocksize; block <= (chunkOffset + rowBytes - 1) / blocksize; ++block)
+      {
+        const size_t blockStart = block * blocksize;
+        const size_t blockBytes = std::min(blocksize, nbytes - blockStart);
+        if (!isDecoded[block] && blosc_getitem(frame.data(),
+                                               static_cast<int>(blockStart / typesize),
+                                               static_cast<int>(blockBytes / typesize),
+                                               decoded.get() + blockStart) < 0)
+        {
+          itkGenericExceptionMacro("Failed to decode block " << block << " of a blosc chunk");
+        }
+        isDecoded[block] = true;
+      }
+    });
+  }
+  else if (blosc_decompress_ctx(frame.data(), decoded.get(), nbytes, 1) < 0)
+  {
+    itkGenericExceptionMacro("Failed to decode a blosc chunk");
+  }
+  decodeSpan.End();
+  statistics.decodeSeconds += secondsSince(decodeStart);
+
+  const auto copyStart = std::chrono::steady_clock::now();
+  {
+    TraceSpan copySpan(trace, "copy chunk", "chunk", traceArgs);
+    forEachRow([&](const size_t chunkOffset, const size_t bufferOffset) {
+      std::memcpy(buffer + bufferOffset, decoded.get() + chunkOffset, rowBytes);
+    });
+  }
+  statistics.copySeconds += secondsSince(copyStart);
+}
+
+// Whether the box of `storeIORegion` covers only part of some chunk of `store`. Only then does decoding
+// the blosc blocks which overlap the box save work over reading whole chunks through tensorstore.
+bool
+coversPartOfAChunk(const tensorstore::TensorStore<> & store, const ImageIORegion & storeIORegion)
+{
+  const auto chunkShape = getChunkShape(store);
+  const auto shape = store.domain().shape();
+  for (size_t d = 0; d < chunkShape.size(); ++d)
+  {
+    const tensorstore::Index start = storeIORegion.GetIndex(d);
+    const tensorstore::Index end = start + static_cast<tensorstore::Index>(storeIORegion.GetSize(d));
+    if (start % chunkShape[d] != 0 || (end % chunkShape[d] != 0 && end != shape[d]))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Reads the box of `storeIORegion` of an array for which getPartiallyDecodableChunkKeySeparator is not empty
+// into `buffer`. The chunks which the box covers entirely, and missing chunks, are read through tensorstore,
+// which fills missing chunks with the fill value. The other chunks are fetched encoded, and only their blosc
+// blocks which overlap the box are decoded, by the thread which completes the fetch, so that chunks are decoded
+// concurrently. The chunks are read with a bounded number in flight, and progress is reported and cancellation
+// polled as they complete. After a cancellation or an error, the chunks in flight are awaited,
+// as they may still write into the buffer, and ProcessAborted or an exception is thrown.
+// The bytes and latency of the fetches, and the time of decoding and copying, are added to `statistics`.
+// When tracing, each chunk decoded block-wise is traced as a fetch span, from the request until it was fetched,
+// followed by decode and copy spans, and each chunk read through tensorstore as a span of its read.
+void
+readDecodingOverlappingBlocks(const tensorstore::TensorStore<> & store,
+                              const std::string &                chunkKeySeparator,
+                              const ImageIORegion &              storeIORegion,
+                              char *                             buffer,
+                              const ChunkProgress &              progress,
+                              OMEZarrNGFFReadStatistics &        statistics)
+{
+  const size_t                    rank = store.rank();
+  const size_t                    itemSize = store.dtype().size();
+  std::vector<tensorstore::Index> start(rank);
+  std::vector<tensorstore::Index> size(rank);
+  for (size_t d = 0; d < rank; ++d)
+  {
+    start[d] = storeIORegion.GetIndex(d);
+    size[d] = storeIORegion.GetSize(d);
+  }
+  std::vector<tensorstore::Index> bufferStrides(rank);
+  tensorstore::Index              stride = itemSize;
+  for (size_t d = rank; d > 0; --d)
+  {
+    bufferStrides[d - 1] = stride;
+    stride *= size[d - 1];
+  }
+
+  const auto                 chunkShape = getChunkShape(store);
+  const auto                 shape = store.domain().shape();
+  const uint64_t             numberOfChunks = countChunks(storeIORegion, chunkShape);
+  const tensorstore::KvStore kvstore = store.kvstore();
+
+  // The buffer, into which tensorstore reads the chunks which are not decoded block-wise
+  const auto array = tensorstore::UnownedToShared(tensorstore::Array(
+    tensorstore::ElementPointer<void>(static_cast<void *>(buffer), store.dtype()), size, tensorstore::c_order));
+
+  // Measured by the thread which completes the chunk, and read once the chunk is ready
+  struct ChunkMeasurements
+  {
+    std::atomic<int64_t>      end{ 0 }; // of the fetch or of the tensorstore read
+    OMEZarrNGFFReadStatistics statistics;
+  };
+  struct Chunk
+  {
+    std::vector<tensorstore::Index>    cell;
+    std::vector<tensorstore::Index>    first; // of the intersection of the chunk with the box
+    std::vector<tensorstore::Index>    intersectionSize;
+    tensorstore::Future<bool>          decoded; // block-wise, false when the chunk is missing
+    tensorstore::Future<void>          read;    // through tensorstore
+    int64_t                            start;   // microseconds, see TraceWriter::Now
+    std::shared_ptr<ChunkMeasurements> measurements;
+  };
+  std::deque<Chunk> inFlight;
+  uint64_t          completed = 0;
+  absl::Status      status;
+  bool              aborted = false;
+
+  const auto pollAbort = [&]() { aborted = aborted || (progress.isAborted && progress.isAborted()); };
+  const auto readThroughTensorstore = [&](Chunk & chunk) {
+    std::vector<tensorstore::Index> inBox(rank);
+    for (size_t d = 0; d < rank; ++d)
+    {
+      inBox[d] = chunk.first[d] - start[d];
+    }
+    auto target = array | tensorstore::AllDims().SizedInterval(inBox, chunk.intersectionSize);
+    if (!target.ok())
+    {
+      status.Update(target.status());
+      return;
+    }
+    chunk.start = TraceWriter::Now();
+    chunk.read = tensorstore::Read(store | tensorstore::AllDims().SizedInterval(chunk.first, chunk.intersectionSize),
+                                   *target);
+    chunk.read.ExecuteWhenReady([measurements = chunk.measurements](tensorstore::ReadyFuture<void>) {
+      measurements->end.store(TraceWriter::Now());
+    });
+  };
+  const auto completeFirst = [&]() {
+    Chunk chunk = std::move(inFlight.front());
+    inFlight.pop_front();
+    nlohmann::json traceArgs;
+    if (progress.trace)
+    {
+      traceArgs = { { "chunk", makeChunkKey(chunk.cell, chunkKeySeparator) } };
+    }
+
+    // The futures are awaited even after a cancellation, as they write into the buffer
+    if (!chunk.decoded.null())
+    {
+      while (!chunk.decoded.WaitFor(absl::Milliseconds(20)))
+      {
+        pollAbort();
+      }
+      statistics += chunk.measurements->statistics;
+      const auto & result = chunk.decoded.result();
+      if (!result.ok() && status.ok())
+      {
+        status = result.status();
+      }
+      if (result.ok() && !*result && status.ok() && !aborted)
+      {
+        readThroughTensorstore(chunk);
+      }
+    }
+    if (!chunk.read.null())
+    {
+      while (!chunk.read.WaitFor(absl::Milliseconds(20)))
+      {
+        pollAbort();
+      }
+      const auto & result = chunk.read.result();
+      if (!result.ok() && status.ok())
+      {
+        status = result.status();
+      }
+      if (progress.trace)
+      {
+        const int64_t end = chunk.measurements->end.load();
+        progress.trace->AsyncSpan(
+          progress.traceName, "chunk", chunk.start, end > 0 ? end : TraceWriter::Now(), traceArgs);
+      }
+    }
+    ++completed;
+    if (progress.report && status.ok() && !aborted)
+    {
+      progress.report(static_cast<float>(completed) / numberOfChunks);
+    }
+  };
+
+  forEachChunk(start, size, chunkShape, [&](const std::vector<tensorstore::Index> & cell) {
+    pollAbort();
+    if (aborted || !status.ok())
+    {
+      return; // skip the remaining chunks
+    }
+
+    // The intersection of the chunk with the box, relative to the chunk and to the buffer
+    Chunk chunk{ cell, std::vector<tensorstore::Index>(rank), std::vector<tensorstore::Index>(rank) };
+    chunk.measurements = std::make_shared<ChunkMeasurements>();
+    std::vector<tensorstore::Index> inChunk(rank);
+    size_t                          bufferOffset = 0;
+    bool                            covered = true;
+    for (size_t d = 0; d < rank; ++d)
+    {
+      const tensorstore::Index chunkStart = cell[d] * chunkShape[d];
+      const tensorstore::Index chunkEnd = std::min(chunkStart + chunkShape[d], shape[d]);
+      chunk.first[d] = std::max(start[d], chunkStart);
+      chunk.intersectionSize[d] = std::min(start[d] + size[d], chunkEnd) - chunk.first[d];
+      inChunk[d] = chunk.first[d] - chunkStart;
+      bufferOffset += (chunk.first[d] - start[d]) * bufferStrides[d];
+      covered = covered && chunk.first[d] == chunkStart && chunk.first[d] + chunk.intersectionSize[d] == chunkEnd;
+    }
+
+    if (covered)
+    {
+      readThroughTensorstore(chunk);
+    }
+    else
+    {
+      // Decoded by the thread which completes the fetch. Exceptions do not cross tensorstore, so they become errors.
+      chunk.start = TraceWriter::Now();
+      const std::string key = makeChunkKey(cell, chunkKeySeparator);
+      chunk.decoded = tensorstore::MapFutureValue(
+        tensorstore::InlineExecutor{},
+        [&chunkShape,
+         &bufferStrides,
+         &progress,
+         itemSize,
+         key,
+         inChunk,
+         intersectionSize = chunk.intersectionSize,
+         destination = buffer + bufferOffset,
+         fetchStart = chunk.start,
+         measurementsPointer = chunk.measurements](
+          const tensorstore::kvstore::ReadResult & result) -> tensorstore::Result<bool> {
+          ChunkMeasurements & measurements = *measurementsPointer;
+          const int64_t       fetchEnd = TraceWriter::Now();
+          measurements.end.store(fetchEnd);
+          measurements.statistics.fetchSeconds += (fetchEnd - fetchStart) / 1.0e6;
+          nlohmann::json traceArgs;
+          if (progress.trace)
+          {
+            traceArgs = { { "chunk", key } };
+            nlohmann::json fetchArgs = traceArgs;
+            fetchArgs["bytes"] = result.has_value() ? result.value.size() : 0;
+            progress.trace->AsyncSpan("fetch chunk", "chunk", fetchStart, fetchEnd, fetchArgs);
+          }
+          if (!result.has_value())
+          {
+            return false;
+          }
+          try
+          {
+            absl::Cord frame = result.value;
+            measurements.statistics.bytesFetched += frame.size();
+            decodeOverlappingBlocks(frame.Flatten(),
+                                    chunkShape,
+                                    inChunk,
+                                    intersectionSize,
+                                    itemSize,
+                                    destination,
+                                    bufferStrides,
+                                    measurements.statistics,
+                                    progress.trace.get(),
+                                    traceArgs);
+          }
+          catch (const ExceptionObject & e)
+          {
+            return absl::DataLossError(e.GetDescription());
+          }
+          catch (const std::exception & e)
+          {
+            return absl::InternalError(e.what());
+          }
+          ++measurements.statistics.chunksDecodedBlockwise;
+          return true;
+        },
+        tensorstore::kvstore::Read(kvstore, key));
     }
+    inFlight.push_back(std::move(chunk));
+    while (inFlight.size() >= MaximumChunkOperationsInFlight)
+    {
+      completeFirst();
+    }
+  });
+  while (!inFlight.empty())
+  {
+    completeFirst();
+  }
+
+  if (aborted)
+  {
+    throw ProcessAborted(__FILE__, __LINE__);
+  }
+  if (!status.ok())
+  {
+    itkGenericExceptionMacro("tensorstore error: " << status);
+  }
+}
+
+template <typename TPixel>
+void
+ReadFromStore(const tensorstore::TensorStore<> & store,
+              const ImageIORegion &              storeIORegion,
+              TPixel *                           buffer,
+              const ChunkProgress &              progress)
+{
+  // Read a requested voxel region, which may be the entire available voxel region.
+  // We cannot infer axis permutations by matching requested axis sizes.
+  // Therefore we assume that tensorstore axes are in "C-style" order
+  // with the last index as the fastest moving axis, aka "z,y,x" order,
+  // and must inverted to match ITK's "Fortran-style" order of axis indices
+  // with the first index as the fastest moving axis, aka "x,y,z" order.
+  // "C-style" is generally the default layout for new tensorstore arrays.
+  // Refer to https://google.github.io/tensorstore/driver/zarr/index.html#json-driver/zarr.metadata.order
+  //
+  // In the future this may be extended to permute axes based on
+  // OME-Zarr NGFF axis labels.
+  const auto                      dimension = store.rank();
+  std::vector<tensorstore::Index> indices(dimension);
+  std::vector<tensorstore::Index> sizes(dimension);
+  for (size_t dim = 0; dim < dimension; ++dim)
+  {
+    // Input IO region is assumed to already be reversed from ITK requested region
+    // to match assumed C-style Zarr storage
+    indices[dim] = storeIORegion.GetIndex(dim);
+    sizes[dim] = storeIORegion.GetSize(dim);
+  }
+
+  // The region is read chunk by chunk, so that progress can be reported and the read cancelled.
+  // Each chunk is still fetched and decoded only once.
+  auto arr = tensorstore::UnownedToShared(tensorstore::Array(buffer, sizes, tensorstore::c_order));
+  runChunkOperations(
+    indices,
+    sizes,
+    getChunkShape(store),
+    [&](const std::vector<tensorstore::Index> & chunkStart, const std::vector<tensorstore::Index> & chunkSize) {
+      std::vector<tensorstore::Index> bufferStart(dimension);
+      for (size_t dim = 0; dim < dimension; ++dim)
+      {
+        bufferStart[dim] = chunkStart[dim] - indices[dim];
+      }
+      auto target = arr | tensorstore::AllDims().SizedInterval(bufferStart, chunkSize);
+      if (!target.ok())
+      {
+        itkGenericExceptionMacro("tensorstore error: " << target.status());
+      }
+      return tensorstore::Read(store | tensorstore::AllDims().SizedInterval(chunkStart, chunkSize), *target);
+    },
+    progress);
+}
+
+// Reads from the store if the specified pixel type and the ITK component type match.
+template <typename TPixel>
+bool
+ReadFromStoreIfTypesMatch(const IOComponentEnum              componentType,
+                          const tensorstore::TensorStore<> & store,
+                          const ImageIORegion &              storeIORegion,
+                          void *                             buffer,
+                          const ChunkProgress &              progress)
+{
+  if (tensorstoreToITKComponentType(tensorstore::dtype_v<TPixel>) == componentType)
+  {
+    ReadFromStore(store, storeIORegion, static_cast<TPixel *>(buffer), progress);
     return true;
   }
-  catch (...)
+  return false;
+}
+
+// Tries to read from the specified store, trying any of the specified pixel types.
+template <typename... TPixel>
+bool
+TryToReadFromStore(TypeList<TPixel...>,
+                   const IOComponentEnum              componentType,
+                   const tensorstore::TensorStore<> & store,
+                   const ImageIORegion &              storeIORegion,
+                   void *                             buffer,
+                   const ChunkProgress &              progress)
+{
+  return (ReadFromStoreIfTypesMatch<TPixel>(componentType, store, storeIORegion, buffer, progress) || ...);
+}
+
+// Writes to the store if the specified pixel type and the ITK component type match.
+// When `createStore` is set, the array is (re)created with `arrayMetadata` (all but the dtype) before writing,
+// and with the constraints of `chunkLayout` (a tensorstore chunk layout, if not null) on its chunk shape.
+// The buffer holds the voxels of `storeIORegion`, given in C-style store order.
+// When `pendingWrites` is provided, this returns as soon as the buffer has been copied,
+// and the future for the outstanding compression and storage is appended to `pendingWrites`.
+template <typename TPixel>
+bool
+WriteToStoreIfTypesMatch(const IOComponentEnum                    componentType,
+                         tensorstore::TensorStore<> &             store,
+                         tensorstore::Context &                   tsContext,
+                         const std::string &                      fileName,
+                         const std::string &                      path,
+                         const nlohmann::json &                   arrayMetadata,
+                         const nlohmann::json &                   chunkLayout,
+                         const bool                               createStore,
+                         const ImageIORegion &                    storeIORegion,
+                         const void * const                       buffer,
+                         std::vector<tensorstore::Future<void>> * pendingWrites,
+                         const ChunkProgress &                    progress)
+{
+  if (tensorstoreToITKComponentType(tensorstore::dtype_v<TPixel>) == componentType)
+  {
+    if (createStore)
+    {
+      std::string dtype;
+      // we prefer to write using our own endianness, so no conversion is necessary
+      if (ByteSwapper<int>::SystemIsBigEndian())
+      {
+        dtype = ">";
+      }
+      else
+      {
+        dtype = "<";
+      }
+
+      if (sizeof(TPixel) == 1)
+      {
+        dtype = "|";
+      }
+      if (std::numeric_limits<TPixel>::is_integer)
+      {
+        if (std::numeric_limits<TPixel>::is_signed)
+        {
+          dtype += 'i';
+        }
+        else
+        {
+          dtype += 'u';
+        }
+      }
+      else
+      {
+        dtype += 'f';
+      }
+      dtype += std::to_string(sizeof(TPixel));
+
+      nlohmann::json metadata = arrayMetadata;
+      metadata["dtype"] = dtype;
+      nlohmann::json createSpec = {
+        { "driver", "zarr" },
+        { "kvstore", { { "driver", getKVstoreWriteDriver(fileName) }, { "path", fileName + "/" + path } } },
+        { "metadata", metadata },
+      };
+      if (!chunkLayout.is_null())
+      {
+        createSpec["schema"] = { { "chunk_layout", chunkLayout } };
+      }
+      auto openFuture = tensorstore::Open(
+        createSpec,
+        tsContext,
+        tensorstore::OpenMode::create | tensorstore::OpenMode::delete_existing,
+        tensorstore::ReadWriteMode::read_write);
+      TS_EVAL_CHECK(openFuture);
+      store = openFuture.value();
+    }
+
+    const auto                      dimension = store.rank();
+    std::vector<tensorstore::Index> indices(dimension);
+    std::vector<tensorstore::Index> sizes(dimension);
+    for (size_t dim = 0; dim < dimension; ++dim)
+    {
+      indices[dim] = storeIORegion.GetIndex(dim);
+      sizes[dim] = storeIORegion.GetSize(dim);
+    }
+
+    auto * p = static_cast<TPixel const *>(buffer);
+    auto   arr = tensorstore::UnownedToShared(tensorstore::Array(p, sizes, tensorstore::c_order));
+    runChunkOperations(
+      indices,
+      sizes,
+      getChunkShape(store),
+      [&](const std::vector<tensorstore::Index> & chunkStart, const std::vector<tensorstore::Index> & chunkSize) {
+        std::vector<tensorstore::Index> bufferStart(dimension);
+        for (size_t dim = 0; dim < dimension; ++dim)
+        {
+          bufferStart[dim] = chunkStart[dim] - indices[dim];
+        }
+        auto source = arr | tensorstore::AllDims().SizedInterval(bufferStart, chunkSize);
+        if (!source.ok())
+        {
+          itkGenericExceptionMacro("tensorstore error: " << source.status());
+        }
+        auto writeFutures =
+          tensorstore::Write(*source, store | tensorstore::AllDims().SizedInterval(chunkStart, chunkSize));
+        if (pendingWrites != nullptr)
+        {
+          // The caller may reuse its buffer once the data has been copied,
+          // while compression and storage continue in the background.
+          pendingWrites->push_back(writeFutures.commit_future);
+          return writeFutures.copy_future;
+        }
+        return writeFutures.commit_future;
+      },
+      progress);
+    return true;
+  }
+  return false;
+}
+
+// Tries to write to the specified store, trying any of the specified pixel types.
+template <typename... TPixel>
+bool
+TryToWriteToStore(TypeList<TPixel...>,
+                  const IOComponentEnum                    componentType,
+                  tensorstore::TensorStore<> &             store,
+                  tensorstore::Context &                   tsContext,
+                  const std::string &                      fileName,
+                  const std::string &                      path,
+                  const nlohmann::json &                   arrayMetadata,
+                  const nlohmann::json &                   chunkLayout,
+                  const bool                               createStore,
+                  const ImageIORegion &                    storeIORegion,
+                  const void * const                       buffer,
+                  std::vector<tensorstore::Future<void>> * pendingWrites,
+                  const ChunkProgress &                    progress)
+{
+  return (WriteToStoreIfTypesMatch<TPixel>(componentType,
+                                           store,
+                                           tsContext,
+                                           fileName,
+                                           path,
+                                           arrayMetadata,
+                                           chunkLayout,
+                                           createStore,
+                                           storeIORegion,
+                                           buffer,
+                                           pendingWrites,
+                                           progress) ||
+          ...);
+}
+
+constexpr unsigned numberOfHistogramBins = 256;
+
+// Running intensity statistics of one channel, over the stream divisions written so far.
+// The histogram covers the range of the pixels seen so far, and is rebinned when that range grows.
+struct ChannelAccumulator
+{
+  uint64_t              count = 0;
+  double                minimum = std::numeric_limits<double>::infinity();
+  double                maximum = -std::numeric_limits<double>::infinity();
+  double                sum = 0.0;
+  std::vector<uint64_t> histogram = std::vector<uint64_t>(numberOfHistogramBins, 0);
+
+  unsigned
+  Bin(const double value) const
+  {
+    if (maximum <= minimum)
+    {
+      return 0;
+    }
+    const double position = (value - minimum) / (maximum - minimum) * numberOfHistogramBins;
+    return std::min(static_cast<unsigned>(std::max(position, 0.0)), numberOfHistogramBins - 1);
+  }
+
+  // Moves the counts of each bin to the bin of its centre in the new range
+  void
+  ExpandRange(const double newMinimum, const double newMaximum)
+  {
+    std::vector<uint64_t> previous(numberOfHistogramBins, 0);
+    previous.swap(histogram);
+    const double previousMinimum = minimum;
+    const double previousWidth = (maximum - minimum) / numberOfHistogramBins;
+    minimum = newMinimum;
+    maximum = newMaximum;
+    for (unsigned b = 0; b < numberOfHistogramBins; ++b)
+    {
+      if (previous[b] > 0)
+      {
+        histogram[this->Bin(previousMinimum + (b + 0.5) * previousWidth)] += previous[b];
+      }
+    }
+  }
+
+  template <typename TPixel>
+  void
+  Add(const TPixel * pixels, const size_t numberOfPixels)
+  {
+    double blockMinimum = std::numeric_limits<double>::infinity();
+    double blockMaximum = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < numberOfPixels; ++i)
+    {
+      const auto value = static_cast<double>(pixels[i]);
+      if (!std::isnan(value))
+      {
+        blockMinimum = std::min(blockMinimum, value);
+        blockMaximum = std::max(blockMaximum, value);
+        sum += value;
+        ++count;
+      }
+    }
+    if (blockMinimum > blockMaximum)
+    {
+      return; // no pixels, or all of them NaN
+    }
+    if (minimum > maximum) // first pixels
+    {
+      minimum = blockMinimum;
+      maximum = blockMaximum;
+    }
+    else if (blockMinimum < minimum || blockMaximum > maximum)
+    {
+      this->ExpandRange(std::min(minimum, blockMinimum), std::max(maximum, blockMaximum));
+    }
+    for (size_t i = 0; i < numberOfPixels; ++i)
+    {
+      const auto value = static_cast<double>(pixels[i]);
+      if (!std::isnan(value))
+      {
+        ++histogram[this->Bin(value)];
+      }
+    }
+  }
+
+  OMEZarrNGFFChannelStatistics
+  Finalize() const
+  {
+    OMEZarrNGFFChannelStatistics statistics;
+    statistics.count = count;
+    statistics.histogram = histogram;
+    if (count == 0)
+    {
+      return statistics;
+    }
+    statistics.minimum = minimum;
+    statistics.maximum = maximum;
+    statistics.mean = sum / count;
+    statistics.histogramMinimum = minimum;
+    statistics.histogramMaximum = maximum;
+
+    // The display window spans the 0.1 to 99.9 percentiles, to the resolution of the histogram
+    const double binWidth = (maximum - minimum) / numberOfHistogramBins;
+    uint64_t     cumulative = 0;
+    bool         startFound = false;
+    statistics.windowEnd = maximum;
+    for (unsigned b = 0; b < numberOfHistogramBins; ++b)
+    {
+      cumulative += histogram[b];
+      if (!startFound && cumulative > 0.001 * count)
+      {
+        statistics.windowStart = minimum + b * binWidth;
+        startFound = true;
+      }
+      if (cumulative >= 0.999 * count)
+      {
+        statistics.windowEnd = std::min(maximum, minimum + (b + 1) * binWidth);
+        break;
+      }
+    }
+    return statistics;
+  }
+};
+
+// Adds consecutive blocks of pixels in the buffer to the accumulators of their channels,
+// if the specified pixel type and the ITK component type match. Blocks without an accumulator are skipped.
+template <typename TPixel>
+bool
+AccumulateIfTypesMatch(const IOComponentEnum                     componentType,
+                       const void *                              buffer,
+                       const size_t                              blockSize,
+                       const std::vector<ChannelAccumulator *> & blockAccumulators)
+{
+  if (tensorstoreToITKComponentType(tensorstore::dtype_v<TPixel>) == componentType)
+  {
+    for (size_t block = 0; block < blockAccumulators.size(); ++block)
+    {
+      if (blockAccumulators[block] != nullptr)
+      {
+        blockAccumulators[block]->Add(static_cast<const TPixel *>(buffer) + block * blockSize, blockSize);
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+// Tries to accumulate channel statistics, trying any of the specified pixel types.
+template <typename... TPixel>
+bool
+TryToAccumulate(TypeList<TPixel...>,
+                const IOComponentEnum                     componentType,
+                const void *                              buffer,
+                const size_t                              blockSize,
+                const std::vector<ChannelAccumulator *> & blockAccumulators)
+{
+  return (AccumulateIfTypesMatch<TPixel>(componentType, buffer, blockSize, blockAccumulators) || ...);
+}
+
+// Adds a contiguous block of pixels to `statistics`. The pixels are split into independent lanes
+// whose partial results are combined at the end, so that the loops vectorize. Integer pixels
+// of up to 16 bits are summed exactly in 64 bit integers. NaN pixels are skipped without branching.
+template <typename TPixel>
+void
+ReduceBlock(const TPixel * pixels, const size_t numberOfPixels, OMEZarrNGFFRegionStatistics & statistics)
+{
+  using SumType = std::conditional_t<std::is_integral_v<TPixel> && sizeof(TPixel) <= 2, int64_t, double>;
+  using Limits = std::numeric_limits<TPixel>;
+  constexpr size_t lanes = 8;
+  constexpr auto   highest = static_cast<TPixel>(Limits::has_infinity ? Limits::infinity() : Limits::max());
+  constexpr auto   lowest = static_cast<TPixel>(Limits::has_infinity ? -Limits::infinity() : Limits::lowest());
+
+  TPixel   minimum[lanes];
+  TPixel   maximum[lanes];
+  SumType  sum[lanes] = {};
+  SumType  sumOfSquares[lanes] = {};
+  uint64_t count[lanes] = {};
+  std::fill_n(minimum, lanes, highest);
+  std::fill_n(maximum, lanes, lowest);
+
+  const auto reduce = [&](const size_t lane, const TPixel value) {
+    // Comparisons with NaN are false, so NaN leaves the minimum and maximum unchanged
+    minimum[lane] = value < minimum[lane] ? value : minimum[lane];
+    maximum[lane] = value > maximum[lane] ? value : maximum[lane];
+    const bool isNumber = !std::is_floating_point_v<TPixel> || value == value;
+    const auto term = isNumber ? static_cast<SumType>(value) : SumType{ 0 };
+    sum[lane] += term;
+    sumOfSquares[lane] += term * term;
+    count[lane] += isNumber;
+  };
+  size_t i = 0;
+  for (; i + lanes <= numberOfPixels; i += lanes)
+  {
+    for (size_t lane = 0; lane < lanes; ++lane)
+    {
+      reduce(lane, pixels[i + lane]);
+    }
+  }
+  for (; i < numberOfPixels; ++i)
+  {
+    reduce(0, pixels[i]);
+  }
+
+  for (size_t lane = 0; lane < lanes; ++lane)
+  {
+    if (count[lane] > 0)
+    {
+      statistics.minimum = std::min(statistics.minimum, static_cast<double>(minimum[lane]));
+      statistics.maximum = std::max(statistics.maximum, static_cast<double>(maximum[lane]));
+    }
+    statistics.sum += static_cast<double>(sum[lane]);
+    statistics.sumOfSquares += static_cast<double>(sumOfSquares[lane]);
+    statistics.count += count[lane];
+  }
+
+  if (!statistics.histogram.empty())
+  {
+    const double scale = statistics.histogram.size() / (statistics.histogramMaximum - statistics.histogramMinimum);
+    const double lastBin = statistics.histogram.size() - 1;
+    uint64_t *   bins = statistics.histogram.data();
+    for (i = 0; i < numberOfPixels; ++i)
+    {
+      const auto value = static_cast<double>(pixels[i]);
+      if (value == value)
+      {
+        ++bins[static_cast<size_t>(std::clamp((value - statistics.histogramMinimum) * scale, 0.0, lastBin))];
+      }
+    }
+  }
+}
+
+// Reduces the box [start, start + size) of the store chunk by chunk. Each work unit reads
+// one chunk at a time into its own buffer and reduces it into its own partial statistics.
+template <typename TPixel>
+void
+ReduceStore(const tensorstore::TensorStore<> &      store,
+            const std::vector<tensorstore::Index> & start,
+            const std::vector<tensorstore::Index> & size,
+            const unsigned                          numberOfThreads,
+            OMEZarrNGFFRegionStatistics &           statistics)
+{
+  const auto   chunkShape = getChunkShape(store);
+  const size_t rank = start.size();
+
+  // Chunks are numbered in C order over the grid cells intersecting the box
+  std::vector<tensorstore::Index> firstCell(rank);
+  std::vector<tensorstore::Index> gridShape(rank);
+  uint64_t                        numberOfChunks = 1;
+  size_t                          chunkPixels = 1;
+  for (size_t d = 0; d < rank; ++d)
+  {
+    firstCell[d] = start[d] / chunkShape[d];
+    gridShape[d] = size[d] > 0 ? (start[d] + size[d] - 1) / chunkShape[d] - firstCell[d] + 1 : 0;
+    numberOfChunks *= gridShape[d];
+    chunkPixels *= std::min(chunkShape[d], size[d]);
+  }
+
+  std::atomic<uint64_t> nextChunk{ 0 };
+  std::atomic<bool>     failed{ false };
+  std::mutex            mutex;
+  std::string           error;
+  const auto            work = [&](OMEZarrNGFFRegionStatistics & partial) {
+    std::vector<TPixel>             buffer(chunkPixels);
+    std::vector<tensorstore::Index> chunkStart(rank);
+    std::vector<tensorstore::Index> chunkSize(rank);
+    try
+    {
+      for (uint64_t chunk = nextChunk++; chunk < numberOfChunks && !failed; chunk = nextChunk++)
+      {
+        uint64_t remainder = chunk;
+        for (size_t d = rank; d > 0; --d)
+        {
+          const tensorstore::Index cell = firstCell[d - 1] + remainder % gridShape[d - 1];
+          remainder /= gridShape[d - 1];
+          chunkStart[d - 1] = std::max(start[d - 1], cell * chunkShape[d - 1]);
+          chunkSize[d - 1] = std::min(start[d - 1] + size[d - 1], (cell + 1) * chunkShape[d - 1]) - chunkStart[d - 1];
+        }
+        auto target = tensorstore::UnownedToShared(tensorstore::Array(buffer.data(), chunkSize, tensorstore::c_order));
+        TS_EVAL_CHECK(tensorstore::Read(store | tensorstore::AllDims().SizedInterval(chunkStart, chunkSize), target));
+        ReduceBlock(buffer.data(), target.num_elements(), partial);
+      }
+    }
+    catch (const std::exception & e)
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      if (!failed.exchange(true))
+      {
+        error = e.what();
+      }
+    }
+  };
+
+  // Each work unit pulls chunks until none are left, reducing them into its own partial statistics
+  const unsigned workUnits = std::max(1u, std::min<unsigned>(numberOfThreads, numberOfChunks));
+
+  std::vector<OMEZarrNGFFRegionStatistics> partials(workUnits, statistics);
+  auto                                     multiThreader = MultiThreaderBase::New();
+  multiThreader->SetNumberOfWorkUnits(workUnits);
+  multiThreader->ParallelizeArray(
+    0, workUnits, [&](const SizeValueType workUnit) { work(partials[workUnit]); }, nullptr);
+  if (failed)
+  {
+    itkGenericExceptionMacro(<< error);
+  }
+  for (const auto & partial : partials)
+  {
+    statistics += partial;
+  }
+}
+
+// Reduces the store if the specified pixel type and the ITK component type match.
+template <typename TPixel>
+bool
+ReduceStoreIfTypesMatch(const IOComponentEnum                   componentType,
+                        const tensorstore::TensorStore<> &      store,
+                        const std::vector<tensorstore::Index> & start,
+                        const std::vector<tensorstore::Index> & size,
+                        const unsigned                          numberOfThreads,
+                        OMEZarrNGFFRegionStatistics &           statistics)
+{
+  if (tensorstoreToITKComponentType(tensorstore::dtype_v<TPixel>) == componentType)
+  {
+    ReduceStore<TPixel>(store, start, size, numberOfThreads, statistics);
+    return true;
+  }
+  return false;
+}
+
+// Tries to reduce the store, trying any of the specified pixel types.
+template <typename... TPixel>
+bool
+TryToReduceStore(TypeList<TPixel...>,
+                 const IOComponentEnum                   componentType,
+                 const tensorstore::TensorStore<> &      store,
+                 const std::vector<tensorstore::Index> & start,
+                 const std::vector<tensorstore::Index> & size,
+                 const unsigned                          numberOfThreads,
+                 OMEZarrNGFFRegionStatistics &           statistics)
+{
+  return (ReduceStoreIfTypesMatch<TPixel>(componentType, store, start, size, numberOfThreads, statistics) || ...);
+}
+
+// The sum and the number of the pixels other than NaN projected onto an output pixel, for Mean.
+struct MeanAccumulator
+{
+  double   sum = 0.0;
+  uint64_t count = 0;
+};
+
+// Projects the box [start, start + size) of the store along store axis `axis` into `output`,
+// a C-order buffer of the box with that axis collapsed to size 1. The pixels are combined
+// into accumulators starting at `initialValue`, which `finish` converts into output pixels.
+// The columns of chunks along the axis are distributed over the work units, so each output pixel
+// is written by one work unit. Within a chunk, the pixels combined into a row of output pixels
+// are contiguous, so the loop vectorizes.
+template <typename TPixel, typename TAccumulator, typename TOutput, typename TCombine, typename TFinish>
+void
+ProjectStore(const tensorstore::TensorStore<> &      store,
+             const std::vector<tensorstore::Index> & start,
+             const std::vector<tensorstore::Index> & size,
+             const size_t                            axis,
+             const TAccumulator                      initialValue,
+             TCombine                                combine,
+             TFinish                                 finish,
+             TOutput *                               output,
+             const unsigned                          numberOfThreads)
+{
+  const auto   chunkShape = getChunkShape(store);
+  const size_t rank = start.size();
+
+  std::vector<tensorstore::Index> firstCell(rank);
+  std::vector<tensorstore::Index> lastCell(rank);
+  std::vector<tensorstore::Index> outputStrides(rank);
+  uint64_t                        numberOfColumns = 1;
+  size_t                          chunkPixels = 1;
+  size_t                          tilePixels = 1;
+  for (size_t d = rank; d > 0; --d)
+  {
+    if (size[d - 1] <= 0)
+    {
+      return;
+    }
+    firstCell[d - 1] = start[d - 1] / chunkShape[d - 1];
+    lastCell[d - 1] = (start[d - 1] + size[d - 1] - 1) / chunkShape[d - 1];
+    outputStrides[d - 1] = d == rank ? 1 : outputStrides[d] * (d == axis ? 1 : size[d]);
+    chunkPixels *= std::min(chunkShape[d - 1], size[d - 1]);
+    if (d - 1 != axis)
+    {
+      numberOfColumns *= lastCell[d - 1] - firstCell[d - 1] + 1;
+      tilePixels *= std::min(chunkShape[d - 1], size[d - 1]);
+    }
+  }
+
+  std::atomic<uint64_t> nextColumn{ 0 };
+  std::atomic<bool>     failed{ false };
+  std::mutex            mutex;
+  std::string           error;
+  const auto            work = [&]() {
+    std::vector<TPixel>             chunk(chunkPixels);
+    std::vector<TAccumulator>       tile(tilePixels);
+    std::vector<tensorstore::Index> chunkStart(rank);
+    std::vector<tensorstore::Index> chunkSize(rank);
+    try
+    {
+      for (uint64_t column = nextColumn++; column < numberOfColumns && !failed; column = nextColumn++)
+      {
+        uint64_t remainder = column;
+        for (size_t d = rank; d > 0; --d)
+        {
+          if (d - 1 == axis)
+          {
+            continue;
+          }
+          const tensorstore::Index gridSize = lastCell[d - 1] - firstCell[d - 1] + 1;
+          const tensorstore::Index cell = firstCell[d - 1] + static_cast<tensorstore::Index>(remainder % gridSize);
+          remainder /= gridSize;
+          chunkStart[d - 1] = std::max(start[d - 1], cell * chunkShape[d - 1]);
+          chunkSize[d - 1] = std::min(start[d - 1] + size[d - 1], (cell + 1) * chunkShape[d - 1]) - chunkStart[d - 1];
+        }
+
+        // Combine the chunks of the column into the tile
+        size_t outer = 1;
+        size_t inner = 1;
+        for (size_t d = 0; d < rank; ++d)
+        {
+          (d < axis ? outer : inner) *= d == axis ? 1 : chunkSize[d];
+        }
+        std::fill_n(tile.begin(), outer * inner, initialValue);
+        for (tensorstore::Index cell = firstCell[axis]; cell <= lastCell[axis]; ++cell)
+        {
+          chunkStart[axis] = std::max(start[axis], cell * chunkShape[axis]);
+          chunkSize[axis] = std::min(start[axis] + size[axis], (cell + 1) * chunkShape[axis]) - chunkStart[axis];
+          auto target = tensorstore::UnownedToShared(tensorstore::Array(chunk.data(), chunkSize, tensorstore::c_order));
+          TS_EVAL_CHECK(tensorstore::Read(store | tensorstore::AllDims().SizedInterval(chunkStart, chunkSize), target));
+          for (size_t o = 0; o < outer; ++o)
+          {
+            TAccumulator * row = tile.data() + o * inner;
+            for (tensorstore::Index k = 0; k < chunkSize[axis]; ++k)
+            {
+              const TPixel * pixels = chunk.data() + (o * chunkSize[axis] + k) * inner;
+              for (size_t i = 0; i < inner; ++i)
+              {
+                row[i] = combine(row[i], pixels[i]);
+              }
+            }
+          }
+        }
+
+        // Copy the rows of the tile along the last axis into the output
+        const size_t rowLength = axis == rank - 1 ? 1 : chunkSize[rank - 1];
+        for (size_t first = 0; first < outer * inner; first += rowLength)
+        {
+          size_t offset = 0;
+          size_t position = first;
+          for (size_t d = rank; d > 0; --d)
+          {
+            const size_t extent = d - 1 == axis ? 1 : chunkSize[d - 1];
+            const size_t index = position % extent;
+            position /= extent;
+            if (d - 1 != axis)
+            {
+              offset += (chunkStart[d - 1] - start[d - 1] + index) * outputStrides[d - 1];
+            }
+          }
+          std::transform(tile.data() + first, tile.data() + first + rowLength, output + offset, finish);
+        }
+      }
+    }
+    catch (const std::exception & e)
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      if (!failed.exchange(true))
+      {
+        error = e.what();
+      }
+    }
+  };
+
+  // Each work unit pulls columns until none are left
+  const unsigned workUnits = std::max(1u, std::min<unsigned>(numberOfThreads, numberOfColumns));
+  auto           multiThreader = MultiThreaderBase::New();
+  multiThreader->SetNumberOfWorkUnits(workUnits);
+  multiThreader->ParallelizeArray(
+    0, workUnits, [&work](SizeValueType) { work(); }, nullptr);
+  if (failed)
+  {
+    itkGenericExceptionMacro(<< error);
+  }
+}
+
+// Projects the store if the specified pixel type and the ITK component type match.
+template <typename TPixel>
+bool
+ProjectStoreIfTypesMatch(const IOComponentEnum                     componentType,
+                         const tensorstore::TensorStore<> &        store,
+                         const std::vector<tensorstore::Index> &   start,
+                         const std::vector<tensorstore::Index> &   size,
+                         const size_t                              axis,
+                         const OMEZarrNGFFImageIOEnums::Projection projection,
+                         void *                                    buffer,
+                         const unsigned                            numberOfThreads)
+{
+  if (tensorstoreToITKComponentType(tensorstore::dtype_v<TPixel>) != componentType)
+  {
+    return false;
+  }
+  using Limits = std::numeric_limits<TPixel>;
+  const auto identity = [](const TPixel value) { return value; };
+  switch (projection)
+  {
+    case OMEZarrNGFFImageIOEnums::Projection::Maximum:
+      ProjectStore<TPixel>(store,
+                           start,
+                           size,
+                           axis,
+                           static_cast<TPixel>(Limits::has_infinity ? -Limits::infinity() : Limits::lowest()),
+                           [](const TPixel a, const TPixel b) { return b > a ? b : a; },
+                           identity,
+                           static_cast<TPixel *>(buffer),
+                           numberOfThreads);
+      break;
+    case OMEZarrNGFFImageIOEnums::Projection::Minimum:
+      ProjectStore<TPixel>(store,
+                           start,
+                           size,
+                           axis,
+                           static_cast<TPixel>(Limits::has_infinity ? Limits::infinity() : Limits::max()),
+                           [](const TPixel a, const TPixel b) { return b < a ? b : a; },
+                           identity,
+                           static_cast<TPixel *>(buffer),
+                           numberOfThreads);
+      break;
+    case OMEZarrNGFFImageIOEnums::Projection::Mean:
+      ProjectStore<TPixel>(
+        store,
+        start,
+        size,
+        axis,
+        MeanAccumulator{},
+        [](const MeanAccumulator a, const TPixel b) {
+          const auto value = static_cast<double>(b);
+          return value == value ? MeanAccumulator{ a.sum + value, a.count + 1 } : a;
+        },
+        [](const MeanAccumulator a) {
+          return a.count > 0 ? a.sum / a.count : std::numeric_limits<double>::quiet_NaN();
+        },
+        static_cast<double *>(buffer),
+        numberOfThreads);
+      break;
+    default:
+      ProjectStore<TPixel>(
+        store,
+        start,
+        size,
+        axis,
+        0.0,
+        [](const double a, const TPixel b) {
+          const auto value = static_cast<double>(b);
+          return value == value ? a + value : a;
+        },
+        [](const double a) { return a; },
+        static_cast<double *>(buffer),
+        numberOfThreads);
+  }
+  return true;
+}
+
+// Tries to project the store, trying any of the specified pixel types.
+template <typename... TPixel>
+bool
+TryToProjectStore(TypeList<TPixel...>,
+                  const IOComponentEnum                     componentType,
+                  const tensorstore::TensorStore<> &        store,
+                  const std::vector<tensorstore::Index> &   start,
+                  const std::vector<tensorstore::Index> &   size,
+                  const size_t                              axis,
+                  const OMEZarrNGFFImageIOEnums::Projection projection,
+                  void *                                    buffer,
+                  const unsigned                            numberOfThreads)
+{
+  return (ProjectStoreIfTypesMatch<TPixel>(
+            componentType, store, start, size, axis, projection, buffer, numberOfThreads) ||
+          ...);
+}
+
+// Update an existing "read" specification for an "http" driver to retrieve remote files.
+// Note that an "http" driver specification may operate on an HTTP or HTTPS connection.
+void
+MakeKVStoreHTTPDriverSpec(nlohmann::json & spec, const std::string & fullPath)
+{
+  // Decompose path into a base URL and reference subpath according to TensorStore HTTP KVStore driver spec
+  // https://google.github.io/tensorstore/kvstore/http/index.html
+  spec["kvstore"] = { { "driver", "http" } };
+
+  // Naively decompose the URL into "base" and "resource" components.
+  // Generally assumes that the spec will only be used once to access a specific resource.
+  // For example, the URL "http://localhost/path/to/resource.json" will be split
+  // into components "http://localhost/path/to" and "resource.json".
+  //
+  // Could be revisited for a better root "base_url" at the top level allowing acces
+  // to multiple subpaths. For instance, decomposing the example above into
+  // "http://localhost/" and "path/to/resource.json" would allow for a given HTTP spec
+  // to be more easily reused with different subpaths.
+  //
+  spec["kvstore"]["base_url"] = fullPath.substr(0, fullPath.find_last_of("/"));
+  spec["kvstore"]["path"] = fullPath.substr(fullPath.find_last_of("/") + 1);
+}
+
+// JSON file path, e.g. "C:/Dev/ITKIOOMEZarrNGFF/v0.4/cyx.ome.zarr/.zgroup"
+void
+writeJson(nlohmann::json json, std::string path, std::string driver, tensorstore::Context& tsContext)
+{
+  auto attrs_store = tensorstore::Open<nlohmann::json, 0>(
+                       { { "driver", "json" }, { "kvstore", { { "driver", driver }, { "path", path } } } },
+                       tsContext,
+                       tensorstore::OpenMode::create | tensorstore::OpenMode::delete_existing,
+                       tensorstore::ReadWriteMode::read_write)
+                       .result()
+                       .value();
+  auto writeFuture = tensorstore::Write(tensorstore::MakeScalarArray(json), attrs_store); // preferably pretty-print
+
+  auto result = writeFuture.result();
+  if (!result.ok())
+  {
+    itkGenericExceptionMacro(<< "There was an error writing metadata to file '" << path
+                             << ". Error details: " << result.status());
+  }
+}
+
+// JSON file path, e.g. "C:/Dev/ITKIOOMEZarrNGFF/v0.4/cyx.ome.zarr/.zattrs"
+bool
+jsonRead(const std::string path, nlohmann::json & result, std::string driver, tensorstore::Context& tsContext)
+{
+  // Reading JSON via TensorStore allows it to be in the cloud
+  nlohmann::json readSpec = { { "driver", "json" }, { "kvstore", { { "driver", driver }, { "path", path } } } };
+  if (driver == "http")
+  {
+    MakeKVStoreHTTPDriverSpec(readSpec, path);
+  }
+
+  auto attrs_store = tensorstore::Open<nlohmann::json, 0>(readSpec, tsContext).result().value();
+
+  auto attrs_array_result = tensorstore::Read(attrs_store).result();
+
+  nlohmann::json attrs;
+  if (attrs_array_result.ok())
+  {
+    result = attrs_array_result.value()();
+    return true;
+  }
+  else if (absl::IsNotFound(attrs_array_result.status()))
+  {
+    result = nlohmann::json::object_t();
+    return false;
+  }
+  else // another error
+  {
+    result = nlohmann::json::object_t();
+    return false;
+  }
+}
+
+// Like jsonRead, for several JSON files whose reads run concurrently.
+// Files which cannot be read give empty objects.
+std::vector<nlohmann::json>
+jsonReadConcurrently(const std::vector<std::string> & paths,
+                     const std::string &              driver,
+                     tensorstore::Context &           tsContext)
+{
+  using OpenFuture = decltype(tensorstore::Open<nlohmann::json, 0>(nlohmann::json{}, tsContext));
+  std::vector<OpenFuture> opens;
+  for (const auto & path : paths)
+  {
+    nlohmann::json readSpec = { { "driver", "json" }, { "kvstore", { { "driver", driver }, { "path", path } } } };
+    if (driver == "http")
+    {
+      MakeKVStoreHTTPDriverSpec(readSpec, path);
+    }
+    opens.push_back(tensorstore::Open<nlohmann::json, 0>(readSpec, tsContext));
+  }
+
+  using ReadFuture = decltype(tensorstore::Read(opens.front().value()));
+  std::vector<ReadFuture> reads;
+  for (auto & open : opens)
+  {
+    reads.push_back(open.result().ok() ? tensorstore::Read(open.value()) : ReadFuture{});
+  }
+
+  std::vector<nlohmann::json> results(paths.size(), nlohmann::json::object_t());
+  for (size_t k = 0; k < reads.size(); ++k)
+  {
+    if (!reads[k].null() && reads[k].result().ok())
+    {
+      results[k] = reads[k].value()();
+    }
+  }
+  return results;
+}
+
+// Fields of view of the high-content screening plate or well at `fileName`, whose attributes are `attributes`.
+// The attributes of the wells of a plate are read concurrently.
+std::vector<OMEZarrNGFFField>
+discoverFields(const std::string &    fileName,
+               const nlohmann::json & attributes,
+               const std::string &    driver,
+               tensorstore::Context & tsContext)
+{
+  std::vector<OMEZarrNGFFField> wells; // with the path of the well
+  std::vector<nlohmann::json>   wellAttributes;
+  if (attributes.contains("well"))
+  {
+    wells.emplace_back();
+    wellAttributes.push_back(attributes);
+  }
+  else
+  {
+    const auto &             plate = attributes.at("plate");
+    std::vector<std::string> wellPaths;
+    for (const auto & wellJson : plate.at("wells"))
+    {
+      OMEZarrNGFFField well;
+      well.path = wellJson.at("path").get<std::string>();
+      if (wellJson.contains("rowIndex") && wellJson.contains("columnIndex"))
+      {
+        well.row = plate.at("rows").at(wellJson.at("rowIndex").get<size_t>()).at("name").get<std::string>();
+        well.column = plate.at("columns").at(wellJson.at("columnIndex").get<size_t>()).at("name").get<std::string>();
+      }
+      else // before 0.4, the path of a well is "row/column"
+      {
+        const size_t separator = well.path.find('/');
+        well.row = well.path.substr(0, separator);
+        well.column = separator == std::string::npos ? std::string() : well.path.substr(separator + 1);
+      }
+      wells.push_back(well);
+      wellPaths.push_back(fileName + "/" + well.path + "/.zattrs");
+    }
+    wellAttributes = jsonReadConcurrently(wellPaths, driver, tsContext);
+  }
+
+  std::vector<OMEZarrNGFFField> fields;
+  for (size_t k = 0; k < wells.size(); ++k)
+  {
+    if (!wellAttributes[k].contains("well"))
+    {
+      itkGenericExceptionMacro(<< "Failed to read the metadata of well '" << wells[k].path << "' of " << fileName);
+    }
+    for (const auto & imageJson : wellAttributes[k].at("well").at("images"))
+    {
+      OMEZarrNGFFField field = wells[k];
+      const auto       imagePath = imageJson.at("path").get<std::string>();
+      field.path = wells[k].path.empty() ? imagePath : wells[k].path + "/" + imagePath;
+      field.acquisition = imageJson.value("acquisition", -1);
+      fields.push_back(field);
+    }
+  }
+  return fields;
+}
+
+// Parses the "axes" of a multiscales image into ITK (Fortran-style) order.
+OMEZarrNGFFImageIO::AxesCollectionType
+parseAxes(const nlohmann::json & axesJson)
+{
+  OMEZarrNGFFImageIO::AxesCollectionType axes(axesJson.size());
+  auto                                   targetIt = axes.rbegin();
+  for (const auto & axis : axesJson)
+  {
+    *targetIt = (OMEZarrNGFFAxis{ axis.at("name"), axis.at("type"), (axis.contains("unit") ? axis.at("unit") : "") });
+    ++targetIt;
+  }
+  itkAssertOrThrowMacro(targetIt == axes.rend(), "Internal error: failed to fully parse axes from OME-Zarr metadata");
+  return axes;
+}
+
+// Applies the scale and the optional translation in `ct` to the spacing and origin, which are in ITK order.
+void
+applyCoordinateTransformations(const nlohmann::json & ct,
+                               std::vector<double> &  spacing,
+                               std::vector<double> &  origin,
+                               const std::string &    fileName)
+{
+  itkAssertOrThrowMacro(ct.is_array(), "Failed to parse coordinate transforms");
+  itkAssertOrThrowMacro(ct.size() >= 1, "Expected at least one coordinate transform");
+  itkAssertOrThrowMacro(ct[0].at("type") == "scale",
+                        ("Expected first transform to be \"scale\" but found " +
+                         std::string(ct[0].at("type")))); // first transformation must be scale
+
+  nlohmann::json s = ct[0].at("scale");
+  itkAssertOrThrowMacro(s.is_array(), "Failed to parse scale transform");
+  unsigned dim = s.size();
+  itkAssertOrThrowMacro(dim == spacing.size(), "Found dimension mismatch in scale transform");
+
+  for (unsigned d = 0; d < dim; ++d)
+  {
+    double dS = s[dim - d - 1].get<double>(); // reverse indices KJI into IJK
+    spacing[d] *= dS;
+    origin[d] *= dS; // TODO: should we update origin like this?
+  }
+
+  if (ct.size() > 1) // there is also a translation
+  {
+    itkAssertOrThrowMacro(ct[1].at("type") == "translation",
+                          ("Expected second transform to be \"translation\" but found " +
+                           std::string(ct[1].at("type")))); // first transformation must be scale
+    nlohmann::json tr = ct[1].at("translation");
+    itkAssertOrThrowMacro(tr.is_array(), "Failed to parse translation transform");
+    dim = tr.size();
+    itkAssertOrThrowMacro(dim == origin.size(), "Found dimension mismatch in translation transform");
+
+    for (unsigned d = 0; d < dim; ++d)
+    {
+      double dOrigin = tr[dim - d - 1].get<double>(); // reverse indices KJI into IJK
+      origin[d] += dOrigin;
+    }
+  }
+
+  if (ct.size() > 2)
+  {
+    itkGenericOutputMacro(<< "A sequence of more than 2 transformations is specified in '" << fileName
+                          << "'. This is currently not supported. Extra transformations are ignored.");
+  }
+}
+
+void
+addCoordinateTransformations(OMEZarrNGFFImageIO * io, nlohmann::json ct)
+{
+  std::vector<double> spacing(io->GetNumberOfDimensions());
+  std::vector<double> origin(io->GetNumberOfDimensions());
+  for (unsigned d = 0; d < io->GetNumberOfDimensions(); ++d)
+  {
+    spacing[d] = io->GetSpacing(d);
+    origin[d] = io->GetOrigin(d);
+  }
+  applyCoordinateTransformations(ct, spacing, origin, io->GetFileName());
+  for (unsigned d = 0; d < io->GetNumberOfDimensions(); ++d)
+  {
+    io->SetSpacing(d, spacing[d]);
+    io->SetOrigin(d, origin[d]);
+  }
+}
+
+// Crops the geometry of a dataset to `region` of its spatial axes.
+OMEZarrNGFFDatasetGeometry
+cropGeometry(OMEZarrNGFFDatasetGeometry geometry, const ImageIORegion & region)
+{
+  geometry.size.resize(region.GetImageDimension());
+  geometry.spacing.resize(region.GetImageDimension());
+  geometry.origin.resize(region.GetImageDimension());
+  geometry.chunkSize.resize(region.GetImageDimension());
+  for (unsigned d = 0; d < region.GetImageDimension(); ++d)
+  {
+    geometry.size[d] = region.GetSize(d);
+    geometry.origin[d] += region.GetIndex(d) * geometry.spacing[d];
+  }
+  return geometry;
+}
+
+} // namespace
+
+struct OMEZarrNGFFImageIO::TensorStoreData
+{
+  tensorstore::Context       tsContext{ tensorstore::Context::Default() };
+  tensorstore::TensorStore<> store{};
+
+  // Array opened by the most recent Write, reused by later stream divisions of the same array.
+  // It is identified by the write mode which opened it, its file name, dataset, data type and shape
+  // (when created by Write), which are empty when none is open.
+  tensorstore::TensorStore<>             writeStore{};
+  OMEZarrNGFFImageIOEnums::WriteMode     writeStoreMode{ OMEZarrNGFFImageIOEnums::WriteMode::Overwrite };
+  std::string                            writeStoreFileName{};
+  std::string                            writeStorePath{}; // of the array in the store
+  unsigned                               writeStoreDatasetIndex = 0;
+  tensorstore::DataType                  writeStoreDType{};
+  std::vector<int64_t>                   writeStoreShape{}; // in store order
+  std::vector<tensorstore::Future<void>> pendingWrites{};
+
+  void
+  ClearWriteStore()
+  {
+    writeStoreMode = OMEZarrNGFFImageIOEnums::WriteMode::Overwrite;
+    writeStoreFileName.clear();
+    writeStorePath.clear();
+    writeStoreDatasetIndex = 0;
+    writeStoreDType = tensorstore::DataType{};
+    writeStoreShape.clear();
+  }
+
+  // Zip archive streamed by Write. Encoded chunks and metadata are staged in memory
+  // until no later stream division can modify them, and then appended to the archive.
+  std::unique_ptr<OMEZarrNGFFZipStreamWriter> zipWriter{};
+  tensorstore::KvStore                        zipStaging{};
+  std::set<std::string>                       zipStagedKeys{}; // relative to the archive root
+
+  // In-memory zip archive written through the "zip_memory" driver, which is closed by FinalizeWrite
+  bool zipMemoryArchiveOpen = false;
+
+  // Trace event writer, when tracing is enabled
+  std::shared_ptr<TraceWriter> trace{};
+
+  // Channel statistics of the store being written. Its .zattrs is written
+  // after the last stream division, once the statistics are complete.
+  std::vector<ChannelAccumulator> channelAccumulators{};
+  std::string                     groupAttributesFileName{}; // of the store whose .zattrs is pending
+
+  // All datasets (resolution levels) of the image opened by ReadImageInformation.
+  // Their geometry is parsed along with the selected dataset, and their arrays are opened when first used.
+  struct Dataset
+  {
+    std::string                path;
+    std::string                driver;
+    std::vector<double>        spacing; // ITK order
+    std::vector<double>        origin;
+    tensorstore::TensorStore<> store;
+    std::string                chunkKeySeparator; // when blocks of its chunks can be decoded, see PartialChunkDecoding
+  };
+  std::vector<Dataset> datasets{};
+  std::mutex           datasetsMutex{};
+
+  // Chunks decoded from their blosc frames by reads, which may run concurrently
+  std::atomic<SizeValueType> chunksDecodedBlockwise{ 0 };
+
+  // Multiscales group of the datasets, which is a field of a plate or well
+  std::string imagePath{};
+
+  // Arrays of the other fields of a plate or well, by field index and dataset index, opened on first use
+  std::map<std::pair<unsigned, unsigned>, tensorstore::TensorStore<>> fieldStores{};
+
+  // Staleness bound of the metadata and chunks of the arrays opened for reading, which is the time
+  // of the last recheck in follow mode. Otherwise what was read once is assumed not to change.
+  tensorstore::RecheckCached            recheck{ false };
+  std::chrono::steady_clock::time_point lastRecheck{};
+
+  // Context of the arrays opened for reading, which adds a chunk cache to tsContext when read-ahead is enabled.
+  // It is kept while the cache size is unchanged, so reopening an array keeps the chunks read ahead.
+  tensorstore::Context readContext{ tsContext };
+  SizeValueType        readContextCacheSize = 0;
+
+  // Sequential access detected across Read calls, and the chunk layers along its axis, from the one
+  // being read onwards, which were read (with a null future) or requested in the background
+  struct ReadAheadState
+  {
+    std::string                                          path{};  // of the array
+    std::vector<tensorstore::Index>                      start{}; // of the previous Read, in store order
+    std::vector<tensorstore::Index>                      size{};
+    int                                                  axis = -1; // store axis of the sequential access, if any
+    int                                                  direction = 0;
+    std::map<tensorstore::Index, tensorstore::AnyFuture> layers{};
+  };
+  ReadAheadState readAhead{};
+
+  const tensorstore::TensorStore<> &
+  OpenDataset(const unsigned datasetIndex)
+  {
+    tensorstore::Future<tensorstore::TensorStore<>> openFuture;
+    {
+      // The open is only issued under the lock, so that reads of other datasets are not held up
+      const std::lock_guard<std::mutex> lock(datasetsMutex);
+      if (datasetIndex >= datasets.size())
+      {
+        itkGenericExceptionMacro(<< "Dataset index " << datasetIndex << " is out of range for the "
+                                 << datasets.size() << " datasets of the image");
+      }
+      const Dataset & dataset = datasets[datasetIndex];
+      if (dataset.store.valid())
+      {
+        return dataset.store;
+      }
+      nlohmann::json readSpec = { { "driver", "zarr" },
+                                  { "kvstore", { { "driver", dataset.driver }, { "path", dataset.path } } } };
+      if (dataset.driver == "http")
+      {
+        MakeKVStoreHTTPDriverSpec(readSpec, dataset.path);
+      }
+      openFuture = tensorstore::Open(
+        readSpec, readContext, tensorstore::OpenMode::open, recheck, tensorstore::ReadWriteMode::read);
+    }
+
+    TS_EVAL_CHECK(openFuture);
+    const tensorstore::TensorStore<> store = openFuture.value();
+    const std::string                chunkKeySeparator = getPartiallyDecodableChunkKeySeparator(store);
+
+    // Another reader may have opened the same dataset meanwhile, whose array is kept
+    const std::lock_guard<std::mutex> lock(datasetsMutex);
+    Dataset &                         dataset = datasets[datasetIndex];
+    if (!dataset.store.valid())
+    {
+      dataset.store = store;
+      dataset.chunkKeySeparator = chunkKeySeparator;
+    }
+    return dataset.store;
+  }
+
+  // The arrays of dataset `datasetIndex` of the fields at `fieldPaths` (relative to `fileName`),
+  // with the opens of those not yet open running concurrently
+  std::vector<tensorstore::TensorStore<>>
+  OpenFieldDatasets(const std::string &              fileName,
+                    const std::vector<unsigned> &    fieldIndices,
+                    const std::vector<std::string> & fieldPaths,
+                    const unsigned                   datasetIndex)
+  {
+    std::vector<tensorstore::TensorStore<>>                      stores(fieldIndices.size());
+    std::vector<tensorstore::Future<tensorstore::TensorStore<>>> opens(fieldIndices.size());
+    {
+      // The opens are only issued under the lock, so that reads of other fields and datasets are not held up
+      const std::lock_guard<std::mutex> lock(datasetsMutex);
+      const Dataset &                   dataset = datasets[datasetIndex];
+      const std::string                 datasetPath = dataset.path.substr(imagePath.size()); // with a leading "/"
+      for (size_t k = 0; k < fieldIndices.size(); ++k)
+      {
+        const auto found = fieldStores.find({ fieldIndices[k], datasetIndex });
+        if (found != fieldStores.end())
+        {
+          stores[k] = found->second;
+          continue;
+        }
+        const std::string path = fileName + "/" + fieldPaths[k] + datasetPath;
+        nlohmann::json    readSpec = { { "driver", "zarr" },
+                                    { "kvstore", { { "driver", dataset.driver }, { "path", path } } } };
+        if (dataset.driver == "http")
+        {
+          MakeKVStoreHTTPDriverSpec(readSpec, path);
+        }
+        opens[k] = tensorstore::Open(
+          readSpec, readContext, tensorstore::OpenMode::open, recheck, tensorstore::ReadWriteMode::read);
+      }
+    }
+
+    bool anyOpened = false;
+    for (size_t k = 0; k < fieldIndices.size(); ++k)
+    {
+      if (!opens[k].null())
+      {
+        TS_EVAL_CHECK(opens[k]);
+        stores[k] = opens[k].value();
+        anyOpened = true;
+      }
+    }
+    if (anyOpened)
+    {
+      // Another reader may have opened the same field meanwhile, whose array is kept
+      const std::lock_guard<std::mutex> lock(datasetsMutex);
+      for (size_t k = 0; k < fieldIndices.size(); ++k)
+      {
+        if (!opens[k].null())
+        {
+          stores[k] = fieldStores.emplace(std::make_pair(fieldIndices[k], datasetIndex), stores[k]).first->second;
+        }
+      }
+    }
+    return stores;
+  }
+};
+
+OMEZarrNGFFImageIO::OMEZarrNGFFImageIO()
+  : m_TensorStoreData(std::make_unique<TensorStoreData>())
+{
+  this->AddSupportedWriteExtension(".zarr");
+  this->AddSupportedWriteExtension(".zr2");
+  this->AddSupportedWriteExtension(".zr3");
+  this->AddSupportedWriteExtension(".zip");
+  this->AddSupportedWriteExtension(".memory");
+
+  this->AddSupportedReadExtension(".zarr");
+  this->AddSupportedReadExtension(".zr2");
+  this->AddSupportedReadExtension(".zr3");
+  this->AddSupportedReadExtension(".zip");
+  this->AddSupportedWriteExtension(".memory");
+
+  this->Self::SetCompressor("");
+  this->Self::SetMaximumCompressionLevel(9);
+  this->Self::SetCompressionLevel(2);
+
+  std::string traceFileName;
+  if (itksys::SystemTools::GetEnv("ITK_OMEZARRNGFF_TRACE", traceFileName))
+  {
+    try
+    {
+      this->SetTraceFileName(traceFileName);
+    }
+    catch (const ExceptionObject & e)
+    {
+      itkWarningMacro(<< "Tracing is disabled: " << e.GetDescription());
+    }
+  }
+}
+
+OMEZarrNGFFImageIO::~OMEZarrNGFFImageIO()
+{
+  try
+  {
+    this->FinalizeWrite();
+  }
+  catch (const ExceptionObject & e)
+  {
+    itkWarningMacro(<< "Failed to complete pending writes: " << e.GetDescription());
+  }
+  if (m_TensorStoreData->trace)
+  {
+    m_TensorStoreData->trace->Flush();
+  }
+  this->SetProgressSource(nullptr); // its DeleteEvent must not reach this IO any more
+}
+
+void
+OMEZarrNGFFImageIO::SetProgressSource(ProcessObject * source)
+{
+  if (source == m_ProgressSource.GetPointer())
+  {
+    return;
+  }
+  if (m_ProgressSource)
+  {
+    m_ProgressSource->RemoveObserver(m_ProgressSourceDeleteTag);
+  }
+  m_ProgressSource = source;
+  if (source != nullptr)
+  {
+    auto forget = SimpleMemberCommand<Self>::New();
+    forget->SetCallbackFunction(this, &Self::ForgetProgressSource);
+    m_ProgressSourceDeleteTag = source->AddObserver(DeleteEvent(), forget);
+  }
+  this->Modified();
+}
+
+void
+OMEZarrNGFFImageIO::SetTraceFileName(const std::string & traceFileName)
+{
+  if (traceFileName != m_TraceFileName)
+  {
+    m_TensorStoreData->trace = traceFileName.empty() ? nullptr : TraceWriter::ForFile(traceFileName);
+    m_TraceFileName = traceFileName;
+    this->Modified();
+  }
+}
+
+
+void
+OMEZarrNGFFImageIO::InternalSetCompressor(const std::string & _compressor)
+{
+  std::string compressor = _compressor;
+  std::transform(compressor.begin(), compressor.end(), compressor.begin(), ::toupper);
+  if (compressor.empty() || compressor == "BLOSC" || compressor == "ZSTD" || compressor == "ZLIB" ||
+      compressor == "GZIP" || compressor == "BZ2" || compressor == "NONE")
+  {
+    return;
+  }
+  itkWarningMacro(<< "Unknown compressor: \"" << _compressor << "\". Using default blosc compression.");
+  this->SetCompressor("");
+}
+
+void
+OMEZarrNGFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "DatasetIndex: " << m_DatasetIndex << std::endl;
+  os << indent << "FieldIndex: " << m_FieldIndex << std::endl;
+  os << indent << "Fields: " << m_Fields.size() << std::endl;
+  os << indent << "TimeIndex: " << m_TimeIndex << std::endl;
+  os << indent << "ChannelIndex: " << m_ChannelIndex << std::endl;
+  os << indent << "AsynchronousWrite: " << (m_AsynchronousWrite ? "On" : "Off") << std::endl;
+  os << indent << "WriteMode: " << m_WriteMode << std::endl;
+  os << indent << "ReadAheadDepth: " << m_ReadAheadDepth << std::endl;
+  os << indent << "ReadAheadCacheSize: " << m_ReadAheadCacheSize << std::endl;
+  os << indent << "PartialChunkDecoding: " << (m_PartialChunkDecoding ? "On" : "Off") << std::endl;
+  os << indent << "Follow: " << (m_Follow ? "On" : "Off") << std::endl;
+  os << indent << "FollowInterval: " << m_FollowInterval << std::endl;
+  os << indent << "ComputeChannelStatistics: " << (m_ComputeChannelStatistics ? "On" : "Off") << std::endl;
+  os << indent << "ChannelStatistics: " << m_ChannelStatistics.size() << " channels" << std::endl;
+  os << indent << "ChunkSize: [";
+  for (size_t d = 0; d < m_ChunkSize.size(); ++d)
+  {
+    os << (d > 0 ? ", " : "") << m_ChunkSize[d];
+  }
+  os << "]" << std::endl;
+  os << indent << "TraceFileName: " << m_TraceFileName << std::endl;
+  os << indent << "LastReadStatistics: " << m_LastReadStatistics << std::endl;
+  os << indent << "CumulativeReadStatistics: " << m_CumulativeReadStatistics << std::endl;
+}
+
+bool
+OMEZarrNGFFImageIO::CanReadFile(const char * filename)
+{
+  try
+  {
+    std::string    driver = getKVstoreDriver(filename);
+    nlohmann::json json;
+    if (!jsonRead(std::string(filename) + "/.zgroup", json, driver, m_TensorStoreData->tsContext))
+    {
+      return false;
+    }
+    if (json.at("zarr_format").get<int>() != 2)
+    {
+      return false; // unsupported zarr format
+    }
+    if (!jsonRead(std::string(filename) + "/.zattrs", json, driver, m_TensorStoreData->tsContext))
+    {
+      return false;
+    }
+    if (json.contains("plate") || json.contains("well"))
+    {
+      return true; // high-content screening plate or well, whose fields are images
+    }
+    if (!json.at("multiscales").is_array())
+    {
+      return false; // multiscales attribute array must be present
+    }
+    return true;
+  }
+  catch (...)
+  {
+    return false;
+  }
+  // return this->HasSupportedWriteExtension(filename, true);
+}
+
+void
+OMEZarrNGFFImageIO::ReadArrayMetadata(std::string path, std::string driver)
+{
+  TraceSpan span(m_TensorStoreData->trace.get(), "ReadArrayMetadata", "metadata", { { "path", path } });
+  nlohmann::json readSpec = { { "driver", "zarr" }, { "kvstore", { { "driver", driver }, { "path", path } } } };
+  if (driver == "http")
+  {
+    MakeKVStoreHTTPDriverSpec(readSpec, path);
+  }
+
+  const SizeValueType cacheSize = m_ReadAheadDepth > 0 || m_Follow ? m_ReadAheadCacheSize : 0;
+  if (cacheSize == 0)
+  {
+    m_TensorStoreData->readContext = m_TensorStoreData->tsContext;
+  }
+  else if (cacheSize != m_TensorStoreData->readContextCacheSize)
+  {
+    auto contextSpec =
+      tensorstore::Context::Spec::FromJson({ { "cache_pool", { { "total_bytes_limit", cacheSize } } } });
+    if (!contextSpec.ok())
+    {
+      itkExceptionMacro("tensorstore error: " << contextSpec.status());
+    }
+    m_TensorStoreData->readContext = tensorstore::Context(*contextSpec, m_TensorStoreData->tsContext);
+    m_TensorStoreData->readAhead = {};
+  }
+  m_TensorStoreData->readContextCacheSize = cacheSize;
+  if (path != m_TensorStoreData->readAhead.path)
+  {
+    m_TensorStoreData->readAhead = {}; // cancels reads ahead in the previous array
+    m_TensorStoreData->readAhead.path = path;
+  }
+
+  m_TensorStoreData->recheck =
+    m_Follow ? tensorstore::RecheckCached{ absl::Now() } : tensorstore::RecheckCached{ false };
+  m_TensorStoreData->lastRecheck = std::chrono::steady_clock::now();
+  auto openFuture = tensorstore::Open(readSpec,
+                                      m_TensorStoreData->readContext,
+                                      tensorstore::OpenMode::open,
+                                      m_TensorStoreData->recheck,
+                                      tensorstore::ReadWriteMode::read);
+  TS_EVAL_CHECK(openFuture);
+  m_TensorStoreData->store = openFuture.value();
+  auto shape_span = m_TensorStoreData->store.domain().shape();
+
+  tensorstore::DataType dtype = m_TensorStoreData->store.dtype();
+  this->SetComponentType(tensorstoreToITKComponentType(dtype));
+
+  std::vector<int64_t> dims(shape_span.rbegin(), shape_span.rend()); // convert KJI into IJK
+
+  if (this->GetNumberOfDimensions() == 0) // reading version 0.2 or 0.1
+  {
+    this->InitializeIdentityMetadata(dims.size());
+  }
+  else
+  {
+    itkAssertOrThrowMacro(this->GetNumberOfDimensions() == dims.size(), "Found dimension mismatch in metadata");
+  }
+
+  for (unsigned d = 0; d < dims.size(); ++d)
+  {
+    this->SetDimensions(d, dims[d]);
+  }
+}
+
+ImageIORegion
+OMEZarrNGFFImageIO::ConfigureTensorstoreIORegion(const ImageIORegion & ioRegion) const
+{
+  // Only warned about here, as the overload at a given time point and channel may be called concurrently
+  for (const auto & axis : m_StoreAxes)
+  {
+    if (axis.name == "t" && m_TimeIndex == INVALID_INDEX)
+    {
+      itkWarningMacro(<< "The OME-Zarr store contains a time \"t\" axis but no time point has been specified. "
+                         "Reading along a time axis is not currently supported. Data will be read from the first "
+                         "available time point by default.");
+    }
+    else if (axis.name == "c" && m_ChannelIndex == INVALID_INDEX)
+    {
+      itkWarningMacro(<< "The OME-Zarr store contains a channel \"c\" axis but no channel index has been specified. "
+                         "Reading along a channel axis is not currently supported. Data will be read from the first "
+                         "available channel by default.");
+    }
+  }
+  return this->ConfigureTensorstoreIORegion(ioRegion, m_TimeIndex, m_ChannelIndex);
+}
+
+ImageIORegion
+OMEZarrNGFFImageIO::ConfigureTensorstoreIORegion(const ImageIORegion & ioRegion,
+                                                 const int             timeIndex,
+                                                 const int             channelIndex) const
+{
+  // Set up IO region to match known store dimensions
+  const auto    storeRank = m_StoreAxes.size();
+  ImageIORegion storeRegion(storeRank);
+  itkAssertOrThrowMacro(storeRegion.GetImageDimension(), storeRank);
+  auto storeAxes = this->GetAxesInStoreOrder();
+
+  for (size_t storeIndex = 0; storeIndex < storeRank; ++storeIndex)
+  {
+    auto axisName = storeAxes.at(storeIndex).name;
+
+    // Optionally slice time or channel indices
+    if (axisName == "t")
+    {
+      storeRegion.SetSize(storeIndex, 1);
+      storeRegion.SetIndex(storeIndex, timeIndex == INVALID_INDEX ? 0 : timeIndex);
+    }
+    else if (axisName == "c")
+    {
+      storeRegion.SetSize(storeIndex, 1);
+      storeRegion.SetIndex(storeIndex, channelIndex == INVALID_INDEX ? 0 : channelIndex);
+    }
+    // Set requested region on X/Y/Z axes
+    else if (axisName == "x")
+    {
+      itkAssertOrThrowMacro(ioRegion.GetImageDimension() >= 1, "Failed to read from \"x\" axis into ITK axis \"0\"");
+      storeRegion.SetSize(storeIndex, ioRegion.GetSize(0));
+      storeRegion.SetIndex(storeIndex, ioRegion.GetIndex(0));
+    }
+    else if (axisName == "y")
+    {
+      itkAssertOrThrowMacro(ioRegion.GetImageDimension() >= 2, "Failed to read from \"y\" axis into ITK axis \"1\"");
+      storeRegion.SetSize(storeIndex, ioRegion.GetSize(1));
+      storeRegion.SetIndex(storeIndex, ioRegion.GetIndex(1));
+    }
+    else if (axisName == "z")
+    {
+      itkAssertOrThrowMacro(ioRegion.GetImageDimension() >= 3, "Failed to read from \"z\" axis into ITK axis \"2\"");
+      storeRegion.SetSize(storeIndex, ioRegion.GetSize(2));
+      storeRegion.SetIndex(storeIndex, ioRegion.GetIndex(2));
+    }
+  }
+
+  return storeRegion;
+}
+
+void
+OMEZarrNGFFImageIO::ReadImageInformation()
+{
+  this->FinalizeWrite(); // the store might be the target of an earlier write
+  const auto openStart = std::chrono::steady_clock::now();
+  TraceWriter * trace = m_TensorStoreData->trace.get();
+  TraceSpan     span(trace, "ReadImageInformation", "metadata", { { "file", m_FileName } });
+
+  nlohmann::json json;
+  std::string    driver = getKVstoreDriver(this->GetFileName());
+  const auto     tracedJsonRead = [&](const std::string & path) {
+    TraceSpan jsonSpan(trace, "jsonRead", "metadata", { { "path", path } });
+    return jsonRead(path, json, driver, m_TensorStoreData->tsContext);
+  };
+
+  const std::string zgroupFilePath(std::string(this->GetFileName()) + "/.zgroup");
+  bool              status = tracedJsonRead(zgroupFilePath);
+  itkAssertOrThrowMacro(status, ("Failed to read from " + zgroupFilePath));
+  itkAssertOrThrowMacro(json.at("zarr_format").get<int>() == 2, "Only v2 zarr format is supported"); // only v2 for now
+
+  std::string zattrsFilePath(std::string(this->GetFileName()) + "/.zattrs");
+  status = tracedJsonRead(zattrsFilePath);
+  itkAssertOrThrowMacro(status, ("Failed to read from " + zattrsFilePath));
+
+  // A high-content screening plate or well holds one image per field of view
+  std::string imagePath = this->GetFileName();
+  m_Fields.clear();
+  if (json.contains("plate") || json.contains("well"))
+  {
+    {
+      TraceSpan fieldsSpan(trace, "discoverFields", "metadata", { { "file", m_FileName } });
+      m_Fields = discoverFields(m_FileName, json, driver, m_TensorStoreData->tsContext);
+    }
+    if (m_FieldIndex >= m_Fields.size())
+    {
+      itkExceptionMacro(<< "Requested FieldIndex of " << m_FieldIndex << " is out of range for the number of fields ("
+                        << m_Fields.size() << ") of the plate or well '" << m_FileName << "'");
+    }
+    imagePath += "/" + m_Fields[m_FieldIndex].path;
+    zattrsFilePath = imagePath + "/.zattrs";
+    status = tracedJsonRead(zattrsFilePath);
+    itkAssertOrThrowMacro(status, ("Failed to read from " + zattrsFilePath));
+  }
+
+  // Channel statistics are optional. Other writers may only provide the display window.
+  m_ChannelStatistics.clear();
+  if (json.contains("itk_channel_statistics"))
+  {
+    for (const auto & channel : json.at("itk_channel_statistics"))
+    {
+      OMEZarrNGFFChannelStatistics statistics;
+      statistics.minimum = channel.at("min").get<double>();
+      statistics.maximum = channel.at("max").get<double>();
+      statistics.mean = channel.at("mean").get<double>();
+      statistics.count = channel.at("count").get<uint64_t>();
+      statistics.histogramMinimum = channel.at("histogram").at("min").get<double>();
+      statistics.histogramMaximum = channel.at("histogram").at("max").get<double>();
+      statistics.histogram = channel.at("histogram").at("counts").get<std::vector<uint64_t>>();
+      m_ChannelStatistics.push_back(statistics);
+    }
+  }
+  if (json.contains("omero") && json.at("omero").contains("channels"))
+  {
+    const auto & channels = json.at("omero").at("channels");
+    m_ChannelStatistics.resize(std::max(m_ChannelStatistics.size(), channels.size()));
+    for (size_t c = 0; c < channels.size(); ++c)
+    {
+      if (!channels[c].contains("window"))
+      {
+        continue;
+      }
+      const auto & window = channels[c].at("window");
+      auto &       statistics = m_ChannelStatistics[c];
+      if (statistics.count == 0)
+      {
+        statistics.minimum = window.value("min", 0.0);
+        statistics.maximum = window.value("max", 0.0);
+      }
+      statistics.windowStart = window.value("start", statistics.minimum);
+      statistics.windowEnd = window.value("end", statistics.maximum);
+    }
+  }
+
+  json = json.at("multiscales")[0]; // multiscales must be present in OME-NGFF
+  auto version = json.at("version").get<std::string>();
+  if (version == "0.4" || version == "0.3" || version == "0.2" || version == "0.1")
+  {
+    // these are explicitly supported versions
+  }
+  else
+  {
+    std::string message = "OME-NGFF version " + version + " is not explicitly supported." +
+                          "\nImportant features might be ignored." + "\nSupported versions are 0.1 through 0.4.";
+    OutputWindowDisplayWarningText(message.c_str());
+  }
+
+  if (json.contains("axes")) // optional before 0.3
+  {
+    this->InitializeIdentityMetadata(json.at("axes").size());
+    m_StoreAxes = parseAxes(json.at("axes"));
+  }
+  else
+  {
+    if (version == "0.4")
+    {
+      itkExceptionMacro(<< "\"axes\" field is missing from OME-Zarr image metadata at " << zattrsFilePath);
+    }
+    this->SetNumberOfDimensions(0);
+  }
+
+  const nlohmann::json multiscaleTransformations =
+    json.contains("coordinateTransformations") ? json.at("coordinateTransformations") : nlohmann::json{};
+  if (!multiscaleTransformations.is_null()) // optional
+  {
+    addCoordinateTransformations(this, multiscaleTransformations); // dataset-level scaling
+  }
+  json = json.at("datasets");
+  const nlohmann::json datasetsJson = json;
+  if (this->GetDatasetIndex() >= json.size())
+  {
+    itkExceptionMacro(<< "Requested DatasetIndex of " << this->GetDatasetIndex()
+                      << " is out of range for the number of datasets (" << json.size()
+                      << ") which exist in OME-NGFF store '" << this->GetFileName() << "'");
+  }
+
+  json = json[this->GetDatasetIndex()];
+  if (json.contains("coordinateTransformations")) // optional for versions prior to 0.4
+  {
+    addCoordinateTransformations(this, json.at("coordinateTransformations")); // per-resolution scaling
+  }
+  else
+  {
+    if (version == "0.4")
+    {
+      itkExceptionMacro(<< "OME-NGFF v0.4 requires `coordinateTransformations` for each resolution level.");
+    }
+  }
+
+  // TODO: parse stuff from "metadata" object into metadata dictionary
+
+  ReadArrayMetadata(imagePath + "/" + json.at("path").get<std::string>(), driver);
+
+  m_TensorStoreData->imagePath = imagePath;
+  m_TensorStoreData->fieldStores.clear();
+  auto & datasets = m_TensorStoreData->datasets;
+  datasets.clear();
+  for (size_t datasetIndex = 0; datasetIndex < datasetsJson.size(); ++datasetIndex)
+  {
+    const auto &             datasetJson = datasetsJson[datasetIndex];
+    TensorStoreData::Dataset dataset;
+    dataset.path = imagePath + "/" + datasetJson.at("path").get<std::string>();
+    dataset.driver = driver;
+    dataset.spacing.assign(this->GetNumberOfDimensions(), 1.0);
+    dataset.origin.assign(this->GetNumberOfDimensions(), 0.0);
+    if (!multiscaleTransformations.is_null())
+    {
+      applyCoordinateTransformations(multiscaleTransformations, dataset.spacing, dataset.origin, m_FileName);
+    }
+    if (datasetJson.contains("coordinateTransformations"))
+    {
+      applyCoordinateTransformations(
+        datasetJson.at("coordinateTransformations"), dataset.spacing, dataset.origin, m_FileName);
+    }
+    if (datasetIndex == static_cast<size_t>(this->GetDatasetIndex()))
+    {
+      dataset.store = m_TensorStoreData->store;
+      dataset.chunkKeySeparator = getPartiallyDecodableChunkKeySeparator(dataset.store);
+    }
+    datasets.push_back(std::move(dataset));
+  }
+  m_PendingOpenSeconds += secondsSince(openStart);
+}
+
+void
+OMEZarrNGFFImageIO::Read(void * buffer)
+{
+  if (m_Follow && secondsSince(m_TensorStoreData->lastRecheck) >= m_FollowInterval)
+  {
+    this->Refresh();
+  }
+
+  // Use a proxy measure (voxel count) to determine whether we are reading
+  // the entire image or an image subregion.
+  // This comparison needs to be done carefully, we can compare 3D and 6D regions
+  if (this->GetLargestRegion().GetNumberOfPixels() == m_IORegion.GetNumberOfPixels())
+  {
+    itkAssertOrThrowMacro(m_TensorStoreData->store.domain().num_elements() == m_IORegion.GetNumberOfPixels(),
+                          "Detected mismatch between store size and size of largest possible region");
+  }
+  else
+  {
+    // Get a requested image subregion
+    itkAssertOrThrowMacro(this->GetNumberOfComponents() == 1,
+                          "Reading an image subregion is currently supported only for single channel images");
+  }
+  itkAssertOrThrowMacro(m_StoreAxes.size() == m_TensorStoreData->store.rank(),
+                        "Detected mismatch in axis count and store rank");
+  auto storeIORegion = this->ConfigureTensorstoreIORegion(m_IORegion);
+
+  if (this->GetDebug())
+  {
+    std::cout << "Preparing to read " << storeIORegion.GetNumberOfPixels() << " elements from tensorstore region "
+              << storeIORegion;
+  }
+
+  OMEZarrNGFFReadStatistics statistics;
+  statistics.openSeconds = m_PendingOpenSeconds;
+  statistics.chunksRequested = countChunks(storeIORegion, getChunkShape(m_TensorStoreData->store));
+  m_PendingOpenSeconds = 0.0;
+  if (m_ReadAheadDepth > 0)
+  {
+    this->ReadAhead(storeIORegion, statistics);
+  }
+
+  const auto          readStart = std::chrono::steady_clock::now();
+  const ChunkProgress progress = makeChunkProgress(this, m_TensorStoreData->trace, "read chunk");
+  {
+    TraceSpan             span(m_TensorStoreData->trace.get(), "Read", "io", { { "file", m_FileName } });
+    const auto &          datasets = m_TensorStoreData->datasets;
+    const std::string     chunkKeySeparator = static_cast<size_t>(this->GetDatasetIndex()) < datasets.size()
+                                                ? datasets[this->GetDatasetIndex()].chunkKeySeparator
+                                                : std::string();
+    const IOComponentEnum componentType{ this->GetComponentType() };
+    if (m_PartialChunkDecoding && !chunkKeySeparator.empty() && m_TensorStoreData->readContextCacheSize == 0 &&
+        coversPartOfAChunk(m_TensorStoreData->store, storeIORegion))
+    {
+      readDecodingOverlappingBlocks(m_TensorStoreData->store,
+                                    chunkKeySeparator,
+                                    storeIORegion,
+                                    static_cast<char *>(buffer),
+                                    progress,
+                                    statistics);
+      m_TensorStoreData->chunksDecodedBlockwise += statistics.chunksDecodedBlockwise;
+    }
+    else if (!TryToReadFromStore(
+               supportedPixelTypes, componentType, m_TensorStoreData->store, storeIORegion, buffer, progress))
+    {
+      itkExceptionMacro("Unsupported component type: " << GetComponentTypeAsString(componentType));
+    }
+  }
+  statistics.readSeconds = secondsSince(readStart);
+  this->UpdateReadStatistics(statistics);
+}
+
+void
+OMEZarrNGFFImageIO::ReadAhead(const ImageIORegion & storeIORegion, OMEZarrNGFFReadStatistics & statistics)
+{
+  auto &                             state = m_TensorStoreData->readAhead;
+  const tensorstore::TensorStore<> & store = m_TensorStoreData->store;
+  const size_t                       rank = storeIORegion.GetImageDimension();
+  std::vector<tensorstore::Index>    start(rank);
+  std::vector<tensorstore::Index>    size(rank);
+  for (size_t d = 0; d < rank; ++d)
+  {
+    start[d] = storeIORegion.GetIndex(d);
+    size[d] = storeIORegion.GetSize(d);
+  }
+
+  // The access is sequential when the region adjoins the previous one along one axis, and matches it along the others
+  int  axis = -1;
+  int  direction = 0;
+  bool sequential = state.start.size() == rank;
+  for (size_t d = 0; sequential && d < rank; ++d)
+  {
+    if (start[d] != state.start[d] || size[d] != state.size[d])
+    {
+      const int step = start[d] == state.start[d] + state.size[d] ? 1 : start[d] + size[d] == state.start[d] ? -1 : 0;
+      sequential = step != 0 && axis < 0;
+      axis = static_cast<int>(d);
+      direction = step;
+    }
+  }
+  if (!sequential)
+  {
+    axis = -1;
+    direction = 0;
+  }
+
+  // Layers of chunks along the axis, which is the unit of read-ahead
+  const auto chunkShape = getChunkShape(store);
+  const auto firstLayer = [&](const std::vector<tensorstore::Index> & regionStart) {
+    return regionStart[axis] / chunkShape[axis];
+  };
+  const auto lastLayer = [&](const std::vector<tensorstore::Index> & regionStart,
+                             const std::vector<tensorstore::Index> & regionSize) {
+    return (regionStart[axis] + regionSize[axis] - 1) / chunkShape[axis];
+  };
+  if (axis != state.axis || direction != state.direction)
+  {
+    state.layers.clear();
+    if (axis >= 0)
+    {
+      for (auto layer = firstLayer(state.start); layer <= lastLayer(state.start, state.size); ++layer)
+      {
+        state.layers.emplace(layer, tensorstore::AnyFuture{}); // their chunks were cached by the previous read
+      }
+    }
+  }
+  state.start = start;
+  state.size = size;
+  state.axis = axis;
+  state.direction = direction;
+  if (axis < 0)
+  {
+    return;
+  }
+
+  tensorstore::Index layerBytes = store.dtype().size() * chunkShape[axis];
+  uint64_t           chunksPerLayer = 1;
+  for (size_t d = 0; d < rank; ++d)
+  {
+    if (static_cast<int>(d) != axis)
+    {
+      const auto chunks = (start[d] + size[d] - 1) / chunkShape[d] - start[d] / chunkShape[d] + 1;
+      chunksPerLayer *= chunks;
+      layerBytes *= chunks * chunkShape[d];
+    }
+  }
+
+  // A layer hits when it was read before, or when its read ahead has completed.
+  // The read waits for a read ahead which is still pending, so that is a miss.
+  bool hit = true;
+  for (auto layer = firstLayer(start); layer <= lastLayer(start, size); ++layer)
+  {
+    const auto found = state.layers.find(layer);
+    const bool layerHit = found != state.layers.end() && (found->second.null() || found->second.ready());
+    if (found == state.layers.end())
+    {
+      state.layers.emplace(layer, tensorstore::AnyFuture{});
+    }
+    (layerHit ? statistics.cacheHits : statistics.cacheMisses) += chunksPerLayer;
+    hit = layerHit && hit;
+  }
+  ++(hit ? statistics.readAheadHits : statistics.readAheadMisses);
+
+  // The layers behind the sweep are not read again, and their reads ahead are no longer needed
+  if (direction > 0)
+  {
+    state.layers.erase(state.layers.begin(), state.layers.lower_bound(firstLayer(start)));
+  }
+  else
+  {
+    state.layers.erase(state.layers.upper_bound(lastLayer(start, size)), state.layers.end());
+  }
+
+  // The cache must hold the layers of this read as well as those read ahead.
+  // Reads ahead which failed are not reported, as the read which needs their chunks will fail too.
+  const auto depth = std::min<tensorstore::Index>(
+    m_ReadAheadDepth, static_cast<tensorstore::Index>(m_ReadAheadCacheSize) / layerBytes - 1);
+  tensorstore::Index pending = 0;
+  for (const auto & layer : state.layers)
+  {
+    pending += !layer.second.null() && !layer.second.ready() ? 1 : 0;
+  }
+
+  const tensorstore::Index extent = store.domain().shape()[axis];
+  const tensorstore::Index nearestLayer = direction > 0 ? lastLayer(start, size) : firstLayer(start);
+  for (tensorstore::Index k = 1; k <= depth && pending < depth; ++k)
   {
-    return false;
+    const tensorstore::Index layer = nearestLayer + direction * k;
+    if (layer < 0 || layer * chunkShape[axis] >= extent || state.layers.count(layer) > 0)
+    {
+      continue;
+    }
+    std::vector<tensorstore::Index> layerStart(start);
+    std::vector<tensorstore::Index> layerSize(size);
+    layerStart[axis] = layer * chunkShape[axis];
+    layerSize[axis] = std::min(chunkShape[axis], extent - layerStart[axis]);
+    state.layers.emplace(layer,
+                         tensorstore::Read(store | tensorstore::AllDims().SizedInterval(layerStart, layerSize)));
+    ++pending;
+    statistics.chunksReadAhead += chunksPerLayer;
   }
-  // return this->HasSupportedWriteExtension(filename, true);
 }
 
 void
-OMEZarrNGFFImageIO::ReadArrayMetadata(std::string path, std::string driver)
+OMEZarrNGFFImageIO::ReadRegion(const ImageIORegion & region,
+                               const int             timeIndex,
+                               const int             channelIndex,
+                               void *                buffer) const
 {
-  nlohmann::json readSpec = { { "driver", "zarr" }, { "kvstore", { { "driver", driver }, { "path", path } } } };
-  if (driver == "http")
+  itkAssertOrThrowMacro(m_TensorStoreData->store.valid(), "ReadImageInformation must be called before ReadRegion");
+  this->ReadDatasetRegion(this->GetDatasetIndex(), region, timeIndex, channelIndex, buffer);
+}
+
+bool
+OMEZarrNGFFImageIO::Refresh()
+{
+  itkAssertOrThrowMacro(m_TensorStoreData->store.valid(), "ReadImageInformation must be called before Refresh");
+  TraceSpan span(m_TensorStoreData->trace.get(), "Refresh", "metadata", { { "file", m_FileName } });
+
+  // Reopening an array with a new staleness bound rereads its metadata, and keeps its chunk cache
   {
-    MakeKVStoreHTTPDriverSpec(readSpec, path);
+    const std::lock_guard<std::mutex> lock(m_TensorStoreData->datasetsMutex);
+    m_TensorStoreData->recheck = tensorstore::RecheckCached{ absl::Now() };
+    m_TensorStoreData->lastRecheck = std::chrono::steady_clock::now();
+    for (auto & dataset : m_TensorStoreData->datasets)
+    {
+      dataset.store = {}; // reopened on first use
+    }
+    m_TensorStoreData->fieldStores.clear();
   }
+  m_TensorStoreData->store = m_TensorStoreData->OpenDataset(this->GetDatasetIndex());
 
-  auto openFuture = tensorstore::Open(readSpec,
-                                      m_TensorStoreData->tsContext,
-                                      tensorstore::OpenMode::open,
-                                      tensorstore::RecheckCached{ false },
-                                      tensorstore::ReadWriteMode::read);
-  TS_EVAL_CHECK(openFuture);
-  m_TensorStoreData->store = openFuture.value();
-  auto shape_span = m_TensorStoreData->store.domain().shape();
+  const auto shape = m_TensorStoreData->store.domain().shape();
+  itkAssertOrThrowMacro(static_cast<unsigned>(shape.size()) == this->GetNumberOfDimensions(),
+                        "Detected mismatch in axis count and store rank");
+  bool changed = false;
+  for (unsigned d = 0; d < this->GetNumberOfDimensions(); ++d)
+  {
+    const auto size = static_cast<SizeValueType>(shape[shape.size() - 1 - d]); // convert KJI into IJK
+    if (size != this->GetDimensions(d))
+    {
+      this->SetDimensions(d, size);
+      changed = true;
+    }
+  }
+  return changed;
+}
 
-  tensorstore::DataType dtype = m_TensorStoreData->store.dtype();
-  this->SetComponentType(tensorstoreToITKComponentType(dtype));
+unsigned
+OMEZarrNGFFImageIO::GetNumberOfDatasets() const
+{
+  return m_TensorStoreData->datasets.size();
+}
 
-  std::vector<int64_t> dims(shape_span.rbegin(), shape_span.rend()); // convert KJI into IJK
+OMEZarrNGFFDatasetGeometry
+OMEZarrNGFFImageIO::GetDatasetGeometry(const unsigned datasetIndex) const
+{
+  const auto & store = m_TensorStoreData->OpenDataset(datasetIndex);
+  const auto & dataset = m_TensorStoreData->datasets[datasetIndex];
+  const auto   shape = store.domain().shape();
 
-  if (this->GetNumberOfDimensions() == 0) // reading version 0.2 or 0.1
+  OMEZarrNGFFDatasetGeometry geometry;
+  geometry.path = dataset.path.substr(m_TensorStoreData->imagePath.size() + 1);
+  geometry.size.assign(shape.rbegin(), shape.rend()); // convert KJI into IJK
+  geometry.spacing = dataset.spacing;
+  geometry.origin = dataset.origin;
+  const auto chunkShape = getChunkShape(store);
+  geometry.chunkSize.assign(chunkShape.rbegin(), chunkShape.rend());
+  return geometry;
+}
+
+void
+OMEZarrNGFFImageIO::ReadDatasetRegion(const unsigned        datasetIndex,
+                                      const ImageIORegion & region,
+                                      const int             timeIndex,
+                                      const int             channelIndex,
+                                      void *                buffer) const
+{
+  // Only const members are accessed, and tensorstore handles are safe for concurrent reads
+  const tensorstore::TensorStore<> & store = m_TensorStoreData->OpenDataset(datasetIndex);
+  itkAssertOrThrowMacro(m_StoreAxes.size() == store.rank(), "Detected mismatch in axis count and store rank");
+  itkAssertOrThrowMacro(region.GetImageDimension() <= this->GetNumberOfDimensions(),
+                        "The region dimension must not exceed the image dimension");
+  const auto shape = store.domain().shape();
+  for (unsigned d = 0; d < region.GetImageDimension(); ++d)
   {
-    this->InitializeIdentityMetadata(dims.size());
+    if (region.GetIndex(d) < 0 || region.GetIndex(d) + region.GetSize(d) > shape[shape.size() - 1 - d])
+    {
+      itkExceptionMacro(<< "Requested region " << region << " is outside of dataset " << datasetIndex);
+    }
   }
-  else
+
+  const ImageIORegion storeIORegion = this->ConfigureTensorstoreIORegion(region, timeIndex, channelIndex);
+  const std::string & chunkKeySeparator = m_TensorStoreData->datasets[datasetIndex].chunkKeySeparator;
+  ChunkProgress       progress; // traced only, as progress and cancellation are not thread-safe
+  progress.trace = m_TensorStoreData->trace;
+  progress.traceName = "read chunk";
+  if (m_PartialChunkDecoding && !chunkKeySeparator.empty() && m_TensorStoreData->readContextCacheSize == 0 &&
+      coversPartOfAChunk(store, storeIORegion))
   {
-    itkAssertOrThrowMacro(this->GetNumberOfDimensions() == dims.size(), "Found dimension mismatch in metadata");
+    OMEZarrNGFFReadStatistics statistics;
+    readDecodingOverlappingBlocks(
+      store, chunkKeySeparator, storeIORegion, static_cast<char *>(buffer), progress, statistics);
+    m_TensorStoreData->chunksDecodedBlockwise += statistics.chunksDecodedBlockwise;
+    return;
+  }
+  if (const IOComponentEnum componentType{ this->GetComponentType() };
+      !TryToReadFromStore(supportedPixelTypes, componentType, store, storeIORegion, buffer, progress))
+  {
+    itkExceptionMacro("Unsupported component type: " << GetComponentTypeAsString(componentType));
   }
+}
 
-  for (unsigned d = 0; d < dims.size(); ++d)
+unsigned
+OMEZarrNGFFImageIO::GetNumberOfSpatialDimensions() const
+{
+  const auto isSpatial = [](const OMEZarrNGFFAxis & axis) {
+    return axis.name == "x" || axis.name == "y" || axis.name == "z";
+  };
+  return static_cast<unsigned>(std::count_if(m_StoreAxes.begin(), m_StoreAxes.end(), isSpatial));
+}
+
+unsigned
+OMEZarrNGFFImageIO::SelectDataset(const std::vector<double> & targetSpacing) const
+{
+  itkAssertOrThrowMacro(targetSpacing.size() == this->GetNumberOfSpatialDimensions(),
+                        "The target spacing must have one entry per spatial axis");
+  unsigned selected = 0;
+  for (unsigned datasetIndex = 0; datasetIndex < this->GetNumberOfDatasets(); ++datasetIndex)
   {
-    this->SetDimensions(d, dims[d]);
+    const auto & spacing = m_TensorStoreData->datasets[datasetIndex].spacing;
+    bool         resolves = true;
+    for (size_t d = 0; d < targetSpacing.size(); ++d)
+    {
+      resolves = resolves && spacing[d] <= targetSpacing[d] * (1.0 + 1e-6);
+    }
+    selected = resolves ? datasetIndex : selected;
   }
+  return selected;
 }
 
 ImageIORegion
-OMEZarrNGFFImageIO::ConfigureTensorstoreIORegion(const ImageIORegion & ioRegion) const
+OMEZarrNGFFImageIO::ComputePhysicalRegion(const unsigned              datasetIndex,
+                                          const std::vector<double> & lower,
+                                          const std::vector<double> & upper) const
 {
-  const auto storeRank = m_TensorStoreData->store.rank(); 
+  const unsigned spatialDimension = this->GetNumberOfSpatialDimensions();
+  itkAssertOrThrowMacro(lower.size() == spatialDimension && upper.size() == spatialDimension,
+                        "The corners of the box must have one entry per spatial axis");
+  const OMEZarrNGFFDatasetGeometry geometry = this->GetDatasetGeometry(datasetIndex);
 
-  // Set up IO region to match known store dimensions
-  itkAssertOrThrowMacro(m_StoreAxes.size() == storeRank, "Detected mismatch in axis count and store rank");
-  ImageIORegion storeRegion(storeRank);
-  itkAssertOrThrowMacro(storeRegion.GetImageDimension(), storeRank);
-  auto storeAxes = this->GetAxesInStoreOrder();
+  // Pixel i spans [origin + (i - 0.5) * spacing, origin + (i + 0.5) * spacing)
+  ImageIORegion region(spatialDimension);
+  for (unsigned d = 0; d < spatialDimension; ++d)
+  {
+    const auto pixelAt = [&](const double position) {
+      return static_cast<IndexValueType>(std::floor((position - geometry.origin[d]) / geometry.spacing[d] + 0.5));
+    };
+    const IndexValueType first = std::max<IndexValueType>(pixelAt(std::min(lower[d], upper[d])), 0);
+    const IndexValueType last =
+      std::min<IndexValueType>(pixelAt(std::max(lower[d], upper[d])), geometry.size[d] - 1);
+    if (first > last)
+    {
+      itkExceptionMacro(<< "The physical box from " << lower[d] << " to " << upper[d] << " along axis " << d
+                        << " is outside of dataset " << datasetIndex);
+    }
+    region.SetIndex(d, first);
+    region.SetSize(d, last - first + 1);
+  }
+  return region;
+}
 
-  for (size_t storeIndex = 0; storeIndex < storeRank; ++storeIndex)
+OMEZarrNGFFDatasetGeometry
+OMEZarrNGFFImageIO::ReadPhysicalRegion(const unsigned              datasetIndex,
+                                       const std::vector<double> & lower,
+                                       const std::vector<double> & upper,
+                                       const int                   timeIndex,
+                                       const int                   channelIndex,
+                                       void *                      buffer) const
+{
+  const ImageIORegion region = this->ComputePhysicalRegion(datasetIndex, lower, upper);
+  this->ReadDatasetRegion(datasetIndex, region, timeIndex, channelIndex, buffer);
+  return cropGeometry(this->GetDatasetGeometry(datasetIndex), region);
+}
+
+std::vector<OMEZarrNGFFLevelRegion>
+OMEZarrNGFFImageIO::ReadPhysicalRegionAtDatasets(const std::vector<unsigned> & datasetIndices,
+                                                 const std::vector<double> &   lower,
+                                                 const std::vector<double> &   upper,
+                                                 const int                     timeIndex,
+                                                 const int                     channelIndex) const
+{
+  // Plan all reads first, so no read is started when any dataset does not contain the box
+  std::vector<OMEZarrNGFFLevelRegion>     levels(datasetIndices.size());
+  std::vector<tensorstore::TensorStore<>> stores;
+  std::vector<ImageIORegion>              storeIORegions;
+  for (size_t k = 0; k < levels.size(); ++k)
   {
-    auto axisName = storeAxes.at(storeIndex).name;
+    const ImageIORegion region = this->ComputePhysicalRegion(datasetIndices[k], lower, upper);
+    levels[k].datasetIndex = datasetIndices[k];
+    levels[k].geometry = cropGeometry(this->GetDatasetGeometry(datasetIndices[k]), region);
+    stores.push_back(m_TensorStoreData->OpenDataset(datasetIndices[k]));
+    storeIORegions.push_back(this->ConfigureTensorstoreIORegion(region, timeIndex, channelIndex));
+  }
 
-    // Optionally slice time or channel indices
-    if (axisName == "t")
+  // The reads of all datasets are started at once, and run on the threads of tensorstore
+  std::vector<tensorstore::Future<void>> reads;
+  for (size_t k = 0; k < levels.size(); ++k)
+  {
+    std::vector<tensorstore::Index> start(storeIORegions[k].GetImageDimension());
+    std::vector<tensorstore::Index> size(storeIORegions[k].GetImageDimension());
+    for (unsigned d = 0; d < storeIORegions[k].GetImageDimension(); ++d)
     {
-      storeRegion.SetSize(storeIndex, 1);
-      if (m_TimeIndex == INVALID_INDEX)
-      {
-        itkWarningMacro(<< "The OME-Zarr store contains a time \"t\" axis but no time point has been specified. "
-                           "Reading along a time axis is not currently supported. Data will be read from the first "
-                           "available time point by default.");
-        storeRegion.SetIndex(storeIndex, 0);
-      }
-      else
-      {
-        storeRegion.SetIndex(storeIndex, m_TimeIndex);
-      }
+      start[d] = storeIORegions[k].GetIndex(d);
+      size[d] = storeIORegions[k].GetSize(d);
     }
-    else if (axisName == "c")
+    levels[k].buffer.resize(storeIORegions[k].GetNumberOfPixels() * stores[k].dtype().size());
+    const tensorstore::ElementPointer<void> pointer(static_cast<void *>(levels[k].buffer.data()), stores[k].dtype());
+    auto array = tensorstore::UnownedToShared(tensorstore::Array(pointer, size, tensorstore::c_order));
+    reads.push_back(tensorstore::Read(stores[k] | tensorstore::AllDims().SizedInterval(start, size), array));
+  }
+  // Wait for all reads before reporting the first failure, as the others still write into the buffers
+  absl::Status status;
+  for (auto & read : reads)
+  {
+    const auto & result = read.result();
+    if (!result.ok() && status.ok())
     {
-      storeRegion.SetSize(storeIndex, 1);
-      if (m_ChannelIndex == INVALID_INDEX)
-      {
-        itkWarningMacro(<< "The OME-Zarr store contains a channel \"c\" axis but no channel index has been specified. "
-                           "Reading along a channel axis is not currently supported. Data will be read from the first "
-                           "available channel by default.");
-        storeRegion.SetIndex(storeIndex, 0);
-      }
-      else
-      {
-        storeRegion.SetIndex(storeIndex, m_ChannelIndex);
-      }
+      status = result.status();
     }
-    // Set requested region on X/Y/Z axes
-    else if (axisName == "x")
+  }
+  if (!status.ok())
+  {
+    itkExceptionMacro("tensorstore error: " << status);
+  }
+  return levels;
+}
+
+unsigned
+OMEZarrNGFFImageIO::ReadProgressive(const std::vector<double> &     lower,
+                                    const std::vector<double> &     upper,
+                                    const int                       timeIndex,
+                                    const int                       channelIndex,
+                                    const ProgressiveReadCallback & callback,
+                                    const unsigned                  finestDatasetIndex) const
+{
+  if (finestDatasetIndex >= this->GetNumberOfDatasets())
+  {
+    itkExceptionMacro(<< "Dataset " << finestDatasetIndex << " does not exist, the image has "
+                      << this->GetNumberOfDatasets() << " datasets");
+  }
+
+  // The finer datasets need larger buffers, so the buffer grows as the reads proceed
+  const size_t      pixelSize = this->GetComponentSize() * this->GetNumberOfComponents();
+  std::vector<char> buffer;
+  unsigned          numberOfDatasetsRead = 0;
+  for (unsigned datasetIndex = this->GetNumberOfDatasets(); datasetIndex-- > finestDatasetIndex;)
+  {
+    const ImageIORegion region = this->ComputePhysicalRegion(datasetIndex, lower, upper);
+    buffer.resize(std::max(buffer.size(), region.GetNumberOfPixels() * pixelSize));
+    const OMEZarrNGFFDatasetGeometry geometry =
+      this->ReadPhysicalRegion(datasetIndex, lower, upper, timeIndex, channelIndex, buffer.data());
+    ++numberOfDatasetsRead;
+    if (!callback(datasetIndex, geometry, buffer.data()))
     {
-      itkAssertOrThrowMacro(ioRegion.GetImageDimension() >= 1, "Failed to read from \"x\" axis into ITK axis \"0\"");
-      storeRegion.SetSize(storeIndex, ioRegion.GetSize(0));
-      storeRegion.SetIndex(storeIndex, ioRegion.GetIndex(0));
+      break;
     }
-    else if (axisName == "y")
+  }
+  return numberOfDatasetsRead;
+}
+
+std::vector<std::vector<char>>
+OMEZarrNGFFImageIO::ReadFieldsRegion(const std::vector<unsigned> & fieldIndices,
+                                     const unsigned                datasetIndex,
+                                     const ImageIORegion &         region,
+                                     const int                     timeIndex,
+                                     const int                     channelIndex) const
+{
+  TraceSpan span(m_TensorStoreData->trace.get(), "ReadFieldsRegion", "io", { { "file", m_FileName } });
+  if (datasetIndex >= this->GetNumberOfDatasets())
+  {
+    itkExceptionMacro(<< "Dataset " << datasetIndex << " does not exist, the image has "
+                      << this->GetNumberOfDatasets() << " datasets");
+  }
+  std::vector<std::string> fieldPaths;
+  for (const unsigned fieldIndex : fieldIndices)
+  {
+    if (fieldIndex >= m_Fields.size())
     {
-      itkAssertOrThrowMacro(ioRegion.GetImageDimension() >= 2, "Failed to read from \"y\" axis into ITK axis \"1\"");
-      storeRegion.SetSize(storeIndex, ioRegion.GetSize(1));
-      storeRegion.SetIndex(storeIndex, ioRegion.GetIndex(1));
+      itkExceptionMacro(<< "Field " << fieldIndex << " does not exist, '" << m_FileName << "' has " << m_Fields.size()
+                        << " fields");
     }
-    else if (axisName == "z")
+    fieldPaths.push_back(m_Fields[fieldIndex].path);
+  }
+  itkAssertOrThrowMacro(region.GetImageDimension() <= this->GetNumberOfDimensions(),
+                        "The region dimension must not exceed the image dimension");
+  const ImageIORegion storeIORegion = this->ConfigureTensorstoreIORegion(region, timeIndex, channelIndex);
+  std::vector<tensorstore::Index> start(storeIORegion.GetImageDimension());
+  std::vector<tensorstore::Index> size(storeIORegion.GetImageDimension());
+  for (unsigned d = 0; d < storeIORegion.GetImageDimension(); ++d)
+  {
+    start[d] = storeIORegion.GetIndex(d);
+    size[d] = storeIORegion.GetSize(d);
+  }
+
+  // All arrays are opened before any read starts, so a field without the region fails the whole batch early
+  const std::vector<tensorstore::TensorStore<>> stores =
+    m_TensorStoreData->OpenFieldDatasets(m_FileName, fieldIndices, fieldPaths, datasetIndex);
+  for (size_t k = 0; k < stores.size(); ++k)
+  {
+    const auto shape = stores[k].domain().shape();
+    if (tensorstoreToITKComponentType(stores[k].dtype()) != this->GetComponentType() || shape.size() != start.size())
     {
-      itkAssertOrThrowMacro(ioRegion.GetImageDimension() >= 3, "Failed to read from \"z\" axis into ITK axis \"2\"");
-      storeRegion.SetSize(storeIndex, ioRegion.GetSize(2));
-      storeRegion.SetIndex(storeIndex, ioRegion.GetIndex(2));
+      itkExceptionMacro(<< "The array of dataset " << datasetIndex << " of field '" << fieldPaths[k]
+                        << "' does not match the type and rank of the opened image");
+    }
+    for (size_t d = 0; d < start.size(); ++d)
+    {
+      if (start[d] < 0 || start[d] + size[d] > shape[d])
+      {
+        itkExceptionMacro(<< "Requested region " << region << " is outside of dataset " << datasetIndex << " of field '"
+                          << fieldPaths[k] << "'");
+      }
     }
   }
 
-  return storeRegion;
+  std::vector<std::vector<char>>         buffers(stores.size());
+  std::vector<tensorstore::Future<void>> reads;
+  for (size_t k = 0; k < stores.size(); ++k)
+  {
+    buffers[k].resize(storeIORegion.GetNumberOfPixels() * stores[k].dtype().size());
+    const tensorstore::ElementPointer<void> pointer(static_cast<void *>(buffers[k].data()), stores[k].dtype());
+    auto array = tensorstore::UnownedToShared(tensorstore::Array(pointer, size, tensorstore::c_order));
+    reads.push_back(tensorstore::Read(stores[k] | tensorstore::AllDims().SizedInterval(start, size), array));
+  }
+  // Wait for all reads before reporting the first failure, as the others still write into the buffers
+  absl::Status status;
+  for (auto & read : reads)
+  {
+    const auto & result = read.result();
+    if (!result.ok() && status.ok())
+    {
+      status = result.status();
+    }
+  }
+  if (!status.ok())
+  {
+    itkExceptionMacro("tensorstore error: " << status);
+  }
+  return buffers;
 }
 
-void
-OMEZarrNGFFImageIO::ReadImageInformation()
+unsigned
+OMEZarrNGFFImageIO::ReadObliqueSlice(const OMEZarrNGFFReslicePlane & plane,
+                                     const int                       timeIndex,
+                                     const int                       channelIndex,
+                                     float *                         buffer,
+                                     const int                       datasetIndex) const
 {
-  nlohmann::json json;
-  std::string    driver = getKVstoreDriver(this->GetFileName());
+  itkAssertOrThrowMacro(!m_TensorStoreData->datasets.empty(),
+                        "ReadImageInformation must be called before ReadObliqueSlice");
 
-  const std::string zgroupFilePath(std::string(this->GetFileName()) + "/.zgroup");
-  bool              status = jsonRead(zgroupFilePath, json, driver, m_TensorStoreData->tsContext);
-  itkAssertOrThrowMacro(status, ("Failed to read from " + zgroupFilePath));
-  itkAssertOrThrowMacro(json.at("zarr_format").get<int>() == 2, "Only v2 zarr format is supported"); // only v2 for now
+  // Store and ITK indices of the spatial axes
+  const auto         storeAxes = this->GetAxesInStoreOrder();
+  const size_t       rank = storeAxes.size();
+  std::array<int, 3> storeAxis{ { -1, -1, -1 } };
+  for (size_t storeIndex = 0; storeIndex < rank; ++storeIndex)
+  {
+    const auto & name = storeAxes[storeIndex].name;
+    const auto   spatialIndex = std::string("xyz").find(name);
+    if (name.size() == 1 && spatialIndex != std::string::npos)
+    {
+      storeAxis[spatialIndex] = storeIndex;
+    }
+  }
+  if (std::find(storeAxis.begin(), storeAxis.end(), -1) != storeAxis.end())
+  {
+    itkExceptionMacro(<< "Oblique slices require x, y and z axes");
+  }
 
-  const std::string zattrsFilePath(std::string(this->GetFileName()) + "/.zattrs");
-  status = jsonRead(zattrsFilePath, json, driver, m_TensorStoreData->tsContext);
-  itkAssertOrThrowMacro(status, ("Failed to read from " + zattrsFilePath));
-  json = json.at("multiscales")[0]; // multiscales must be present in OME-NGFF
-  auto version = json.at("version").get<std::string>();
-  if (version == "0.4" || version == "0.3" || version == "0.2" || version == "0.1")
+  // The coarsest dataset which still resolves the plane spacing
+  const unsigned level =
+    datasetIndex >= 0
+      ? datasetIndex
+      : this->SelectDataset(std::vector<double>(this->GetNumberOfSpatialDimensions(),
+                                                std::min(plane.spacing[0], plane.spacing[1])));
+  const OMEZarrNGFFDatasetGeometry   geometry = this->GetDatasetGeometry(level);
+  const tensorstore::TensorStore<> & store = m_TensorStoreData->OpenDataset(level);
+  const auto                         chunkShape = getChunkShape(store);
+  const auto                         domainShape = store.domain().shape();
+  const auto                         castStore = tensorstore::Cast<float>(store); // interpolated as floats
+  if (!castStore.ok())
   {
-    // these are explicitly supported versions
+    itkExceptionMacro(<< "tensorstore error: " << castStore.status());
   }
-  else
+
+  // The time point and channel, with the spatial axes of each chunk set below
+  ImageIORegion spatialRegion(3);
+  const auto    fixedRegion = this->ConfigureTensorstoreIORegion(spatialRegion, timeIndex, channelIndex);
+
+  // Continuous index of each output pixel in the dataset, or NaN when outside of it
+  const size_t                       numberOfPixels = plane.size[0] * plane.size[1];
+  std::vector<std::array<double, 3>> continuousIndices(numberOfPixels);
+  for (SizeValueType j = 0; j < plane.size[1]; ++j)
   {
-    std::string message = "OME-NGFF version " + version + " is not explicitly supported." +
-                          "\nImportant features might be ignored." + "\nSupported versions are 0.1 through 0.4.";
-    OutputWindowDisplayWarningText(message.c_str());
+    for (SizeValueType i = 0; i < plane.size[0]; ++i)
+    {
+      auto & index = continuousIndices[j * plane.size[0] + i];
+      for (unsigned a = 0; a < 3; ++a)
+      {
+        const size_t itkAxis = rank - 1 - storeAxis[a];
+        const double point = plane.origin[a] + i * plane.spacing[0] * plane.uDirection[a] +
+                             j * plane.spacing[1] * plane.vDirection[a];
+        index[a] = (point - geometry.origin[itkAxis]) / geometry.spacing[itkAxis];
+        if (!(index[a] >= 0.0 && index[a] <= geometry.size[itkAxis] - 1.0))
+        {
+          index[0] = std::numeric_limits<double>::quiet_NaN();
+          break;
+        }
+      }
+    }
   }
 
-  if (json.contains("axes")) // optional before 0.3
+  // The chunks containing the corners of the interpolation cells, numbered in C order over x, y, z
+  std::array<tensorstore::Index, 3> gridShape;
+  for (unsigned a = 0; a < 3; ++a)
   {
-    this->InitializeIdentityMetadata(json.at("axes").size());
+    gridShape[a] = (domainShape[storeAxis[a]] + chunkShape[storeAxis[a]] - 1) / chunkShape[storeAxis[a]];
+  }
+  const auto cellKey = [&](const std::array<tensorstore::Index, 3> & index) {
+    uint64_t key = 0;
+    for (unsigned a = 0; a < 3; ++a)
+    {
+      key = key * gridShape[a] + index[a] / chunkShape[storeAxis[a]];
+    }
+    return key;
+  };
+  const auto forEachCorner = [&](const std::array<double, 3> & index, auto && function) {
+    std::array<tensorstore::Index, 3> low;
+    std::array<double, 3>             weight;
+    for (unsigned a = 0; a < 3; ++a)
+    {
+      low[a] = std::min(static_cast<tensorstore::Index>(index[a]), domainShape[storeAxis[a]] - 1);
+      weight[a] = index[a] - low[a];
+    }
+    for (unsigned corner = 0; corner < 8; ++corner)
+    {
+      std::array<tensorstore::Index, 3> cornerIndex;
+      double                            cornerWeight = 1.0;
+      for (unsigned a = 0; a < 3; ++a)
+      {
+        const bool high = (corner >> a) & 1;
+        cornerIndex[a] = low[a] + high;
+        cornerWeight *= high ? weight[a] : 1.0 - weight[a];
+      }
+      if (cornerWeight > 0.0)
+      {
+        function(cornerIndex, cornerWeight);
+      }
+    }
+  };
 
-    m_StoreAxes.resize(json.at("axes").size());
-    auto targetIt = m_StoreAxes.rbegin();
-    for (const auto & axis : json.at("axes"))
+  // Of each chunk, only the box bounding the corners in it is read, the slab the plane passes through
+  struct Chunk
+  {
+    std::array<tensorstore::Index, 3> first;
+    std::array<tensorstore::Index, 3> last;
+    std::vector<tensorstore::Index>   start;
+    std::vector<tensorstore::Index>   strides;
+    std::vector<float>                pixels;
+    tensorstore::Future<void>         read;
+  };
+  std::unordered_map<uint64_t, Chunk> chunks;
+  for (const auto & index : continuousIndices)
+  {
+    if (std::isnan(index[0]))
     {
-      *targetIt = (OMEZarrNGFFAxis{ axis.at("name"), axis.at("type"), (axis.contains("unit") ? axis.at("unit") : "") });
-      ++targetIt;
+      continue;
     }
-    itkAssertOrThrowMacro(targetIt == m_StoreAxes.rend(),
-                          "Internal error: failed to fully parse axes from OME-Zarr metadata");
+    forEachCorner(index, [&](const std::array<tensorstore::Index, 3> & cornerIndex, double) {
+      auto [entry, isNew] = chunks.try_emplace(cellKey(cornerIndex));
+      Chunk & chunk = entry->second;
+      for (unsigned a = 0; a < 3; ++a)
+      {
+        chunk.first[a] = isNew ? cornerIndex[a] : std::min(chunk.first[a], cornerIndex[a]);
+        chunk.last[a] = isNew ? cornerIndex[a] : std::max(chunk.last[a], cornerIndex[a]);
+      }
+    });
   }
-  else
+  for (auto & entry : chunks)
   {
-    if (version == "0.4")
+    Chunk &                         chunk = entry.second;
+    std::vector<tensorstore::Index> size(rank);
+    chunk.start.resize(rank);
+    for (size_t d = 0; d < rank; ++d)
     {
-      itkExceptionMacro(<< "\"axes\" field is missing from OME-Zarr image metadata at " << zattrsFilePath);
+      chunk.start[d] = fixedRegion.GetIndex(d);
+      size[d] = fixedRegion.GetSize(d);
     }
-    this->SetNumberOfDimensions(0);
+    for (unsigned a = 0; a < 3; ++a)
+    {
+      chunk.start[storeAxis[a]] = chunk.first[a];
+      size[storeAxis[a]] = chunk.last[a] - chunk.first[a] + 1;
+    }
+    chunk.strides.assign(rank, 1);
+    for (size_t d = rank - 1; d > 0; --d)
+    {
+      chunk.strides[d - 1] = chunk.strides[d] * size[d];
+    }
+    chunk.pixels.resize(chunk.strides[0] * size[0]);
+    auto target = tensorstore::UnownedToShared(tensorstore::Array(chunk.pixels.data(), size, tensorstore::c_order));
+    chunk.read = tensorstore::Read(*castStore | tensorstore::AllDims().SizedInterval(chunk.start, size), target);
   }
-
-  if (json.contains("coordinateTransformations")) // optional
+  // All reads complete before any error is reported, as they write into the chunk buffers
+  for (auto & entry : chunks)
   {
-    addCoordinateTransformations(this, json.at("coordinateTransformations")); // dataset-level scaling
+    entry.second.read.Wait();
   }
-  json = json.at("datasets");
-  if (this->GetDatasetIndex() >= json.size())
+  for (auto & entry : chunks)
   {
-    itkExceptionMacro(<< "Requested DatasetIndex of " << this->GetDatasetIndex()
-                      << " is out of range for the number of datasets (" << json.size()
-                      << ") which exist in OME-NGFF store '" << this->GetFileName() << "'");
+    TS_EVAL_CHECK(entry.second.read);
   }
 
-  json = json[this->GetDatasetIndex()];
-  if (json.contains("coordinateTransformations")) // optional for versions prior to 0.4
+  for (size_t p = 0; p < numberOfPixels; ++p)
   {
-    addCoordinateTransformations(this, json.at("coordinateTransformations")); // per-resolution scaling
+    const auto & index = continuousIndices[p];
+    double       value = 0.0;
+    if (!std::isnan(index[0]))
+    {
+      forEachCorner(index, [&](const std::array<tensorstore::Index, 3> & cornerIndex, const double cornerWeight) {
+        const Chunk & chunk = chunks.at(cellKey(cornerIndex));
+        size_t        offset = 0;
+        for (unsigned a = 0; a < 3; ++a)
+        {
+          offset += (cornerIndex[a] - chunk.start[storeAxis[a]]) * chunk.strides[storeAxis[a]];
+        }
+        value += cornerWeight * chunk.pixels[offset];
+      });
+    }
+    buffer[p] = static_cast<float>(value);
   }
-  else
+  return level;
+}
+
+OMEZarrNGFFRegionStatistics
+OMEZarrNGFFImageIO::ComputeRegionStatistics(const ImageIORegion & region,
+                                            const unsigned        numberOfHistogramBins,
+                                            const double          histogramMinimum,
+                                            const double          histogramMaximum,
+                                            const unsigned        numberOfThreads) const
+{
+  const tensorstore::TensorStore<> & store = m_TensorStoreData->store;
+  itkAssertOrThrowMacro(store.valid(), "ReadImageInformation must be called before ComputeRegionStatistics");
+  const unsigned rank = this->GetNumberOfDimensions();
+  if (region.GetImageDimension() != rank)
   {
-    if (version == "0.4")
+    itkExceptionMacro(<< "The region must have the " << rank << " dimensions of the dataset, including any "
+                      << "channel and time axes, but has " << region.GetImageDimension());
+  }
+  std::vector<tensorstore::Index> start(rank);
+  std::vector<tensorstore::Index> size(rank);
+  for (unsigned d = 0; d < rank; ++d)
+  {
+    if (region.GetIndex(d) < 0 || region.GetIndex(d) + region.GetSize(d) > this->GetDimensions(d))
     {
-      itkExceptionMacro(<< "OME-NGFF v0.4 requires `coordinateTransformations` for each resolution level.");
+      itkExceptionMacro(<< "Requested region " << region << " is outside of the image");
     }
+    start[rank - 1 - d] = region.GetIndex(d); // convert IJK into KJI
+    size[rank - 1 - d] = region.GetSize(d);
   }
 
-  // TODO: parse stuff from "metadata" object into metadata dictionary
+  OMEZarrNGFFRegionStatistics statistics;
+  if (numberOfHistogramBins > 0)
+  {
+    if (!(histogramMinimum < histogramMaximum))
+    {
+      itkExceptionMacro(<< "The histogram range [" << histogramMinimum << ", " << histogramMaximum
+                        << "] must not be empty");
+    }
+    statistics.histogramMinimum = histogramMinimum;
+    statistics.histogramMaximum = histogramMaximum;
+    statistics.histogram.assign(numberOfHistogramBins, 0);
+  }
 
-  ReadArrayMetadata(std::string(this->GetFileName()) + "/" + json.at("path").get<std::string>(), driver);
+  const IOComponentEnum componentType{ this->GetComponentType() };
+  if (!TryToReduceStore(supportedPixelTypes,
+                        componentType,
+                        store,
+                        start,
+                        size,
+                        numberOfThreads > 0 ? numberOfThreads : MultiThreaderBase::GetGlobalDefaultNumberOfThreads(),
+                        statistics))
+  {
+    itkExceptionMacro("Unsupported component type: " << GetComponentTypeAsString(componentType));
+  }
+  return statistics;
 }
 
 void
-OMEZarrNGFFImageIO::Read(void * buffer)
+OMEZarrNGFFImageIO::ComputeProjection(const ImageIORegion & region,
+                                      const std::string &   axisName,
+                                      const ProjectionEnum  projection,
+                                      void *                buffer,
+                                      const unsigned        numberOfThreads) const
 {
-  // Use a proxy measure (voxel count) to determine whether we are reading
-  // the entire image or an image subregion.
-  // This comparison needs to be done carefully, we can compare 3D and 6D regions
-  if (this->GetLargestRegion().GetNumberOfPixels() == m_IORegion.GetNumberOfPixels())
+  const tensorstore::TensorStore<> & store = m_TensorStoreData->store;
+  itkAssertOrThrowMacro(store.valid(), "ReadImageInformation must be called before ComputeProjection");
+  const unsigned rank = this->GetNumberOfDimensions();
+  if (region.GetImageDimension() != rank)
   {
-    itkAssertOrThrowMacro(m_TensorStoreData->store.domain().num_elements() == m_IORegion.GetNumberOfPixels(),
-                          "Detected mismatch between store size and size of largest possible region");
+    itkExceptionMacro(<< "The region must have the " << rank << " dimensions of the dataset, including any "
+                      << "channel and time axes, but has " << region.GetImageDimension());
   }
-  else
+  std::vector<tensorstore::Index> start(rank);
+  std::vector<tensorstore::Index> size(rank);
+  for (unsigned d = 0; d < rank; ++d)
   {
-    // Get a requested image subregion
-    itkAssertOrThrowMacro(this->GetNumberOfComponents() == 1,
-                          "Reading an image subregion is currently supported only for single channel images");
+    if (region.GetIndex(d) < 0 || region.GetIndex(d) + region.GetSize(d) > this->GetDimensions(d))
+    {
+      itkExceptionMacro(<< "Requested region " << region << " is outside of the image");
+    }
+    start[rank - 1 - d] = region.GetIndex(d); // convert IJK into KJI
+    size[rank - 1 - d] = region.GetSize(d);
   }
-  auto storeIORegion = this->ConfigureTensorstoreIORegion(m_IORegion);
 
-  if (this->GetDebug())
-  {
-    std::cout << "Preparing to read " << storeIORegion.GetNumberOfPixels() << " elements from tensorstore region "
-              << storeIORegion;
-  }
+  const auto storeAxes = this->GetAxesInStoreOrder();
+  const auto axis = std::find_if(
+    storeAxes.begin(), storeAxes.end(), [&axisName](const OMEZarrNGFFAxis & a) { return a.name == axisName; });
+  if (axis == storeAxes.end())
+  {
+    itkExceptionMacro(<< "The dataset has no \"" << axisName << "\" axis to project along");
+  }
+  const size_t axisIndex = axis - storeAxes.begin();
+
+  const IOComponentEnum componentType{ this->GetComponentType() };
+  if (!TryToProjectStore(supportedPixelTypes,
+                         componentType,
+                         store,
+                         start,
+                         size,
+                         axisIndex,
+                         projection,
+                         buffer,
+                         numberOfThreads > 0 ? numberOfThreads : MultiThreaderBase::GetGlobalDefaultNumberOfThreads()))
+  {
+    itkExceptionMacro("Unsupported component type: " << GetComponentTypeAsString(componentType));
+  }
+}
+
+std::vector<SizeValueType>
+OMEZarrNGFFImageIO::GetStoreChunkSize() const
+{
+  itkAssertOrThrowMacro(m_TensorStoreData->store.valid(),
+                        "ReadImageInformation must be called before GetStoreChunkSize");
+  const auto chunkShape = getChunkShape(m_TensorStoreData->store);
+  return std::vector<SizeValueType>(chunkShape.rbegin(), chunkShape.rend()); // convert KJI into IJK
+}
+
+void
+OMEZarrNGFFImageIO::UpdateReadStatistics(const OMEZarrNGFFReadStatistics & statistics)
+{
+  m_LastReadStatistics = statistics;
+  m_CumulativeReadStatistics += statistics;
+
+  MetaDataDictionary & dictionary = this->GetMetaDataDictionary();
+  EncapsulateMetaData<uint64_t>(dictionary, "OMEZarrNGFFLastReadBytesFetched", statistics.bytesFetched);
+  EncapsulateMetaData<uint64_t>(dictionary, "OMEZarrNGFFLastReadChunksRequested", statistics.chunksRequested);
+  EncapsulateMetaData<uint64_t>(dictionary, "OMEZarrNGFFLastReadCacheHits", statistics.cacheHits);
+  EncapsulateMetaData<uint64_t>(dictionary, "OMEZarrNGFFLastReadCacheMisses", statistics.cacheMisses);
+  EncapsulateMetaData<uint64_t>(dictionary, "OMEZarrNGFFLastReadReadAheadHits", statistics.readAheadHits);
+  EncapsulateMetaData<uint64_t>(dictionary, "OMEZarrNGFFLastReadReadAheadMisses", statistics.readAheadMisses);
+  EncapsulateMetaData<uint64_t>(dictionary, "OMEZarrNGFFLastReadChunksReadAhead", statistics.chunksReadAhead);
+  EncapsulateMetaData<double>(dictionary, "OMEZarrNGFFLastReadOpenSeconds", statistics.openSeconds);
+  EncapsulateMetaData<uint64_t>(
+    dictionary, "OMEZarrNGFFLastReadChunksDecodedBlockwise", statistics.chunksDecodedBlockwise);
+  EncapsulateMetaData<double>(dictionary, "OMEZarrNGFFLastReadFetchSeconds", statistics.fetchSeconds);
+  EncapsulateMetaData<double>(dictionary, "OMEZarrNGFFLastReadDecodeSeconds", statistics.decodeSeconds);
+  EncapsulateMetaData<double>(dictionary, "OMEZarrNGFFLastReadCopySeconds", statistics.copySeconds);
+  EncapsulateMetaData<double>(dictionary, "OMEZarrNGFFLastReadSeconds", statistics.readSeconds);
+}
+
+void
+OMEZarrNGFFImageIO::ResetReadStatistics()
+{
+  m_LastReadStatistics = OMEZarrNGFFReadStatistics{};
+  m_CumulativeReadStatistics = OMEZarrNGFFReadStatistics{};
+  m_PendingOpenSeconds = 0.0;
+  m_TensorStoreData->chunksDecodedBlockwise = 0;
+}
 
-  if (const IOComponentEnum componentType{ this->GetComponentType() };
-      !TryToReadFromStore(supportedPixelTypes, componentType, m_TensorStoreData->store, storeIORegion, buffer))
-  {
-    itkExceptionMacro("Unsupported component type: " << GetComponentTypeAsString(componentType));
-  }
+SizeValueType
+OMEZarrNGFFImageIO::GetNumberOfChunksDecodedBlockwise() const
+{
+  return m_TensorStoreData->chunksDecodedBlockwise;
 }
 
 
@@ -774,12 +3787,24 @@ OMEZarrNGFFImageIO::CanWriteFile(const char * name)
 void
 OMEZarrNGFFImageIO::WriteImageInformation()
 {
-  std::string driver = getKVstoreDriver(this->GetFileName());
+  std::string driver = getKVstoreWriteDriver(this->GetFileName());
 
   nlohmann::json group;
   group["zarr_format"] = 2;
   writeJson(group, std::string(this->GetFileName()) + "/.zgroup", driver, m_TensorStoreData->tsContext);
 
+  if (m_TensorStoreData->groupAttributesFileName != m_FileName)
+  {
+    this->WriteGroupAttributes();
+  }
+}
+
+
+void
+OMEZarrNGFFImageIO::WriteGroupAttributes()
+{
+  std::string driver = getKVstoreWriteDriver(this->GetFileName());
+
   unsigned dim = this->GetNumberOfDimensions();
 
   std::vector<double> origin(dim);
@@ -810,18 +3835,95 @@ OMEZarrNGFFImageIO::WriteImageInformation()
 
   nlohmann::json zattrs;
   zattrs["multiscales"] = multiscales;
+
+  if (m_ComputeChannelStatistics && !m_ChannelStatistics.empty())
+  {
+    // Display settings in the transitional "omero" block of OME-NGFF 0.4,
+    // and the complete statistics in a block of our own
+    nlohmann::json channels = nlohmann::json::array();
+    nlohmann::json statistics = nlohmann::json::array();
+    for (size_t c = 0; c < m_ChannelStatistics.size(); ++c)
+    {
+      const auto & channel = m_ChannelStatistics[c];
+      channels.push_back({ { "active", true },
+                           { "coefficient", 1 },
+                           { "color", "FFFFFF" },
+                           { "family", "linear" },
+                           { "inverted", false },
+                           { "label", "Channel " + std::to_string(c) },
+                           { "window",
+                             { { "min", channel.minimum },
+                               { "max", channel.maximum },
+                               { "start", channel.windowStart },
+                               { "end", channel.windowEnd } } } });
+      statistics.push_back({ { "min", channel.minimum },
+                             { "max", channel.maximum },
+                             { "mean", channel.mean },
+                             { "count", channel.count },
+                             { "histogram",
+                               { { "min", channel.histogramMinimum },
+                                 { "max", channel.histogramMaximum },
+                                 { "counts", channel.histogram } } } });
+    }
+    zattrs["omero"] = { { "channels", channels }, { "version", "0.4" } };
+    zattrs["itk_channel_statistics"] = statistics;
+  }
+
   writeJson(zattrs, std::string(this->GetFileName()) + "/.zattrs", driver, m_TensorStoreData->tsContext);
 }
 
 
+void
+OMEZarrNGFFImageIO::AccumulateChannelStatistics(const void * buffer, const ImageIORegion & ioRegion)
+{
+  // The buffer holds blocks of spatial pixels, one per channel and time point, channels moving faster
+  const unsigned nDims = ioRegion.GetImageDimension();
+  size_t         blockSize = this->GetNumberOfComponents();
+  for (unsigned d = 0; d < std::min(nDims, 3u); ++d)
+  {
+    blockSize *= ioRegion.GetSize(d);
+  }
+  const SizeValueType numberOfChannels = nDims > 3 ? ioRegion.GetSize(3) : 1;
+  const SizeValueType numberOfTimePoints = nDims > 4 ? ioRegion.GetSize(4) : 1;
+
+  // Each channel has an accumulator of its own, so the channels are scanned by concurrent work units
+  auto &            accumulators = m_TensorStoreData->channelAccumulators;
+  std::atomic<bool> accumulated{ true };
+  auto              multiThreader = MultiThreaderBase::New();
+  multiThreader->SetNumberOfWorkUnits(std::min<SizeValueType>(numberOfChannels, multiThreader->GetNumberOfWorkUnits()));
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfChannels,
+    [&](const SizeValueType c) {
+      std::vector<ChannelAccumulator *> blockAccumulators(numberOfTimePoints * numberOfChannels, nullptr);
+      for (SizeValueType t = 0; t < numberOfTimePoints; ++t)
+      {
+        blockAccumulators[t * numberOfChannels + c] = &accumulators.at(nDims > 3 ? ioRegion.GetIndex(3) + c : 0);
+      }
+      if (!TryToAccumulate(supportedPixelTypes, this->GetComponentType(), buffer, blockSize, blockAccumulators))
+      {
+        accumulated = false;
+      }
+    },
+    nullptr);
+  if (!accumulated)
+  {
+    itkExceptionMacro("Unsupported component type: " << GetComponentTypeAsString(this->GetComponentType()));
+  }
+}
+
+
 void
 OMEZarrNGFFImageIO::Write(const void * buffer)
 {
-  if (m_FileName.substr(m_FileName.size() - 4) == ".zip" || m_FileName.substr(m_FileName.size() - 7) == ".memory")
+  const bool isZipFile = hasSuffix(m_FileName, ".zip");
+  const bool isZipMemory = hasSuffix(m_FileName, ".memory");
+
+  if (m_WriteMode != WriteModeEnum::Overwrite)
   {
-    m_TensorStoreData->tsContext = tensorstore::Context::Default(); // start with clean zip handles
+    this->WriteIntoExistingStore(buffer);
+    return;
   }
-  this->WriteImageInformation();
 
   const IOComponentEnum componentType{ this->GetComponentType() };
 
@@ -830,8 +3932,12 @@ OMEZarrNGFFImageIO::Write(const void * buffer)
     itkExceptionMacro("Unsupported component type: " << GetComponentTypeAsString(componentType));
   }
 
-  std::vector<int64_t> shape(this->GetNumberOfDimensions());
-  for (unsigned d = 0; d < shape.size(); ++d)
+  const unsigned       nDims = this->GetNumberOfDimensions();
+  std::vector<int64_t> shape(nDims);
+  ImageIORegion        storeIORegion(nDims);
+  bool                 isFirstDivision = true;
+  bool                 isLastDivision = true;
+  for (unsigned d = 0; d < nDims; ++d)
   {
     auto dSize = this->GetDimensions(d);
     if (dSize > std::numeric_limits<int64_t>::max())
@@ -839,31 +3945,491 @@ OMEZarrNGFFImageIO::Write(const void * buffer)
       itkExceptionMacro("This image IO uses a signed type for sizes, and "
                         << dSize << " exceeds maximum allowed size of " << std::numeric_limits<int64_t>::max());
     }
-    shape[shape.size() - 1 - d] = dSize; // convert IJK into KJI
+    shape[nDims - 1 - d] = dSize; // convert IJK into KJI
+    storeIORegion.SetIndex(nDims - 1 - d, m_IORegion.GetIndex(d));
+    storeIORegion.SetSize(nDims - 1 - d, m_IORegion.GetSize(d));
+    isFirstDivision = isFirstDivision && m_IORegion.GetIndex(d) == 0;
+    isLastDivision = isLastDivision && m_IORegion.GetIndex(d) + m_IORegion.GetSize(d) == dSize;
+  }
+
+  // The array is created by the first stream division (or by a non-streamed write),
+  // and later divisions write into the array which is already open, if it is the same array.
+  const std::string path = MakePath(this->GetDatasetIndex());
+  const bool        isWriteStoreOpen = m_TensorStoreData->writeStoreMode == WriteModeEnum::Overwrite &&
+                                m_TensorStoreData->writeStoreFileName == m_FileName &&
+                                m_TensorStoreData->writeStorePath == path &&
+                                m_TensorStoreData->writeStoreDType == itkToTensorstoreComponentType(componentType) &&
+                                m_TensorStoreData->writeStoreShape == shape;
+  if (!isWriteStoreOpen && !isFirstDivision)
+  {
+    itkExceptionMacro(<< "A stream division of '" << m_FileName << "' away from the origin of dataset " << path
+                      << " is written, but no array of its component type and size was created by a division"
+                      << " at the origin of this dataset");
+  }
+  const bool createStore =
+    !isWriteStoreOpen || m_IORegion.GetNumberOfPixels() == this->GetLargestRegion().GetNumberOfPixels();
+
+  if (createStore)
+  {
+    this->FinalizeWrite(); // do not delete an array which is still being written
+    m_TensorStoreData->ClearWriteStore();
+    if (isZipMemory)
+    {
+      m_TensorStoreData->tsContext = tensorstore::Context::Default(); // start with clean zip handles
+      m_TensorStoreData->readContextCacheSize = 0; // the read context derives from the replaced one
+      m_TensorStoreData->zipMemoryArchiveOpen = true;
+    }
+    if (isZipFile)
+    {
+      this->BeginZipArchive();
+    }
+    m_ChannelStatistics.clear();
+    m_TensorStoreData->channelAccumulators.clear();
+    m_TensorStoreData->groupAttributesFileName.clear();
+    if (m_ComputeChannelStatistics)
+    {
+      const unsigned numberOfChannels = this->GetNumberOfDimensions() > 3 ? this->GetDimensions(3) : 1;
+      m_TensorStoreData->channelAccumulators.resize(numberOfChannels);
+      m_TensorStoreData->groupAttributesFileName = m_FileName;
+    }
+    this->WriteImageInformation();
+  }
+
+  std::string compressor = this->GetCompressor();
+  std::transform(compressor.begin(), compressor.end(), compressor.begin(), ::toupper);
+
+  // Zip archives are assembled from the written chunks, so their data must be written by then
+  const bool asynchronous = m_AsynchronousWrite && !isZipFile && !isZipMemory;
+  TraceSpan  span(m_TensorStoreData->trace.get(), "Write", "io", { { "file", m_FileName } });
+
+  // Each chunk of a zip archive is appended as soon as it is written, which frees its staged copy
+  ChunkProgress progress = makeChunkProgress(this, m_TensorStoreData->trace, "write chunk");
+  if (isZipFile)
+  {
+    progress.written = [this, &storeIORegion](const std::vector<tensorstore::Index> & cell) {
+      this->AppendWrittenChunkToZipArchive(storeIORegion, std::vector<IndexValueType>(cell.begin(), cell.end()));
+    };
   }
 
   if (!TryToWriteToStore(supportedPixelTypes,
                          componentType,
-                         m_TensorStoreData->store,
+                         m_TensorStoreData->writeStore,
                          m_TensorStoreData->tsContext,
                          m_FileName,
-                         MakePath(this->GetDatasetIndex()),
-                         shape,
-                         buffer))
+                         path,
+                         makeArrayMetadata(shape, compressor, this->GetCompressionLevel(), m_ChunkSize),
+                         nlohmann::json{},
+                         createStore,
+                         storeIORegion,
+                         buffer,
+                         asynchronous ? &m_TensorStoreData->pendingWrites : nullptr,
+                         progress))
   {
     itkExceptionMacro("Unsupported component type: " << GetComponentTypeAsString(componentType));
   }
 
-  if (m_FileName.substr(m_FileName.size() - 4) == ".zip" || m_FileName.substr(m_FileName.size() - 7) == ".memory")
+  // Scanned after the write is issued, so an asynchronous write encodes the chunks meanwhile
+  if (m_TensorStoreData->groupAttributesFileName == m_FileName)
+  {
+    TraceSpan statisticsSpan(m_TensorStoreData->trace.get(), "accumulate channel statistics", "compute");
+    this->AccumulateChannelStatistics(buffer, m_IORegion);
+  }
+  m_TensorStoreData->writeStoreMode = WriteModeEnum::Overwrite;
+  m_TensorStoreData->writeStoreFileName = m_FileName;
+  m_TensorStoreData->writeStorePath = path;
+  m_TensorStoreData->writeStoreDatasetIndex = this->GetDatasetIndex();
+  m_TensorStoreData->writeStoreDType = itkToTensorstoreComponentType(componentType);
+  m_TensorStoreData->writeStoreShape = shape;
+
+  if (isLastDivision && m_TensorStoreData->groupAttributesFileName == m_FileName)
+  {
+    for (const auto & accumulator : m_TensorStoreData->channelAccumulators)
+    {
+      m_ChannelStatistics.push_back(accumulator.Finalize());
+    }
+    m_TensorStoreData->channelAccumulators.clear();
+    m_TensorStoreData->groupAttributesFileName.clear();
+    this->WriteGroupAttributes();
+  }
+
+  // Stream divisions are ordered, so the last one contains the last pixel of the image
+  if ((isZipFile || isZipMemory) && isLastDivision)
+  {
+    this->FinalizeWrite();
+  }
+}
+
+
+void
+OMEZarrNGFFImageIO::FinalizeWrite()
+{
+  this->WaitForPendingWrites();
+
+  // An interrupted write of a store with channel statistics still needs its .zattrs
+  if (!m_TensorStoreData->groupAttributesFileName.empty())
+  {
+    const bool isPendingStore = m_TensorStoreData->groupAttributesFileName == m_FileName;
+    m_TensorStoreData->groupAttributesFileName.clear();
+    m_TensorStoreData->channelAccumulators.clear();
+    if (isPendingStore)
+    {
+      this->WriteGroupAttributes();
+    }
+  }
+
+  if (m_TensorStoreData->zipWriter)
+  {
+    // Metadata and chunks shared between stream divisions are the last entries of the archive
+    std::vector<std::string> stagedKeys(m_TensorStoreData->zipStagedKeys.begin(),
+                                        m_TensorStoreData->zipStagedKeys.end());
+    this->AppendStagedEntriesToZipArchive(stagedKeys);
+    auto zipWriter = std::move(m_TensorStoreData->zipWriter);
+    m_TensorStoreData->ClearWriteStore(); // the archive can no longer be appended to
+    zipWriter->Close();
+  }
+
+  if (m_TensorStoreData->zipMemoryArchiveOpen)
   {
+    m_TensorStoreData->zipMemoryArchiveOpen = false;
+    m_TensorStoreData->ClearWriteStore();
     // Attempt to read a non-existent file from the in-memory zip to close the current one
     nlohmann::json temp;
-    bool           wasRead = jsonRead(m_EmptyZipFileName + "/non-existent.json", temp, "zip_memory", m_TensorStoreData->tsContext);
+    bool           wasRead =
+      jsonRead(m_EmptyZipFileName + "/non-existent.json", temp, "zip_memory", m_TensorStoreData->tsContext);
     assert(wasRead == false);
   }
 }
 
 
+void
+OMEZarrNGFFImageIO::BeginZipArchive()
+{
+  m_TensorStoreData->zipWriter = std::make_unique<OMEZarrNGFFZipStreamWriter>(m_FileName);
+
+  nlohmann::json stagingSpec = { { "driver", "memory" } };
+  auto           stagingFuture = tensorstore::kvstore::Open(stagingSpec, m_TensorStoreData->tsContext);
+  TS_EVAL_CHECK(stagingFuture);
+  m_TensorStoreData->zipStaging = stagingFuture.value();
+
+  // Discard anything left over from an earlier write of the same archive
+  auto deleteFuture = tensorstore::kvstore::DeleteRange(m_TensorStoreData->zipStaging,
+                                                        tensorstore::KeyRange::Prefix(m_FileName + "/"));
+  TS_EVAL_CHECK(deleteFuture);
+
+  m_TensorStoreData->zipStagedKeys = { ".zgroup", ".zattrs", MakePath(this->GetDatasetIndex()) + "/.zarray" };
+}
+
+
+void
+OMEZarrNGFFImageIO::AppendWrittenChunkToZipArchive(const ImageIORegion &               storeIORegion,
+                                                   const std::vector<IndexValueType> & chunkIndex)
+{
+  const auto & writeStore = m_TensorStoreData->writeStore;
+  const auto   chunkShape = getChunkShape(writeStore);
+  const auto   domainShape = writeStore.domain().shape();
+
+  // A chunk entirely within this stream division is final. A chunk which
+  // straddles its boundary may be modified by another division, so it stays staged.
+  std::vector<tensorstore::Index> cell(chunkIndex.begin(), chunkIndex.end());
+  bool                            isComplete = true;
+  for (unsigned d = 0; d < storeIORegion.GetImageDimension(); ++d)
+  {
+    const tensorstore::Index chunkBegin = cell[d] * chunkShape[d];
+    const tensorstore::Index chunkEnd = std::min(chunkBegin + chunkShape[d], domainShape[d]);
+    const tensorstore::Index regionEnd = storeIORegion.GetIndex(d) + storeIORegion.GetSize(d);
+    isComplete = isComplete && chunkBegin >= storeIORegion.GetIndex(d) && chunkEnd <= regionEnd;
+  }
+  std::string key = MakePath(this->GetDatasetIndex()) + "/" + makeChunkKey(cell);
+  if (isComplete)
+  {
+    this->AppendStagedEntriesToZipArchive({ key });
+  }
+  else
+  {
+    m_TensorStoreData->zipStagedKeys.insert(std::move(key));
+  }
+}
+
+
+void
+OMEZarrNGFFImageIO::AppendStagedEntriesToZipArchive(const std::vector<std::string> & keys)
+{
+  auto & staging = m_TensorStoreData->zipStaging;
+
+  std::vector<tensorstore::Future<tensorstore::kvstore::ReadResult>> readFutures;
+  for (const auto & key : keys)
+  {
+    readFutures.push_back(tensorstore::kvstore::Read(staging, m_FileName + "/" + key));
+  }
+
+  std::vector<tensorstore::Future<tensorstore::TimestampedStorageGeneration>> deleteFutures;
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    auto & result = readFutures[i].result();
+    if (!result.ok())
+    {
+      itkExceptionMacro(<< "tensorstore error while staging zip entry '" << keys[i] << "': " << result.status());
+    }
+    if (result->has_value()) // chunks equal to the fill value are not stored
+    {
+      TraceSpan  span(m_TensorStoreData->trace.get(), "append zip entry", "copy", { { "entry", keys[i] } });
+      absl::Cord value = result->value;
+      auto       flat = value.Flatten();
+      m_TensorStoreData->zipWriter->AddEntry(keys[i], flat.data(), flat.size());
+    }
+    deleteFutures.push_back(tensorstore::kvstore::Delete(staging, m_FileName + "/" + keys[i]));
+    m_TensorStoreData->zipStagedKeys.erase(keys[i]);
+  }
+  for (auto & deleteFuture : deleteFutures)
+  {
+    TS_EVAL_CHECK(deleteFuture);
+  }
+}
+
+
+void
+OMEZarrNGFFImageIO::OpenStoreForUpdate()
+{
+  // The array opened by an earlier Write is reused if it was opened in the same mode, for the same dataset,
+  // and the data type was checked against the same component type. Otherwise the array is reopened.
+  if (m_TensorStoreData->writeStoreMode == m_WriteMode && m_TensorStoreData->writeStoreFileName == m_FileName &&
+      m_TensorStoreData->writeStoreDatasetIndex == this->GetDatasetIndex() &&
+      m_TensorStoreData->writeStoreDType == itkToTensorstoreComponentType(this->GetComponentType()))
+  {
+    return;
+  }
+  this->WaitForPendingWrites();
+  m_TensorStoreData->ClearWriteStore();
+
+  const std::string driver = getKVstoreDriver(m_FileName);
+  if (driver == "zip_memory")
+  {
+    itkExceptionMacro(<< "Updating an existing store is not supported for zip archives: " << m_FileName);
+  }
+
+  nlohmann::json    json;
+  const std::string zattrsFilePath(m_FileName + "/.zattrs");
+  bool              status = jsonRead(zattrsFilePath, json, driver, m_TensorStoreData->tsContext);
+  itkAssertOrThrowMacro(status, ("Failed to read from " + zattrsFilePath));
+  json = json.at("multiscales")[0];
+  if (!json.contains("axes"))
+  {
+    itkExceptionMacro(<< "\"axes\" are required to update an existing OME-Zarr store: " << zattrsFilePath);
+  }
+  m_StoreAxes = parseAxes(json.at("axes"));
+
+  json = json.at("datasets");
+  if (this->GetDatasetIndex() >= json.size())
+  {
+    itkExceptionMacro(<< "Requested DatasetIndex of " << this->GetDatasetIndex()
+                      << " is out of range for the number of datasets (" << json.size()
+                      << ") which exist in OME-NGFF store '" << m_FileName << "'");
+  }
+  const std::string datasetPath = json[this->GetDatasetIndex()].at("path").get<std::string>();
+  const std::string arrayPath = m_FileName + "/" + datasetPath;
+
+  nlohmann::json openSpec = { { "driver", "zarr" }, { "kvstore", { { "driver", driver }, { "path", arrayPath } } } };
+  auto           openFuture = tensorstore::Open(
+    openSpec, m_TensorStoreData->tsContext, tensorstore::OpenMode::open, tensorstore::ReadWriteMode::read_write);
+  TS_EVAL_CHECK(openFuture);
+  m_TensorStoreData->writeStore = openFuture.value();
+  itkAssertOrThrowMacro(m_StoreAxes.size() == m_TensorStoreData->writeStore.rank(),
+                        "Detected mismatch in axis count and store rank");
+  if (itkToTensorstoreComponentType(this->GetComponentType()) != m_TensorStoreData->writeStore.dtype())
+  {
+    itkExceptionMacro(<< "Component type " << GetComponentTypeAsString(this->GetComponentType())
+                      << " does not match the data type of the existing store "
+                      << m_TensorStoreData->writeStore.dtype());
+  }
+
+  // The spatial extent of the image must match the existing store
+  const auto storeAxes = this->GetAxesInStoreOrder();
+  const auto domain = m_TensorStoreData->writeStore.domain();
+  for (size_t storeIndex = 0; storeIndex < storeAxes.size(); ++storeIndex)
+  {
+    const auto & axisName = storeAxes[storeIndex].name;
+    for (unsigned d = 0; d < this->GetNumberOfDimensions() && d < 3; ++d)
+    {
+      if (axisName == dimensionNames[d] && domain.shape()[storeIndex] != static_cast<int64_t>(this->GetDimensions(d)))
+      {
+        itkExceptionMacro(<< "Image size " << this->GetDimensions(d) << " along axis \"" << axisName
+                          << "\" does not match the existing store size " << domain.shape()[storeIndex]);
+      }
+    }
+  }
+  m_TensorStoreData->writeStoreMode = m_WriteMode;
+  m_TensorStoreData->writeStoreFileName = m_FileName;
+  m_TensorStoreData->writeStorePath = datasetPath;
+  m_TensorStoreData->writeStoreDatasetIndex = this->GetDatasetIndex();
+  m_TensorStoreData->writeStoreDType = m_TensorStoreData->writeStore.dtype();
+}
+
+void
+OMEZarrNGFFImageIO::WriteIntoExistingStore(const void * buffer)
+{
+  this->OpenStoreForUpdate();
+
+  const auto storeAxes = this->GetAxesInStoreOrder();
+  for (size_t storeIndex = 0; storeIndex < storeAxes.size(); ++storeIndex)
+  {
+    const auto & axisName = storeAxes[storeIndex].name;
+    if ((axisName == "t" && m_TimeIndex == INVALID_INDEX) || (axisName == "c" && m_ChannelIndex == INVALID_INDEX))
+    {
+      itkExceptionMacro(<< "The existing OME-Zarr store has a \"" << axisName
+                        << "\" axis. The target index along this axis must be specified.");
+    }
+
+    // Grow the time axis to accommodate a new time point.
+    // Resizing only rewrites the array metadata, which tensorstore updates atomically.
+    auto & writeStore = m_TensorStoreData->writeStore;
+    if (axisName == "t" && m_TimeIndex >= writeStore.domain()[storeIndex].exclusive_max())
+    {
+      if (m_WriteMode == WriteModeEnum::Parallel)
+      {
+        itkExceptionMacro(<< "Time index " << m_TimeIndex << " is outside of the store, which parallel writers "
+                          << "do not resize. Create the store with all time points using CreateStore.");
+      }
+      std::vector<tensorstore::Index> inclusiveMin(writeStore.rank(), tensorstore::kImplicit);
+      std::vector<tensorstore::Index> exclusiveMax(writeStore.rank(), tensorstore::kImplicit);
+      exclusiveMax[storeIndex] = m_TimeIndex + 1;
+      auto resizeFuture =
+        tensorstore::Resize(writeStore, inclusiveMin, exclusiveMax, tensorstore::ResizeMode::expand_only);
+      TS_EVAL_CHECK(resizeFuture);
+      writeStore = resizeFuture.value();
+    }
+  }
+
+  const ImageIORegion storeIORegion = this->ConfigureTensorstoreIORegion(m_IORegion);
+  if (m_WriteMode == WriteModeEnum::Parallel)
+  {
+    // A chunk partially written by two writers would be read, modified and written
+    // by each of them, and one of the modifications would be lost
+    const auto chunkShape = getChunkShape(m_TensorStoreData->writeStore);
+    const auto domainShape = m_TensorStoreData->writeStore.domain().shape();
+    for (unsigned d = 0; d < storeIORegion.GetImageDimension(); ++d)
+    {
+      const auto end = storeIORegion.GetIndex(d) + static_cast<IndexValueType>(storeIORegion.GetSize(d));
+      if (storeIORegion.GetIndex(d) % chunkShape[d] != 0 || (end % chunkShape[d] != 0 && end != domainShape[d]))
+      {
+        itkExceptionMacro(<< "The region written in parallel along axis \"" << storeAxes[d].name << "\" from "
+                          << storeIORegion.GetIndex(d) << " to " << end << " is not aligned to its chunk size of "
+                          << chunkShape[d]);
+      }
+    }
+  }
+  if (!TryToWriteToStore(supportedPixelTypes,
+                         this->GetComponentType(),
+                         m_TensorStoreData->writeStore,
+                         m_TensorStoreData->tsContext,
+                         m_FileName,
+                         MakePath(this->GetDatasetIndex()),
+                         nlohmann::json{},
+                         nlohmann::json{},
+                         false,
+                         storeIORegion,
+                         buffer,
+                         m_AsynchronousWrite ? &m_TensorStoreData->pendingWrites : nullptr,
+                         makeChunkProgress(this, m_TensorStoreData->trace, "write chunk")))
+  {
+    itkExceptionMacro("Unsupported component type: " << GetComponentTypeAsString(this->GetComponentType()));
+  }
+}
+
+void
+OMEZarrNGFFImageIO::CreateStore()
+{
+  if (hasSuffix(m_FileName, ".zip") || hasSuffix(m_FileName, ".memory"))
+  {
+    itkExceptionMacro(<< "Creating a store for parallel writes is not supported for zip archives: " << m_FileName);
+  }
+  const IOComponentEnum componentType{ this->GetComponentType() };
+  if (itkToTensorstoreComponentType(componentType) == tensorstore::dtype_v<void>)
+  {
+    itkExceptionMacro("Unsupported component type: " << GetComponentTypeAsString(componentType));
+  }
+
+  this->FinalizeWrite(); // do not delete an array which is still being written
+  m_TensorStoreData->ClearWriteStore();
+  this->WriteImageInformation();
+
+  const unsigned       nDims = this->GetNumberOfDimensions();
+  std::vector<int64_t> shape(nDims);
+  for (unsigned d = 0; d < nDims; ++d)
+  {
+    shape[nDims - 1 - d] = this->GetDimensions(d); // convert IJK into KJI
+  }
+  std::string compressor = this->GetCompressor();
+  std::transform(compressor.begin(), compressor.end(), compressor.begin(), ::toupper);
+
+  // Parallel writers write one time point and channel at a time. Without a chunk size,
+  // tensorstore would choose chunks spanning several of them, which two writers would then share.
+  nlohmann::json chunkLayout;
+  if (m_ChunkSize.empty() && nDims > 3)
+  {
+    std::vector<int64_t> chunkShape(nDims, 0); // unconstrained along the spatial axes
+    for (unsigned d = 3; d < nDims; ++d)
+    {
+      chunkShape[nDims - 1 - d] = 1;
+    }
+    chunkLayout = { { "chunk", { { "shape", chunkShape } } } };
+  }
+
+  // Creating the array writes its metadata. The empty region writes no chunks.
+  TraceSpan span(m_TensorStoreData->trace.get(), "CreateStore", "io", { { "file", m_FileName } });
+  TryToWriteToStore(supportedPixelTypes,
+                    componentType,
+                    m_TensorStoreData->writeStore,
+                    m_TensorStoreData->tsContext,
+                    m_FileName,
+                    MakePath(this->GetDatasetIndex()),
+                    makeArrayMetadata(shape, compressor, this->GetCompressionLevel(), m_ChunkSize),
+                    chunkLayout,
+                    true,
+                    ImageIORegion(nDims),
+                    nullptr,
+                    nullptr,
+                    ChunkProgress{});
+}
+
+void
+OMEZarrNGFFImageIO::WaitForPendingWrites()
+{
+  this->WaitForOldestPendingWrites(m_TensorStoreData->pendingWrites.size());
+}
+
+SizeValueType
+OMEZarrNGFFImageIO::GetNumberOfPendingWrites() const
+{
+  return m_TensorStoreData->pendingWrites.size();
+}
+
+void
+OMEZarrNGFFImageIO::WaitForOldestPendingWrites(SizeValueType numberOfWrites)
+{
+  // The writes are pending in the order they were issued
+  auto &     queue = m_TensorStoreData->pendingWrites;
+  const auto last = queue.begin() + std::min<size_t>(numberOfWrites, queue.size());
+  std::vector<tensorstore::Future<void>> pendingWrites(std::make_move_iterator(queue.begin()),
+                                                       std::make_move_iterator(last));
+  queue.erase(queue.begin(), last);
+
+  // Wait for all of the writes, even if some of them failed
+  std::string errors;
+  for (auto & writeFuture : pendingWrites)
+  {
+    auto result = writeFuture.result();
+    if (!result.ok())
+    {
+      errors += "\n" + result.status().ToString();
+    }
+  }
+  if (!errors.empty())
+  {
+    itkExceptionMacro(<< "tensorstore error while completing pending writes:" << errors);
+  }
+}
+
+
 ImageIORegion
 OMEZarrNGFFImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
 {
@@ -871,4 +4437,120 @@ OMEZarrNGFFImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageI
   return requestedRegion;
 }
 
+OMEZarrNGFFReadStatistics &
+OMEZarrNGFFReadStatistics::operator+=(const OMEZarrNGFFReadStatistics & other)
+{
+  bytesFetched += other.bytesFetched;
+  chunksRequested += other.chunksRequested;
+  cacheHits += other.cacheHits;
+  cacheMisses += other.cacheMisses;
+  readAheadHits += other.readAheadHits;
+  readAheadMisses += other.readAheadMisses;
+  chunksReadAhead += other.chunksReadAhead;
+  chunksDecodedBlockwise += other.chunksDecodedBlockwise;
+  openSeconds += other.openSeconds;
+  fetchSeconds += other.fetchSeconds;
+  decodeSeconds += other.decodeSeconds;
+  copySeconds += other.copySeconds;
+  readSeconds += other.readSeconds;
+  return *this;
+}
+
+std::ostream &
+operator<<(std::ostream & out, const OMEZarrNGFFReadStatistics & statistics)
+{
+  return out << "{ bytesFetched: " << statistics.bytesFetched << ", chunksRequested: " << statistics.chunksRequested
+             << ", cacheHits: " << statistics.cacheHits << ", cacheMisses: " << statistics.cacheMisses
+             << ", readAheadHits: " << statistics.readAheadHits << ", readAheadMisses: " << statistics.readAheadMisses
+             << ", chunksReadAhead: " << statistics.chunksReadAhead
+             << ", chunksDecodedBlockwise: " << statistics.chunksDecodedBlockwise
+             << ", openSeconds: " << statistics.openSeconds << ", fetchSeconds: " << statistics.fetchSeconds
+             << ", decodeSeconds: " << statistics.decodeSeconds << ", copySeconds: " << statistics.copySeconds
+             << ", readSeconds: " << statistics.readSeconds << " }";
+}
+
+double
+OMEZarrNGFFRegionStatistics::GetMean() const
+{
+  return count > 0 ? sum / count : 0.0;
+}
+
+double
+OMEZarrNGFFRegionStatistics::GetVariance() const
+{
+  const double mean = this->GetMean();
+  return count > 0 ? std::max(0.0, sumOfSquares / count - mean * mean) : 0.0;
+}
+
+double
+OMEZarrNGFFRegionStatistics::GetStandardDeviation() const
+{
+  return std::sqrt(this->GetVariance());
+}
+
+OMEZarrNGFFRegionStatistics &
+OMEZarrNGFFRegionStatistics::operator+=(const OMEZarrNGFFRegionStatistics & other)
+{
+  itkAssertOrThrowMacro(histogram.size() == other.histogram.size() && histogramMinimum == other.histogramMinimum &&
+                          histogramMaximum == other.histogramMaximum,
+                        "Only statistics with the same histogram bins can be merged");
+  count += other.count;
+  minimum = std::min(minimum, other.minimum);
+  maximum = std::max(maximum, other.maximum);
+  sum += other.sum;
+  sumOfSquares += other.sumOfSquares;
+  for (size_t b = 0; b < histogram.size(); ++b)
+  {
+    histogram[b] += other.histogram[b];
+  }
+  return *this;
+}
+
+std::ostream &
+operator<<(std::ostream & out, const OMEZarrNGFFRegionStatistics & statistics)
+{
+  return out << "{ count: " << statistics.count << ", minimum: " << statistics.minimum
+             << ", maximum: " << statistics.maximum << ", mean: " << statistics.GetMean()
+             << ", standardDeviation: " << statistics.GetStandardDeviation()
+             << ", histogramBins: " << statistics.histogram.size() << " }";
+}
+
+std::ostream &
+operator<<(std::ostream & out, const OMEZarrNGFFImageIOEnums::WriteMode value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case OMEZarrNGFFImageIOEnums::WriteMode::Overwrite:
+        return "itk::OMEZarrNGFFImageIOEnums::WriteMode::Overwrite";
+      case OMEZarrNGFFImageIOEnums::WriteMode::Update:
+        return "itk::OMEZarrNGFFImageIOEnums::WriteMode::Update";
+      case OMEZarrNGFFImageIOEnums::WriteMode::Parallel:
+        return "itk::OMEZarrNGFFImageIOEnums::WriteMode::Parallel";
+      default:
+        return "INVALID VALUE FOR itk::OMEZarrNGFFImageIOEnums::WriteMode";
+    }
+  }();
+}
+
+std::ostream &
+operator<<(std::ostream & out, const OMEZarrNGFFImageIOEnums::Projection value)
+{
+  return out << [value] {
+    switch (value)
+    {
+      case OMEZarrNGFFImageIOEnums::Projection::Maximum:
+        return "itk::OMEZarrNGFFImageIOEnums::Projection::Maximum";
+      case OMEZarrNGFFImageIOEnums::Projection::Minimum:
+        return "itk::OMEZarrNGFFImageIOEnums::Projection::Minimum";
+      case OMEZarrNGFFImageIOEnums::Projection::Mean:
+        return "itk::OMEZarrNGFFImageIOEnums::Projection::Mean";
+      case OMEZarrNGFFImageIOEnums::Projection::Sum:
+        return "itk::OMEZarrNGFFImageIOEnums::Projection::Sum";
+      default:
+        return "INVALID VALUE FOR itk::OMEZarrNGFFImageIOEnums::Projection";
+    }
+  }();
+}
+
 } // end namespace itk
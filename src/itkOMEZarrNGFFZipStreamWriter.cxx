@@ -0,0 +1,230 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkOMEZarrNGFFZipStreamWriter.h"
+#include "itkMacro.h"
+#include "itk_zlib.h"
+
+#include <algorithm>
+
+namespace itk
+{
+namespace
+{
+// Record layout is described in the zip "APPNOTE":
+// https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+constexpr uint32_t LocalFileHeaderSignature = 0x04034b50;
+constexpr uint32_t CentralDirectoryHeaderSignature = 0x02014b50;
+constexpr uint32_t Zip64EndOfCentralDirectorySignature = 0x06064b50;
+constexpr uint32_t Zip64EndOfCentralDirectoryLocatorSignature = 0x07064b50;
+constexpr uint32_t EndOfCentralDirectorySignature = 0x06054b50;
+constexpr uint16_t Zip64ExtraFieldTag = 0x0001;
+constexpr uint16_t VersionDefault = 20;
+constexpr uint16_t VersionZip64 = 45;
+constexpr uint16_t FlagUTF8Names = 0x0800;
+constexpr uint16_t MethodStored = 0;
+constexpr uint16_t DosDate1980 = (1 << 5) | 1; // January 1st, 1980
+constexpr uint32_t Max32 = 0xFFFFFFFF;
+constexpr uint16_t Max16 = 0xFFFF;
+
+// Zip records are little-endian
+void
+appendLE(std::string & record, uint64_t value, unsigned bytes)
+{
+  for (unsigned b = 0; b < bytes; ++b)
+  {
+    record.push_back(static_cast<char>((value >> (8 * b)) & 0xFF));
+  }
+}
+
+uint32_t
+computeCRC32(const char * data, uint64_t size)
+{
+  uLong          crc = crc32(0L, Z_NULL, 0);
+  constexpr uInt maxPiece = 1u << 30;
+  const Bytef *  bytes = reinterpret_cast<const Bytef *>(data);
+  while (size > 0)
+  {
+    const uInt piece = static_cast<uInt>(std::min<uint64_t>(size, maxPiece));
+    crc = crc32(crc, bytes, piece);
+    bytes += piece;
+    size -= piece;
+  }
+  return static_cast<uint32_t>(crc);
+}
+} // namespace
+
+OMEZarrNGFFZipStreamWriter::OMEZarrNGFFZipStreamWriter(const std::string & fileName)
+  : m_FileName(fileName)
+  , m_Stream(fileName, std::ios::binary | std::ios::trunc)
+{
+  if (!m_Stream.is_open())
+  {
+    itkGenericExceptionMacro(<< "Could not open zip archive for writing: " << fileName);
+  }
+}
+
+OMEZarrNGFFZipStreamWriter::~OMEZarrNGFFZipStreamWriter()
+{
+  if (this->IsOpen())
+  {
+    try
+    {
+      this->Close();
+    }
+    catch (const ExceptionObject & e)
+    {
+      // The image IO closes its archive by FinalizeWrite, which throws instead
+      itkGenericOutputMacro(<< "Failed to close zip archive " << m_FileName << ": " << e.GetDescription());
+    }
+  }
+}
+
+void
+OMEZarrNGFFZipStreamWriter::AddEntry(const std::string & name, const char * data, uint64_t size)
+{
+  itkAssertOrThrowMacro(this->IsOpen(), "Cannot add an entry to a closed zip archive: " + m_FileName);
+  itkAssertOrThrowMacro(name.size() <= Max16, "Zip entry name is too long: " + name);
+
+  Entry      entry{ name, computeCRC32(data, size), size, m_Offset };
+  const bool zip64 = size >= Max32;
+
+  std::string header;
+  appendLE(header, LocalFileHeaderSignature, 4);
+  appendLE(header, zip64 ? VersionZip64 : VersionDefault, 2);
+  appendLE(header, FlagUTF8Names, 2);
+  appendLE(header, MethodStored, 2);
+  appendLE(header, 0, 2); // modification time
+  appendLE(header, DosDate1980, 2);
+  appendLE(header, entry.crc, 4);
+  appendLE(header, zip64 ? Max32 : size, 4); // compressed size
+  appendLE(header, zip64 ? Max32 : size, 4); // uncompressed size
+  appendLE(header, name.size(), 2);
+  appendLE(header, zip64 ? 20 : 0, 2); // extra field length
+  header += name;
+  if (zip64)
+  {
+    appendLE(header, Zip64ExtraFieldTag, 2);
+    appendLE(header, 16, 2);
+    appendLE(header, size, 8); // uncompressed size
+    appendLE(header, size, 8); // compressed size
+  }
+
+  m_Stream.write(header.data(), header.size());
+  m_Stream.write(data, size);
+  if (!m_Stream.good())
+  {
+    itkGenericExceptionMacro(<< "Failed to write entry '" << name << "' to zip archive " << m_FileName);
+  }
+  m_Offset += header.size() + size;
+  m_Entries.push_back(std::move(entry));
+}
+
+void
+OMEZarrNGFFZipStreamWriter::Close()
+{
+  itkAssertOrThrowMacro(this->IsOpen(), "Zip archive is already closed: " + m_FileName);
+
+  const uint64_t centralDirectoryOffset = m_Offset;
+  std::string    centralDirectory;
+  for (const auto & entry : m_Entries)
+  {
+    const bool  sizeZip64 = entry.size >= Max32;
+    const bool  offsetZip64 = entry.offset >= Max32;
+    std::string extra;
+    if (sizeZip64 || offsetZip64)
+    {
+      std::string fields;
+      if (sizeZip64)
+      {
+        appendLE(fields, entry.size, 8); // uncompressed size
+        appendLE(fields, entry.size, 8); // compressed size
+      }
+      if (offsetZip64)
+      {
+        appendLE(fields, entry.offset, 8);
+      }
+      appendLE(extra, Zip64ExtraFieldTag, 2);
+      appendLE(extra, fields.size(), 2);
+      extra += fields;
+    }
+    const uint16_t version = extra.empty() ? VersionDefault : VersionZip64;
+
+    appendLE(centralDirectory, CentralDirectoryHeaderSignature, 4);
+    appendLE(centralDirectory, VersionZip64, 2); // version made by
+    appendLE(centralDirectory, version, 2);      // version needed to extract
+    appendLE(centralDirectory, FlagUTF8Names, 2);
+    appendLE(centralDirectory, MethodStored, 2);
+    appendLE(centralDirectory, 0, 2); // modification time
+    appendLE(centralDirectory, DosDate1980, 2);
+    appendLE(centralDirectory, entry.crc, 4);
+    appendLE(centralDirectory, sizeZip64 ? Max32 : entry.size, 4); // compressed size
+    appendLE(centralDirectory, sizeZip64 ? Max32 : entry.size, 4); // uncompressed size
+    appendLE(centralDirectory, entry.name.size(), 2);
+    appendLE(centralDirectory, extra.size(), 2);
+    appendLE(centralDirectory, 0, 2); // comment length
+    appendLE(centralDirectory, 0, 2); // disk number
+    appendLE(centralDirectory, 0, 2); // internal attributes
+    appendLE(centralDirectory, 0, 4); // external attributes
+    appendLE(centralDirectory, offsetZip64 ? Max32 : entry.offset, 4);
+    centralDirectory += entry.name;
+    centralDirectory += extra;
+  }
+  const uint64_t centralDirectorySize = centralDirectory.size();
+  const uint64_t entryCount = m_Entries.size();
+
+  std::string end;
+  if (entryCount >= Max16 || centralDirectorySize >= Max32 || centralDirectoryOffset >= Max32)
+  {
+    const uint64_t zip64EndOffset = centralDirectoryOffset + centralDirectorySize;
+    appendLE(end, Zip64EndOfCentralDirectorySignature, 4);
+    appendLE(end, 44, 8); // size of the remaining record
+    appendLE(end, VersionZip64, 2);
+    appendLE(end, VersionZip64, 2);
+    appendLE(end, 0, 4); // this disk
+    appendLE(end, 0, 4); // disk with central directory
+    appendLE(end, entryCount, 8);
+    appendLE(end, entryCount, 8);
+    appendLE(end, centralDirectorySize, 8);
+    appendLE(end, centralDirectoryOffset, 8);
+
+    appendLE(end, Zip64EndOfCentralDirectoryLocatorSignature, 4);
+    appendLE(end, 0, 4); // disk with zip64 end of central directory
+    appendLE(end, zip64EndOffset, 8);
+    appendLE(end, 1, 4); // total number of disks
+  }
+  appendLE(end, EndOfCentralDirectorySignature, 4);
+  appendLE(end, 0, 2); // this disk
+  appendLE(end, 0, 2); // disk with central directory
+  appendLE(end, std::min<uint64_t>(entryCount, Max16), 2);
+  appendLE(end, std::min<uint64_t>(entryCount, Max16), 2);
+  appendLE(end, std::min<uint64_t>(centralDirectorySize, Max32), 4);
+  appendLE(end, std::min<uint64_t>(centralDirectoryOffset, Max32), 4);
+  appendLE(end, 0, 2); // comment length
+
+  m_Stream.write(centralDirectory.data(), centralDirectory.size());
+  m_Stream.write(end.data(), end.size());
+  m_Stream.close();
+  m_Entries.clear();
+  if (m_Stream.fail())
+  {
+    itkGenericExceptionMacro(<< "Failed to write central directory of zip archive " << m_FileName);
+  }
+}
+
+} // end namespace itk
@@ -0,0 +1,86 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkTestingMacros.h"
+
+int
+itkOMEZarrNGFFAsynchronousWriteTest(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Input Output [numberOfStreamDivisions]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char *   inputFileName = argv[1];
+  const char *   outputFileName = argv[2];
+  const unsigned numberOfStreamDivisions = (argc > 3 ? std::atoi(argv[3]) : 4);
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  using ImageType = itk::Image<unsigned char, 2>;
+  auto image = itk::ReadImage<ImageType>(inputFileName);
+
+  // Write in several stream divisions, each returning before its data is stored
+  auto zarrIO = itk::OMEZarrNGFFImageIO::New();
+  ITK_TEST_SET_GET_BOOLEAN(zarrIO, AsynchronousWrite, true);
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(outputFileName);
+  writer->SetImageIO(zarrIO);
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(zarrIO->WaitForPendingWrites());
+
+  // Read back and validate all stream divisions were stored
+  auto readImage = itk::ReadImage<ImageType>(outputFileName);
+  ITK_TEST_EXPECT_EQUAL(readImage->GetLargestPossibleRegion(), image->GetLargestPossibleRegion());
+
+  using IteratorType = itk::ImageRegionConstIteratorWithIndex<ImageType>;
+  IteratorType it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    auto index = it.GetIndex();
+    itkAssertOrThrowMacro(it.Get() == readImage->GetPixel(index), "Pixel value mismatch at index " << index);
+  }
+
+  // A division away from the origin needs the array of its file, component type and size
+  // created by the division at the origin
+  itk::ImageIORegion row(2);
+  row.SetIndex(1, image->GetLargestPossibleRegion().GetSize(1) / 2);
+  row.SetSize(0, image->GetLargestPossibleRegion().GetSize(0));
+  row.SetSize(1, 1);
+  zarrIO->SetIORegion(row);
+  ITK_TRY_EXPECT_NO_EXCEPTION(zarrIO->Write(image->GetBufferPointer()));
+  ITK_TRY_EXPECT_NO_EXCEPTION(zarrIO->WaitForPendingWrites());
+  zarrIO->SetComponentType(itk::IOComponentEnum::USHORT);
+  ITK_TRY_EXPECT_EXCEPTION(zarrIO->Write(image->GetBufferPointer()));
+  zarrIO->SetComponentType(itk::IOComponentEnum::UCHAR);
+  zarrIO->SetFileName(std::string(outputFileName) + ".other.zarr");
+  ITK_TRY_EXPECT_EXCEPTION(zarrIO->Write(image->GetBufferPointer()));
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
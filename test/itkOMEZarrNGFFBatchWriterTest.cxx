@@ -0,0 +1,167 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Appends many small volumes and slices to one store each,
+/// then reads each of them back.
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkOMEZarrNGFFBatchWriter.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = unsigned short;
+
+constexpr unsigned NumberOfImages = 50;
+
+// Image `imageIndex` holds pixel values after those of the previous images
+template <typename TImage>
+itk::SizeValueType
+imageBase(const typename TImage::SizeType & size, const unsigned imageIndex)
+{
+  return imageIndex * size.CalculateProductOfElements();
+}
+
+template <typename TImage>
+typename TImage::Pointer
+makeImage(const typename TImage::SizeType & size, const unsigned imageIndex)
+{
+  return OMEZarrNGFFTest::MakeImage<TImage>(size, imageBase<TImage>(size, imageIndex), 0.25);
+}
+
+// Checks that image `imageIndex` of the store holds `expectedIndex`, or 0 if that is negative
+template <typename TImage>
+void
+checkImage(itk::OMEZarrNGFFImageIO *       readIO,
+           const typename TImage::SizeType & size,
+           const unsigned                    imageIndex,
+           const int                         expectedIndex)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  itk::ImageIORegion ioRegion(3);
+  for (unsigned d = 0; d < 3; ++d)
+  {
+    ioRegion.SetSize(d, d < TImage::ImageDimension ? size[d] : 1);
+  }
+  readIO->ReadRegion(ioRegion, imageIndex, 0, image->GetBufferPointer());
+  const itk::SizeValueType base = expectedIndex < 0 ? 0 : imageBase<TImage>(size, expectedIndex);
+  itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const PixelType expected =
+      expectedIndex < 0 ? 0 : OMEZarrNGFFTest::ExpectedValue<PixelType>(it.GetIndex(), size, base);
+    itkAssertOrThrowMacro(it.Get() == expected,
+                          "Pixel value mismatch at " << it.GetIndex() << " of image " << imageIndex);
+  }
+}
+} // namespace
+
+int
+itkOMEZarrNGFFBatchWriterTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " OutputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  // Volumes, each in a chunk of its own
+  using VolumeType = itk::Image<PixelType, 3>;
+  const auto volumeSize = itk::MakeSize(9, 7, 5);
+  const auto volumeFileName = outputDirectory + "/batchVolumes.zarr";
+  auto       volumeWriter = itk::OMEZarrNGFFBatchWriter<VolumeType>::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(volumeWriter, OMEZarrNGFFBatchWriter, Object);
+  ITK_TRY_EXPECT_EXCEPTION(volumeWriter->Append(makeImage<VolumeType>(volumeSize, 0))); // no NumberOfImages
+  volumeWriter->SetFileName(volumeFileName);
+  ITK_TEST_SET_GET_VALUE(volumeFileName, std::string(volumeWriter->GetFileName()));
+  volumeWriter->SetNumberOfImages(NumberOfImages);
+  ITK_TEST_SET_GET_VALUE(NumberOfImages, volumeWriter->GetNumberOfImages());
+  volumeWriter->SetMaximumNumberOfPendingImages(16);
+  ITK_TEST_SET_GET_VALUE(16u, volumeWriter->GetMaximumNumberOfPendingImages());
+
+  // The last image is left unwritten
+  for (unsigned i = 0; i + 1 < NumberOfImages; ++i)
+  {
+    const itk::SizeValueType index = volumeWriter->Append(makeImage<VolumeType>(volumeSize, i));
+    ITK_TEST_EXPECT_EQUAL(index, i);
+  }
+  ITK_TRY_EXPECT_EXCEPTION(volumeWriter->Append(makeImage<VolumeType>(itk::MakeSize(9, 7, 4), 0)));
+  ITK_TEST_EXPECT_EQUAL(volumeWriter->GetNumberOfAppendedImages(), NumberOfImages - 1);
+  ITK_TRY_EXPECT_NO_EXCEPTION(volumeWriter->Flush());
+
+  auto readIO = itk::OMEZarrNGFFImageIO::New();
+  readIO->SetFileName(volumeFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(readIO->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(readIO->GetNumberOfDimensions(), 5);
+  ITK_TEST_EXPECT_EQUAL(readIO->GetDimensions(4), NumberOfImages);
+  ITK_TEST_EXPECT_EQUAL(readIO->GetSpacing(2), 0.25);
+  const auto chunkSize = readIO->GetStoreChunkSize();
+  ITK_TEST_EXPECT_EQUAL(chunkSize[0], 9);
+  ITK_TEST_EXPECT_EQUAL(chunkSize[4], 1);
+  for (unsigned i = 0; i + 1 < NumberOfImages; ++i)
+  {
+    ITK_TRY_EXPECT_NO_EXCEPTION(checkImage<VolumeType>(readIO, volumeSize, i, i));
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkImage<VolumeType>(readIO, volumeSize, NumberOfImages - 1, -1));
+
+  // The store is full after the last image
+  const itk::SizeValueType lastIndex = volumeWriter->Append(makeImage<VolumeType>(volumeSize, 7));
+  ITK_TEST_EXPECT_EQUAL(lastIndex, NumberOfImages - 1);
+  ITK_TRY_EXPECT_EXCEPTION(volumeWriter->Append(makeImage<VolumeType>(volumeSize, 7)));
+  ITK_TRY_EXPECT_NO_EXCEPTION(volumeWriter->Close());
+  ITK_TEST_EXPECT_EQUAL(volumeWriter->GetNumberOfAppendedImages(), 0);
+  ITK_TRY_EXPECT_NO_EXCEPTION(readIO->ReadImageInformation());
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkImage<VolumeType>(readIO, volumeSize, NumberOfImages - 1, 7));
+
+  // Slices, in chunks smaller than the slices
+  using SliceType = itk::Image<PixelType, 2>;
+  const auto sliceSize = itk::MakeSize(12, 10);
+  const auto sliceFileName = outputDirectory + "/batchSlices.zarr";
+  auto       sliceWriter = itk::OMEZarrNGFFBatchWriter<SliceType>::New();
+  sliceWriter->SetFileName(sliceFileName);
+  sliceWriter->SetNumberOfImages(NumberOfImages);
+  sliceWriter->SetChunkSize(itk::MakeSize(8, 0));
+  sliceWriter->SetCompressor("ZSTD");
+  for (unsigned i = 0; i < NumberOfImages; ++i)
+  {
+    ITK_TRY_EXPECT_NO_EXCEPTION(sliceWriter->Append(makeImage<SliceType>(sliceSize, NumberOfImages - i)));
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(sliceWriter->Close());
+
+  readIO->SetFileName(sliceFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(readIO->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(readIO->GetDimensions(2), 1);
+  ITK_TEST_EXPECT_EQUAL(readIO->GetStoreChunkSize()[0], 8);
+  ITK_TEST_EXPECT_EQUAL(readIO->GetStoreChunkSize()[1], 10);
+  for (unsigned i = 0; i < NumberOfImages; ++i)
+  {
+    ITK_TRY_EXPECT_NO_EXCEPTION(checkImage<SliceType>(readIO, sliceSize, i, NumberOfImages - i));
+  }
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,316 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Measures write and read throughput, latency to the first pixel and the increase of resident memory
+/// of OMEZarrNGFFImageIO over a matrix of storage drivers, compressors,
+/// chunk shapes, pixel types and region of interest sizes.
+/// Results are written as JSON, one record per combination.
+///
+/// Stores which are read through HTTP must be served from the output directory,
+/// e.g. `python -m http.server --directory <outputDirectory> 8000`
+/// together with `--http-base-url http://localhost:8000`.
+
+#include "itkOMEZarrNGFFBenchmarkUtilities.h"
+
+#include "itkImageFileWriter.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itksys/SystemTools.hxx"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+namespace
+{
+using namespace OMEZarrNGFFBenchmark;
+
+struct Configuration
+{
+  std::string                     outputDirectory;
+  std::string                     httpBaseURL;
+  itk::SizeValueType              volumeSize = 256;
+  unsigned                        numberOfROIReads = 32;
+  std::vector<std::string>        pixelTypes{ "uint8", "uint16", "float32" };
+  std::vector<std::string>        compressors{ "blosc", "zstd", "zlib", "none" };
+  std::vector<itk::SizeValueType> chunkSizes{ 32, 64, 128 };
+  std::vector<itk::SizeValueType> roiSizes{ 16, 64 };
+  std::vector<std::string>        drivers{ "file", "zip", "memory" };
+};
+
+itk::OMEZarrNGFFImageIO::Pointer
+openForRead(const std::string & fileName)
+{
+  auto zarrIO = itk::OMEZarrNGFFImageIO::New();
+  zarrIO->SetFileName(fileName);
+  zarrIO->ReadImageInformation();
+  return zarrIO;
+}
+
+template <typename TPixel>
+void
+readRegion(itk::OMEZarrNGFFImageIO * zarrIO, const itk::Index<3> & start, const itk::Size<3> & size, TPixel * buffer)
+{
+  itk::ImageIORegion region(3);
+  for (unsigned d = 0; d < 3; ++d)
+  {
+    region.SetIndex(d, start[d]);
+    region.SetSize(d, size[d]);
+  }
+  zarrIO->SetIORegion(region);
+  zarrIO->Read(buffer);
+}
+
+/** Reads the stored image in full, single voxels and random regions of interest,
+ * adding the measurements to the record. */
+template <typename TPixel>
+void
+measureReads(const Configuration & config, const std::string & readFileName, JSONRecord & record)
+{
+  const itk::SizeValueType n = config.volumeSize;
+  const double             megabytes = double(n) * n * n * sizeof(TPixel) / (1024.0 * 1024.0);
+
+  // Latency to the first pixel includes opening the store and reading its metadata
+  auto   start = Clock::now();
+  auto   zarrIO = openForRead(readFileName);
+  TPixel voxel;
+  readRegion(zarrIO.GetPointer(), itk::Index<3>{ { 0, 0, 0 } }, itk::Size<3>{ { 1, 1, 1 } }, &voxel);
+  record.Add("first_pixel_latency_s", SecondsSince(start));
+
+  std::vector<TPixel> volume(n * n * n);
+  start = Clock::now();
+  zarrIO = openForRead(readFileName);
+  readRegion(zarrIO.GetPointer(), itk::Index<3>{ { 0, 0, 0 } }, itk::Size<3>{ { n, n, n } }, volume.data());
+  const double readSeconds = SecondsSince(start);
+  record.Add("read_s", readSeconds);
+  record.Add("read_MBps", megabytes / readSeconds);
+
+  std::mt19937 generator(42); // same regions for every combination
+  for (const auto roiSize : config.roiSizes)
+  {
+    if (roiSize > n)
+    {
+      continue;
+    }
+    std::uniform_int_distribution<itk::IndexValueType> offset(0, n - roiSize);
+    std::vector<TPixel>                                roi(roiSize * roiSize * roiSize);
+    std::vector<double>                                latencies;
+    start = Clock::now();
+    for (unsigned r = 0; r < config.numberOfROIReads; ++r)
+    {
+      const auto roiStart = Clock::now();
+      readRegion(zarrIO.GetPointer(),
+                 itk::Index<3>{ { offset(generator), offset(generator), offset(generator) } },
+                 itk::Size<3>{ { roiSize, roiSize, roiSize } },
+                 roi.data());
+      latencies.push_back(SecondsSince(roiStart));
+    }
+    const double roiSeconds = SecondsSince(start);
+    const double roiMegabytes =
+      double(config.numberOfROIReads) * roiSize * roiSize * roiSize * sizeof(TPixel) / (1024.0 * 1024.0);
+    const std::string prefix = "roi" + std::to_string(roiSize) + "_";
+    record.Add(prefix + "MBps", roiMegabytes / roiSeconds);
+    record.Add(prefix + "p50_s", Percentile(latencies, 50));
+    record.Add(prefix + "p99_s", Percentile(latencies, 99));
+  }
+}
+
+template <typename TPixel>
+void
+runPixelType(const Configuration & config, std::vector<JSONRecord> & results)
+{
+  using ImageType = itk::Image<TPixel, 3>;
+  const itk::SizeValueType n = config.volumeSize;
+  const double             megabytes = double(n) * n * n * sizeof(TPixel) / (1024.0 * 1024.0);
+  auto                     image = MakeSyntheticVolume<TPixel>(itk::Size<3>{ { n, n, n } });
+  const std::string        pixelType =
+    itk::ImageIOBase::GetComponentTypeAsString(itk::ImageIOBase::MapPixelType<TPixel>::CType);
+
+  for (const auto & compressor : config.compressors)
+  {
+    for (const auto chunkSize : config.chunkSizes)
+    {
+      for (const auto & driver : config.drivers)
+      {
+        const std::string caseName = pixelType + "_" + compressor + "_c" + std::to_string(chunkSize);
+        itk::OMEZarrNGFFImageIO::BufferInfo bufferInfo{ nullptr, 0 };
+        std::string                         fileName;
+        if (driver == "memory")
+        {
+          fileName = itk::OMEZarrNGFFImageIO::MakeMemoryFileName(bufferInfo);
+        }
+        else
+        {
+          fileName = config.outputDirectory + "/" + caseName + (driver == "zip" ? ".zarr.zip" : ".zarr");
+        }
+        std::cout << driver << " " << caseName << std::endl;
+
+        const auto makeRecord = [&](const std::string & driverName) {
+          JSONRecord record;
+          record.Add("driver", driverName);
+          record.Add("pixel_type", pixelType);
+          record.Add("compressor", compressor);
+          record.Add("chunk_size", std::vector<itk::SizeValueType>{ chunkSize, chunkSize, chunkSize });
+          record.Add("volume_size", std::vector<itk::SizeValueType>{ n, n, n });
+          return record;
+        };
+        JSONRecord             record = makeRecord(driver);
+        ResidentSetSizeMonitor memory;
+
+        auto zarrIO = itk::OMEZarrNGFFImageIO::New();
+        zarrIO->SetCompressor(compressor == "none" ? "NONE" : compressor);
+        zarrIO->SetChunkSize({ chunkSize, chunkSize, chunkSize });
+        auto writer = itk::ImageFileWriter<ImageType>::New();
+        writer->SetInput(image);
+        writer->SetFileName(fileName);
+        writer->SetImageIO(zarrIO);
+        auto start = Clock::now();
+        writer->Update();
+        zarrIO->FinalizeWrite();
+        const double writeSeconds = SecondsSince(start);
+        record.Add("write_s", writeSeconds);
+        record.Add("write_MBps", megabytes / writeSeconds);
+        if (driver == "memory")
+        {
+          record.Add("stored_bytes", uint64_t(bufferInfo.size));
+        }
+        else if (driver == "zip")
+        {
+          record.Add("stored_bytes", uint64_t(itksys::SystemTools::FileLength(fileName)));
+        }
+
+        measureReads<TPixel>(config, fileName, record);
+        record.Add("rss_increase_bytes", memory.Stop());
+        results.push_back(record);
+
+        if (driver == "file" && !config.httpBaseURL.empty())
+        {
+          JSONRecord             httpRecord = makeRecord("http");
+          ResidentSetSizeMonitor httpMemory;
+          measureReads<TPixel>(config, config.httpBaseURL + "/" + caseName + ".zarr", httpRecord);
+          httpRecord.Add("rss_increase_bytes", httpMemory.Stop());
+          results.push_back(httpRecord);
+        }
+
+        if (driver == "memory")
+        {
+          free(bufferInfo.pointer);
+        }
+        else if (driver == "zip")
+        {
+          itksys::SystemTools::RemoveFile(fileName);
+        }
+        else
+        {
+          itksys::SystemTools::RemoveADirectory(fileName);
+        }
+      }
+    }
+  }
+}
+} // namespace
+
+int
+main(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << argv[0] << " outputDirectory results.json [--quick] [--size N] [--http-base-url URL]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Configuration config;
+  config.outputDirectory = argv[1];
+  const std::string resultsFileName = argv[2];
+  bool              quick = false;
+  for (int i = 3; i < argc; ++i)
+  {
+    if (!strcmp(argv[i], "--quick"))
+    {
+      // a small matrix, suitable as a smoke test
+      quick = true;
+      config.volumeSize = 64;
+      config.numberOfROIReads = 4;
+      config.pixelTypes = { "uint8", "float32" };
+      config.compressors = { "blosc", "none" };
+      config.chunkSizes = { 32 };
+      config.roiSizes = { 16 };
+    }
+    else if (!strcmp(argv[i], "--size") && i + 1 < argc)
+    {
+      config.volumeSize = std::stoul(argv[++i]);
+    }
+    else if (!strcmp(argv[i], "--http-base-url") && i + 1 < argc)
+    {
+      config.httpBaseURL = argv[++i];
+    }
+    else
+    {
+      std::cerr << "Unknown argument: " << argv[i] << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+  itksys::SystemTools::MakeDirectory(config.outputDirectory);
+
+  std::vector<JSONRecord> results;
+  try
+  {
+    for (const auto & pixelType : config.pixelTypes)
+    {
+      if (pixelType == "uint8")
+      {
+        runPixelType<uint8_t>(config, results);
+      }
+      else if (pixelType == "uint16")
+      {
+        runPixelType<uint16_t>(config, results);
+      }
+      else if (pixelType == "float32")
+      {
+        runPixelType<float>(config, results);
+      }
+    }
+  }
+  catch (const itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  JSONRecord header;
+  header.Add("benchmark", "OMEZarrNGFFImageIO");
+  header.Add("quick", quick);
+  header.Add("volume_size", uint64_t(config.volumeSize));
+  header.Add("roi_reads_per_size", uint64_t(config.numberOfROIReads));
+
+  std::ofstream resultsFile(resultsFileName);
+  resultsFile << MakeJSONDocument(header, results);
+  if (!resultsFile.good())
+  {
+    std::cerr << "Could not write results to " << resultsFileName << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Wrote " << results.size() << " results to " << resultsFileName << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,228 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkOMEZarrNGFFBenchmarkUtilities_h
+#define itkOMEZarrNGFFBenchmarkUtilities_h
+
+/// Helpers shared by the OME-Zarr benchmark executables:
+/// procedural test volumes, timing, resident memory and JSON records.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#  include <psapi.h>
+#elif defined(__APPLE__)
+#  include <mach/mach.h>
+#else
+#  include <fstream>
+#  include <unistd.h>
+#endif
+
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include <nlohmann/json.hpp>
+
+namespace OMEZarrNGFFBenchmark
+{
+using Clock = std::chrono::steady_clock;
+
+inline double
+SecondsSince(const Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/** Current resident set size of this process, in bytes, or 0 if it cannot be determined. */
+inline uint64_t
+GetResidentSetSize()
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+  {
+    return counters.WorkingSetSize;
+  }
+  return 0;
+#elif defined(__APPLE__)
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t      count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+  {
+    return 0;
+  }
+  return info.resident_size;
+#else
+  std::ifstream statm("/proc/self/statm");
+  uint64_t      totalPages = 0;
+  uint64_t      residentPages = 0;
+  if (!(statm >> totalPages >> residentPages))
+  {
+    return 0;
+  }
+  return residentPages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+/** Samples the resident set size in the background, from construction until Stop,
+ * to measure the memory used by one benchmark configuration. The peak resident set size
+ * reported by the system is a high-water mark over the lifetime of the process, which
+ * the first and largest configurations would set for all of the later ones. */
+class ResidentSetSizeMonitor
+{
+public:
+  ResidentSetSizeMonitor()
+    : m_Baseline(GetResidentSetSize())
+    , m_Peak(m_Baseline)
+    , m_Thread([this]() { this->Sample(); })
+  {}
+
+  ~ResidentSetSizeMonitor() { this->Stop(); }
+
+  ResidentSetSizeMonitor(const ResidentSetSizeMonitor &) = delete;
+  ResidentSetSizeMonitor &
+  operator=(const ResidentSetSizeMonitor &) = delete;
+
+  /** Stops sampling, and returns the highest increase of the resident set size over
+   * its size at construction, in bytes. */
+  uint64_t
+  Stop()
+  {
+    {
+      const std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Stopped = true;
+    }
+    m_Condition.notify_all();
+    if (m_Thread.joinable())
+    {
+      m_Thread.join();
+    }
+    m_Peak = std::max(m_Peak, GetResidentSetSize());
+    return m_Peak - m_Baseline;
+  }
+
+private:
+  void
+  Sample()
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (!m_Stopped)
+    {
+      m_Peak = std::max(m_Peak, GetResidentSetSize());
+      m_Condition.wait_for(lock, std::chrono::milliseconds(5));
+    }
+  }
+
+  std::mutex              m_Mutex;
+  std::condition_variable m_Condition;
+  bool                    m_Stopped = false;
+  const uint64_t          m_Baseline;
+  uint64_t                m_Peak;
+  std::thread             m_Thread; // started last, once the members it uses are initialized
+};
+
+/** Deterministic volume with smooth structure and some noise,
+ * so that compression ratios resemble those of real images. */
+template <typename TPixel>
+typename itk::Image<TPixel, 3>::Pointer
+MakeSyntheticVolume(const itk::Size<3> & size)
+{
+  using ImageType = itk::Image<TPixel, 3>;
+  auto image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  const double low = std::numeric_limits<TPixel>::is_integer ? double(std::numeric_limits<TPixel>::min()) : 0.0;
+  const double high = std::numeric_limits<TPixel>::is_integer ? double(std::numeric_limits<TPixel>::max()) : 1.0;
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    const double smooth = 0.5 + 0.25 * std::sin(0.05 * index[0]) * std::cos(0.07 * index[1]) +
+                          0.15 * std::sin(0.03 * (index[0] + index[1] + index[2]));
+    // cheap integer hash for the noise component
+    uint32_t hash = static_cast<uint32_t>(index[0] * 73856093u ^ index[1] * 19349663u ^ index[2] * 83492791u);
+    hash ^= hash >> 13;
+    hash *= 0x5bd1e995u;
+    hash ^= hash >> 15;
+    const double noise = 0.1 * (double(hash & 0xFFFF) / 0xFFFF);
+    it.Set(static_cast<TPixel>(low + (high - low) * std::min(1.0, std::max(0.0, smooth + noise - 0.05))));
+  }
+  return image;
+}
+
+/** Percentile (0..100) of the given samples, which are sorted in place. */
+inline double
+Percentile(std::vector<double> & samples, const double percentile)
+{
+  if (samples.empty())
+  {
+    return 0.0;
+  }
+  std::sort(samples.begin(), samples.end());
+  const auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * samples.size()));
+  return samples[std::min(samples.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+/** A flat JSON object, built field by field in order. */
+class JSONRecord
+{
+public:
+  template <typename T>
+  void
+  Add(const std::string & name, const T & value)
+  {
+    m_Object[name] = value;
+  }
+
+  const nlohmann::ordered_json &
+  GetObject() const
+  {
+    return m_Object;
+  }
+
+private:
+  nlohmann::ordered_json m_Object = nlohmann::ordered_json::object();
+};
+
+/** A JSON document holding a header record and an array of result records. */
+inline std::string
+MakeJSONDocument(const JSONRecord & header, const std::vector<JSONRecord> & results)
+{
+  nlohmann::ordered_json document;
+  document["header"] = header.GetObject();
+  document["results"] = nlohmann::ordered_json::array();
+  for (const auto & result : results)
+  {
+    document["results"].push_back(result.GetObject());
+  }
+  return document.dump(2) + "\n";
+}
+} // namespace OMEZarrNGFFBenchmark
+
+#endif // itkOMEZarrNGFFBenchmarkUtilities_h
@@ -0,0 +1,161 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Computes per-channel statistics while writing a two channel image,
+/// in one piece and streamed, and reads them back from .zattrs. A single channel
+/// image streamed along z has the range of its histogram grow with each division.
+
+#include <numeric>
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageFileWriter.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<short, 4>; // x, y, z, c
+
+// Channel 0 ramps from 0 to 99 along x, channel 1 is constant except for one bright pixel
+short
+pixelValue(const ImageType::IndexType & index)
+{
+  if (index[3] == 0)
+  {
+    return static_cast<short>(index[0]);
+  }
+  return (index[0] == 3 && index[1] == 4 && index[2] == 5) ? 1000 : -7;
+}
+
+void
+checkStatistics(const std::vector<itk::OMEZarrNGFFChannelStatistics> & statistics, const std::string & fileName)
+{
+  constexpr uint64_t pixelsPerChannel = 100 * 20 * 10;
+  itkAssertOrThrowMacro(statistics.size() == 2, "Expected 2 channels in " << fileName);
+
+  const auto & ramp = statistics[0];
+  itkAssertOrThrowMacro(ramp.count == pixelsPerChannel, "Count mismatch in " << fileName);
+  itkAssertOrThrowMacro(ramp.minimum == 0 && ramp.maximum == 99, "Range mismatch in " << fileName);
+  itkAssertOrThrowMacro(std::abs(ramp.mean - 49.5) < 1e-9, "Mean mismatch in " << fileName);
+  itkAssertOrThrowMacro(ramp.windowStart >= ramp.minimum && ramp.windowStart < 1, "Window start in " << fileName);
+  itkAssertOrThrowMacro(ramp.windowEnd > 98 && ramp.windowEnd <= ramp.maximum, "Window end in " << fileName);
+  itkAssertOrThrowMacro(ramp.histogram.size() == 256, "Histogram size mismatch in " << fileName);
+  itkAssertOrThrowMacro(std::accumulate(ramp.histogram.begin(), ramp.histogram.end(), uint64_t{ 0 }) == ramp.count,
+                        "Histogram total mismatch in " << fileName);
+
+  // The single outlier does not widen the display window
+  const auto & spot = statistics[1];
+  itkAssertOrThrowMacro(spot.count == pixelsPerChannel, "Count mismatch in " << fileName);
+  itkAssertOrThrowMacro(spot.minimum == -7 && spot.maximum == 1000, "Range mismatch in " << fileName);
+  itkAssertOrThrowMacro(std::abs(spot.mean - (-7.0 * (pixelsPerChannel - 1) + 1000) / pixelsPerChannel) < 1e-9,
+                        "Mean mismatch in " << fileName);
+  itkAssertOrThrowMacro(spot.windowEnd < 0, "The window of channel 1 should exclude the outlier in " << fileName);
+  itkAssertOrThrowMacro(spot.histogram.front() == pixelsPerChannel - 1 && spot.histogram.back() == 1,
+                        "Histogram mismatch in " << fileName);
+}
+} // namespace
+
+int
+itkOMEZarrNGFFChannelStatisticsTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " OutputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  auto image = ImageType::New();
+  image->SetRegions(itk::MakeSize(100, 20, 10, 2));
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    it.Set(pixelValue(it.GetIndex()));
+  }
+
+  // Off by default, leaving .zattrs as before
+  auto imageIO = itk::OMEZarrNGFFImageIO::New();
+  ITK_TEST_SET_GET_BOOLEAN(imageIO, ComputeChannelStatistics, false);
+  const std::string plainFileName = outputDirectory + "/channelStatisticsOff.zarr";
+  auto              writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetImageIO(imageIO);
+  writer->SetFileName(plainFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TEST_EXPECT_TRUE(imageIO->GetChannelStatistics().empty());
+
+  auto readIO = itk::OMEZarrNGFFImageIO::New();
+  readIO->SetFileName(plainFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(readIO->ReadImageInformation());
+  ITK_TEST_EXPECT_TRUE(readIO->GetChannelStatistics().empty());
+
+  // In one piece, streamed one channel at a time, and into a zip archive
+  imageIO->ComputeChannelStatisticsOn();
+  for (const auto & [fileName, numberOfStreamDivisions] :
+       std::vector<std::pair<std::string, unsigned>>{ { "/channelStatistics.zarr", 1 },
+                                                      { "/channelStatisticsStreamed.zarr", 5 },
+                                                      { "/channelStatisticsStreamed.zip", 5 } })
+  {
+    const std::string outputFileName = outputDirectory + fileName;
+    writer->SetFileName(outputFileName);
+    writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+    ITK_TRY_EXPECT_NO_EXCEPTION(checkStatistics(imageIO->GetChannelStatistics(), outputFileName));
+
+    readIO = itk::OMEZarrNGFFImageIO::New();
+    readIO->SetFileName(outputFileName);
+    ITK_TRY_EXPECT_NO_EXCEPTION(readIO->ReadImageInformation());
+    ITK_TRY_EXPECT_NO_EXCEPTION(checkStatistics(readIO->GetChannelStatistics(), outputFileName));
+  }
+
+  // Each stream division widens the range of the histogram, which is rebinned
+  using VolumeType = itk::Image<float, 3>;
+  auto volume = VolumeType::New();
+  volume->SetRegions(itk::MakeSize(16, 16, 40));
+  volume->Allocate();
+  itk::ImageRegionIteratorWithIndex<VolumeType> volumeIt(volume, volume->GetLargestPossibleRegion());
+  for (volumeIt.GoToBegin(); !volumeIt.IsAtEnd(); ++volumeIt)
+  {
+    volumeIt.Set(volumeIt.GetIndex()[2] * 0.5f);
+  }
+  auto volumeIO = itk::OMEZarrNGFFImageIO::New();
+  volumeIO->ComputeChannelStatisticsOn();
+  auto volumeWriter = itk::ImageFileWriter<VolumeType>::New();
+  volumeWriter->SetInput(volume);
+  volumeWriter->SetImageIO(volumeIO);
+  volumeWriter->SetFileName(outputDirectory + "/channelStatisticsVolume.zarr");
+  volumeWriter->SetNumberOfStreamDivisions(4);
+  ITK_TRY_EXPECT_NO_EXCEPTION(volumeWriter->Update());
+  const auto & volumeStatistics = volumeIO->GetChannelStatistics();
+  ITK_TEST_EXPECT_EQUAL(volumeStatistics.size(), 1);
+  ITK_TEST_EXPECT_EQUAL(volumeStatistics[0].count, 16 * 16 * 40);
+  ITK_TEST_EXPECT_EQUAL(volumeStatistics[0].minimum, 0.0);
+  ITK_TEST_EXPECT_EQUAL(volumeStatistics[0].maximum, 19.5);
+  ITK_TEST_EXPECT_TRUE(std::abs(volumeStatistics[0].mean - 9.75) < 1e-9);
+  ITK_TEST_EXPECT_EQUAL(
+    std::accumulate(volumeStatistics[0].histogram.begin(), volumeStatistics[0].histogram.end(), uint64_t{ 0 }),
+    volumeStatistics[0].count);
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,175 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Applies a neighborhood operation out of core, chunk by chunk with a halo,
+/// through a tile function and through a filter, and compares the result
+/// with the operation applied to the whole image.
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkOMEZarrNGFFChunkedFilterDriver.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using InputImageType = itk::Image<unsigned short, 3>;
+using OutputImageType = itk::Image<float, 3>;
+using DriverType = itk::OMEZarrNGFFChunkedFilterDriver<InputImageType, OutputImageType>;
+
+// Sum of a pixel and its 6 face neighbors within the buffered region
+float
+neighborSum(const InputImageType * image, const InputImageType::IndexType & index)
+{
+  float sum = image->GetPixel(index);
+  for (unsigned d = 0; d < 3; ++d)
+  {
+    for (const int offset : { -1, 1 })
+    {
+      auto neighbor = index;
+      neighbor[d] += offset;
+      if (image->GetBufferedRegion().IsInside(neighbor))
+      {
+        sum += image->GetPixel(neighbor);
+      }
+    }
+  }
+  return sum;
+}
+
+// The same operation as a filter, to run through a filter factory
+class NeighborSumFilter : public itk::ImageToImageFilter<InputImageType, OutputImageType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(NeighborSumFilter);
+  using Self = NeighborSumFilter;
+  using Superclass = itk::ImageToImageFilter<InputImageType, OutputImageType>;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro(Self);
+
+protected:
+  NeighborSumFilter() { this->DynamicMultiThreadingOn(); }
+
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegion) override
+  {
+    itk::ImageRegionIteratorWithIndex<OutputImageType> it(this->GetOutput(), outputRegion);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      it.Set(neighborSum(this->GetInput(), it.GetIndex()));
+    }
+  }
+};
+} // namespace
+
+int
+itkOMEZarrNGFFChunkedFilterDriverTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " OutputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+  const std::string inputFileName = outputDirectory + "/chunkedFilterInput.zarr";
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  auto image = InputImageType::New();
+  image->SetRegions(itk::MakeSize(40, 36, 20));
+  image->SetSpacing(itk::MakeVector(0.5, 0.5, 2.0));
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<InputImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    it.Set(static_cast<unsigned short>((index[0] * 7 + index[1] * 13 + index[2] * 31) % 1000));
+  }
+  itk::WriteImage(image, inputFileName);
+
+  auto driver = DriverType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(driver, OMEZarrNGFFChunkedFilterDriver, Object);
+  driver->SetInputFileName(inputFileName);
+  driver->SetHalo(itk::MakeSize(1, 1, 1));
+  driver->SetChunkSize(itk::MakeSize(16, 16, 8));
+  driver->SetNumberOfWorkUnits(4);
+
+  // Without a tile function, there is nothing to do
+  driver->SetOutputFileName(outputDirectory + "/chunkedFilterNone.zarr");
+  ITK_TRY_EXPECT_EXCEPTION(driver->Update());
+
+  const auto checkOutput = [&](const std::string & outputFileName) {
+    auto output = itk::ReadImage<OutputImageType>(outputFileName);
+    itkAssertOrThrowMacro(output->GetLargestPossibleRegion() == image->GetLargestPossibleRegion(),
+                          "Region mismatch of " << outputFileName);
+    itkAssertOrThrowMacro(output->GetSpacing() == image->GetSpacing(), "Spacing mismatch of " << outputFileName);
+    itk::ImageRegionIteratorWithIndex<OutputImageType> outputIt(output, output->GetLargestPossibleRegion());
+    for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); ++outputIt)
+    {
+      itkAssertOrThrowMacro(outputIt.Get() == neighborSum(image, outputIt.GetIndex()),
+                            "Pixel value mismatch at index " << outputIt.GetIndex() << " of " << outputFileName);
+    }
+  };
+
+  // A tile function
+  driver->SetTileFunction([](const InputImageType * paddedTile, const DriverType::RegionType & outputRegion) {
+    auto output = OutputImageType::New();
+    output->SetRegions(outputRegion);
+    output->Allocate();
+    itk::ImageRegionIteratorWithIndex<OutputImageType> outputIt(output, outputRegion);
+    for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); ++outputIt)
+    {
+      outputIt.Set(neighborSum(paddedTile, outputIt.GetIndex()));
+    }
+    return output;
+  });
+  driver->SetOutputFileName(outputDirectory + "/chunkedFilterFunction.zarr");
+  ITK_TRY_EXPECT_NO_EXCEPTION(driver->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkOutput(driver->GetOutputFileName()));
+
+  // A new filter for each tile
+  driver->SetFilterFactory([]() { return NeighborSumFilter::New(); });
+  driver->SetOutputFileName(outputDirectory + "/chunkedFilterFilter.zarr");
+  ITK_TRY_EXPECT_NO_EXCEPTION(driver->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkOutput(driver->GetOutputFileName()));
+
+  // An input pixel type which does not match the store
+  auto mismatchedDriver = itk::OMEZarrNGFFChunkedFilterDriver<itk::Image<float, 3>>::New();
+  mismatchedDriver->SetInputFileName(inputFileName);
+  mismatchedDriver->SetOutputFileName(outputDirectory + "/chunkedFilterMismatch.zarr");
+  mismatchedDriver->SetTileFunction([](const itk::Image<float, 3> * tile, const itk::ImageRegion<3> &) {
+    return itk::Image<float, 3>::Pointer(const_cast<itk::Image<float, 3> *>(tile));
+  });
+  ITK_TRY_EXPECT_EXCEPTION(mismatchedDriver->Update());
+
+  // An image type with fewer dimensions than the spatial axes of the store
+  using SliceType = itk::Image<unsigned short, 2>;
+  auto sliceDriver = itk::OMEZarrNGFFChunkedFilterDriver<SliceType>::New();
+  sliceDriver->SetInputFileName(inputFileName);
+  sliceDriver->SetOutputFileName(outputDirectory + "/chunkedFilterSlice.zarr");
+  sliceDriver->SetTileFunction([](const SliceType * tile, const itk::ImageRegion<2> &) {
+    return SliceType::Pointer(const_cast<SliceType *>(tile));
+  });
+  ITK_TRY_EXPECT_EXCEPTION(sliceDriver->Update());
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
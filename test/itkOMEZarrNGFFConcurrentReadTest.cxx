@@ -0,0 +1,129 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Many threads read random regions, time points and channels
+/// through one shared IO object, and validate every voxel.
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = unsigned short;
+using ImageType = itk::Image<PixelType, 5>; // x, y, z, c, t
+
+const auto imageSize = itk::MakeSize(24, 20, 16, 2, 3);
+} // namespace
+
+int
+itkOMEZarrNGFFConcurrentReadTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output [numberOfThreads] [readsPerThread]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char *   outputFileName = argv[1];
+  const unsigned numberOfThreads = (argc > 2 ? std::atoi(argv[2]) : 16);
+  const unsigned readsPerThread = (argc > 3 ? std::atoi(argv[3]) : 200);
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  // Write a TCZYX image whose voxel values encode their index, in small chunks
+  auto writeIO = itk::OMEZarrNGFFImageIO::New();
+  writeIO->SetChunkSize({ 8, 8, 8, 1, 1 });
+  ITK_TRY_EXPECT_NO_EXCEPTION(
+    OMEZarrNGFFTest::WriteImage<ImageType>(OMEZarrNGFFTest::MakeImage<ImageType>(imageSize), outputFileName, writeIO));
+
+  // Open once, then read from all threads
+  auto zarrIO = itk::OMEZarrNGFFImageIO::New();
+  zarrIO->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(zarrIO->ReadImageInformation());
+  const itk::OMEZarrNGFFImageIO * sharedIO = zarrIO;
+
+  std::atomic<unsigned> mismatches{ 0 };
+  std::atomic<unsigned> failures{ 0 };
+  const auto            readRandomRegions = [&](const unsigned threadId) {
+    std::mt19937           generator(threadId);
+    std::vector<PixelType> buffer;
+    for (unsigned r = 0; r < readsPerThread; ++r)
+    {
+      itk::ImageIORegion region(3);
+      for (unsigned d = 0; d < 3; ++d)
+      {
+        const auto size = std::uniform_int_distribution<itk::SizeValueType>(1, imageSize[d])(generator);
+        region.SetSize(d, size);
+        region.SetIndex(d, std::uniform_int_distribution<itk::IndexValueType>(0, imageSize[d] - size)(generator));
+      }
+      const int channel = std::uniform_int_distribution<int>(0, imageSize[3] - 1)(generator);
+      const int timePoint = std::uniform_int_distribution<int>(0, imageSize[4] - 1)(generator);
+      buffer.assign(region.GetNumberOfPixels(), 0);
+      try
+      {
+        sharedIO->ReadRegion(region, timePoint, channel, buffer.data());
+      }
+      catch (const itk::ExceptionObject & e)
+      {
+        std::cerr << e << std::endl;
+        ++failures;
+        continue;
+      }
+
+      // The buffer is in ITK order, with x the fastest moving index
+      size_t i = 0;
+      for (itk::SizeValueType z = 0; z < region.GetSize(2); ++z)
+      {
+        for (itk::SizeValueType y = 0; y < region.GetSize(1); ++y)
+        {
+          for (itk::SizeValueType x = 0; x < region.GetSize(0); ++x, ++i)
+          {
+            const auto index = itk::MakeIndex(
+              region.GetIndex(0) + x, region.GetIndex(1) + y, region.GetIndex(2) + z, channel, timePoint);
+            if (buffer[i] != OMEZarrNGFFTest::ExpectedValue<PixelType>(index, imageSize))
+            {
+              ++mismatches;
+            }
+          }
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < numberOfThreads; ++t)
+  {
+    threads.emplace_back(readRandomRegions, t);
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+
+  ITK_TEST_EXPECT_EQUAL(failures.load(), 0u);
+  ITK_TEST_EXPECT_EQUAL(mismatches.load(), 0u);
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Follows a TCZYX store while time points are appended to it and overwritten,
+/// refreshing on demand and on reads in follow mode.
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageFileWriter.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = unsigned short;
+using VolumeType = itk::Image<PixelType, 3>;
+
+const auto volumeSize = itk::MakeSize(9, 7, 5);
+
+// Each version of a time point holds other values
+itk::SizeValueType
+versionBase(const unsigned version)
+{
+  return 1000 * version;
+}
+
+void
+writeTimePoint(itk::OMEZarrNGFFImageIO * writeIO, const char * fileName, const unsigned t, const unsigned version)
+{
+  writeIO->SetTimeIndex(t);
+  OMEZarrNGFFTest::WriteImage<VolumeType>(
+    OMEZarrNGFFTest::MakeImage<VolumeType>(volumeSize, versionBase(version)), fileName, writeIO);
+}
+
+// Reads time point t of channel 0 into a volume
+VolumeType::Pointer
+readTimePoint(itk::OMEZarrNGFFImageIO * readIO, const unsigned t)
+{
+  auto volume = VolumeType::New();
+  volume->SetRegions(volumeSize);
+  volume->Allocate();
+  itk::ImageIORegion ioRegion(5);
+  for (unsigned d = 0; d < 3; ++d)
+  {
+    ioRegion.SetSize(d, volume->GetLargestPossibleRegion().GetSize(d));
+  }
+  ioRegion.SetIndex(3, 0);
+  ioRegion.SetSize(3, 1);
+  ioRegion.SetIndex(4, t);
+  ioRegion.SetSize(4, 1);
+  readIO->SetIORegion(ioRegion);
+  readIO->Read(volume->GetBufferPointer());
+  return volume;
+}
+
+void
+checkTimePoint(const VolumeType * volume, const unsigned version)
+{
+  itk::ImageRegionConstIteratorWithIndex<VolumeType> it(volume, volume->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const auto expected = OMEZarrNGFFTest::ExpectedValue<PixelType>(it.GetIndex(), volumeSize, versionBase(version));
+    itkAssertOrThrowMacro(it.Get() == expected,
+                          "Pixel value mismatch at index " << it.GetIndex() << " of version " << version);
+  }
+}
+} // namespace
+
+int
+itkOMEZarrNGFFFollowTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char * outputFileName = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  // Create a TCZYX store holding a single time point
+  using TCZYXImageType = itk::Image<PixelType, 5>;
+  auto initialImage = TCZYXImageType::New();
+  initialImage->SetRegions(itk::MakeSize(9, 7, 5, 1, 1));
+  initialImage->Allocate(true);
+  itk::WriteImage(initialImage, outputFileName);
+
+  auto writeIO = itk::OMEZarrNGFFImageIO::New();
+  writeIO->SetWriteMode(itk::OMEZarrNGFFImageIOEnums::WriteMode::Update);
+  writeIO->SetChannelIndex(0);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writeTimePoint(writeIO, outputFileName, 0, 1));
+
+  auto readIO = itk::OMEZarrNGFFImageIO::New();
+  ITK_TEST_SET_GET_BOOLEAN(readIO, Follow, true);
+  readIO->SetFollowInterval(3600.0);
+  ITK_TEST_SET_GET_VALUE(3600.0, readIO->GetFollowInterval());
+  ITK_TRY_EXPECT_EXCEPTION(readIO->Refresh()); // not opened
+  readIO->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(readIO->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(readIO->GetDimensions(4), 1);
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkTimePoint(readTimePoint(readIO, 0), 1));
+
+  // The store grows, and the time point which was read is overwritten
+  ITK_TRY_EXPECT_NO_EXCEPTION(writeTimePoint(writeIO, outputFileName, 1, 2));
+  ITK_TRY_EXPECT_NO_EXCEPTION(writeTimePoint(writeIO, outputFileName, 2, 3));
+  ITK_TRY_EXPECT_NO_EXCEPTION(writeTimePoint(writeIO, outputFileName, 0, 4));
+
+  // The recheck interval has not passed, so only an explicit refresh sees the changes
+  ITK_TEST_EXPECT_EQUAL(readIO->GetDimensions(4), 1);
+  ITK_TEST_EXPECT_TRUE(readIO->Refresh());
+  ITK_TEST_EXPECT_EQUAL(readIO->GetDimensions(4), 3);
+  ITK_TEST_EXPECT_TRUE(!readIO->Refresh());
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkTimePoint(readTimePoint(readIO, 0), 4));
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkTimePoint(readTimePoint(readIO, 1), 2));
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkTimePoint(readTimePoint(readIO, 2), 3));
+
+  // With an elapsed interval, reads recheck the store by themselves
+  readIO->SetFollowInterval(0.0);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writeTimePoint(writeIO, outputFileName, 3, 5));
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkTimePoint(readTimePoint(readIO, 3), 5));
+  ITK_TEST_EXPECT_EQUAL(readIO->GetDimensions(4), 4);
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkTimePoint(readTimePoint(readIO, 1), 2));
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
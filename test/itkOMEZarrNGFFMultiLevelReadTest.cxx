@@ -0,0 +1,114 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Reads one physical box from several datasets of a multiscale volume at once,
+/// comparing each level with a read of that dataset alone.
+
+#include <cstring>
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFPyramidTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = float;
+using ImageType = itk::Image<PixelType, 3>;
+
+// Compares the levels with separate reads of their datasets
+void
+checkLevels(const itk::OMEZarrNGFFImageIO *                  imageIO,
+            const std::vector<unsigned> &                    datasetIndices,
+            const std::vector<itk::OMEZarrNGFFLevelRegion> & levels,
+            const std::vector<double> &                      lower,
+            const std::vector<double> &                      upper)
+{
+  itkAssertOrThrowMacro(levels.size() == datasetIndices.size(), "Expected one level per dataset");
+  for (size_t k = 0; k < levels.size(); ++k)
+  {
+    const auto & level = levels[k];
+    itkAssertOrThrowMacro(level.datasetIndex == datasetIndices[k], "Levels are not in the requested order");
+    const itk::ImageIORegion region = imageIO->ComputePhysicalRegion(level.datasetIndex, lower, upper);
+    itkAssertOrThrowMacro(level.buffer.size() == region.GetNumberOfPixels() * sizeof(PixelType),
+                          "Unexpected buffer size of dataset " << level.datasetIndex);
+
+    std::vector<PixelType> expected(region.GetNumberOfPixels());
+    const auto geometry = imageIO->ReadPhysicalRegion(level.datasetIndex, lower, upper, 0, 0, expected.data());
+    itkAssertOrThrowMacro(level.geometry.size == geometry.size && level.geometry.spacing == geometry.spacing &&
+                            level.geometry.origin == geometry.origin,
+                          "Unexpected geometry of dataset " << level.datasetIndex);
+    itkAssertOrThrowMacro(std::memcmp(level.buffer.data(), expected.data(), level.buffer.size()) == 0,
+                          "Pixels of dataset " << level.datasetIndex << " do not match");
+  }
+}
+} // namespace
+
+int
+itkOMEZarrNGFFMultiLevelReadTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputFileName = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  auto image = ImageType::New();
+  image->SetRegions(itk::MakeSize(64, 48, 40));
+  image->SetSpacing(itk::MakeVector(0.25, 0.25, 0.5));
+  image->SetOrigin(itk::MakePoint(1.0, 2.0, -3.0));
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    it.Set(index[0] + 0.5f * index[1] - 0.25f * index[2]);
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(OMEZarrNGFFPyramidTest::WritePyramid(outputFileName, image.GetPointer(), 4, 8));
+
+  auto imageIO = itk::OMEZarrNGFFImageIO::New();
+  imageIO->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetNumberOfDatasets(), 4u);
+
+  const std::vector<double>                lower{ 4.1, 3.0, 1.0 };
+  const std::vector<double>                upper{ 12.0, 9.9, 14.2 };
+  std::vector<unsigned>                    datasetIndices{ 0, 1, 2, 3 };
+  std::vector<itk::OMEZarrNGFFLevelRegion> levels;
+  ITK_TRY_EXPECT_NO_EXCEPTION(levels = imageIO->ReadPhysicalRegionAtDatasets(datasetIndices, lower, upper, 0, 0));
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkLevels(imageIO, datasetIndices, levels, lower, upper));
+  ITK_TEST_EXPECT_EQUAL(levels[1].geometry.spacing[2], 1.0);
+  ITK_TEST_EXPECT_TRUE(levels[3].geometry.size[0] < levels[0].geometry.size[0]);
+
+  // Any subset of the datasets, in any order
+  datasetIndices = { 3, 1 };
+  ITK_TRY_EXPECT_NO_EXCEPTION(levels = imageIO->ReadPhysicalRegionAtDatasets(datasetIndices, lower, upper, 0, 0));
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkLevels(imageIO, datasetIndices, levels, lower, upper));
+
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ReadPhysicalRegionAtDatasets({ 0, 4 }, lower, upper, 0, 0));
+  ITK_TRY_EXPECT_EXCEPTION(
+    imageIO->ReadPhysicalRegionAtDatasets({ 0, 1 }, { 100.0, 2.0, -3.0 }, { 101.0, 3.0, -2.0 }, 0, 0));
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Reslices a multiscale volume on axis-aligned and oblique planes. The volume is a linear
+/// function of the physical position, which trilinear interpolation reproduces exactly at every level.
+
+#include <cmath>
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFPyramidTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+double
+linearFunction(const double x, const double y, const double z)
+{
+  return 2.0 * x + 3.0 * y + 5.0 * z + 100.0;
+}
+
+// Compares the slice with the function at the plane points which are inside of the physical
+// extent of `geometry`, and checks that the points outside of it are 0.
+void
+checkSlice(const std::vector<float> &              slice,
+           const itk::OMEZarrNGFFReslicePlane &    plane,
+           const itk::OMEZarrNGFFDatasetGeometry & geometry)
+{
+  for (itk::SizeValueType j = 0; j < plane.size[1]; ++j)
+  {
+    for (itk::SizeValueType i = 0; i < plane.size[0]; ++i)
+    {
+      double point[3];
+      bool   inside = true;
+      for (unsigned a = 0; a < 3; ++a)
+      {
+        point[a] = plane.origin[a] + i * plane.spacing[0] * plane.uDirection[a] +
+                   j * plane.spacing[1] * plane.vDirection[a];
+        const double index = (point[a] - geometry.origin[a]) / geometry.spacing[a];
+        inside = inside && index >= 0.0 && index <= geometry.size[a] - 1.0;
+      }
+      const double expected = inside ? linearFunction(point[0], point[1], point[2]) : 0.0;
+      const float  actual = slice[j * plane.size[0] + i];
+      itkAssertOrThrowMacro(std::abs(actual - expected) < 1e-2,
+                            "Slice pixel (" << i << ", " << j << ") is " << actual << " instead of " << expected);
+    }
+  }
+}
+} // namespace
+
+int
+itkOMEZarrNGFFObliqueSliceTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputFileName = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  auto image = ImageType::New();
+  image->SetRegions(itk::MakeSize(65, 49, 41));
+  image->SetSpacing(itk::MakeVector(0.5, 0.5, 1.0));
+  image->SetOrigin(itk::MakePoint(10.0, -5.0, 3.0));
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    ImageType::PointType point;
+    image->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+    it.Set(linearFunction(point[0], point[1], point[2]));
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(OMEZarrNGFFPyramidTest::WritePyramid(outputFileName, image.GetPointer(), 3, 16));
+
+  auto imageIO = itk::OMEZarrNGFFImageIO::New();
+  imageIO->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetNumberOfDatasets(), 3u);
+  const auto coarsest = imageIO->GetDatasetGeometry(2);
+  ITK_TEST_EXPECT_EQUAL(coarsest.path, "s2");
+  ITK_TEST_EXPECT_EQUAL(coarsest.size[0], 17u);
+  ITK_TEST_EXPECT_EQUAL(coarsest.spacing[2], 4.0);
+  ITK_TEST_EXPECT_EQUAL(coarsest.origin[1], -5.0);
+
+  // An axial plane of the finest dataset
+  itk::OMEZarrNGFFReslicePlane plane;
+  plane.origin = { { 10.0, -5.0, 20.5 } };
+  plane.size = { { 65, 49 } };
+  plane.spacing = { { 0.5, 0.5 } };
+  std::vector<float> slice(plane.size[0] * plane.size[1]);
+  ITK_TEST_EXPECT_EQUAL(imageIO->ReadObliqueSlice(plane, 0, 0, slice.data(), 0), 0u);
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkSlice(slice, plane, imageIO->GetDatasetGeometry(0)));
+
+  // An oblique plane which leaves the volume, at a spacing which the finest dataset resolves along x and y only
+  const double norm = std::sqrt(3.0);
+  plane.origin = { { 12.0, -4.0, 4.0 } };
+  plane.uDirection = { { 1.0 / norm, 1.0 / norm, 1.0 / norm } };
+  plane.vDirection = { { 1.0 / std::sqrt(2.0), -1.0 / std::sqrt(2.0), 0.0 } };
+  plane.size = { { 80, 40 } };
+  plane.spacing = { { 0.5, 0.5 } };
+  slice.resize(plane.size[0] * plane.size[1]);
+  ITK_TEST_EXPECT_EQUAL(imageIO->ReadObliqueSlice(plane, 0, 0, slice.data()), 0u);
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkSlice(slice, plane, imageIO->GetDatasetGeometry(0)));
+
+  // A coarse plane is resampled from the coarsest dataset which resolves it
+  plane.spacing = { { 4.0, 4.5 } };
+  plane.size = { { 10, 6 } };
+  slice.resize(plane.size[0] * plane.size[1]);
+  ITK_TEST_EXPECT_EQUAL(imageIO->ReadObliqueSlice(plane, 0, 0, slice.data()), 2u);
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkSlice(slice, plane, coarsest));
+  plane.spacing = { { 2.0, 3.0 } };
+  ITK_TEST_EXPECT_EQUAL(imageIO->ReadObliqueSlice(plane, 0, 0, slice.data()), 1u);
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkSlice(slice, plane, imageIO->GetDatasetGeometry(1)));
+
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ReadObliqueSlice(plane, 0, 0, slice.data(), 3));
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
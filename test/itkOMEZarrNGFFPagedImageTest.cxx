@@ -0,0 +1,109 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Reads and modifies an image through a small page cache,
+/// forcing pages to be evicted and written back.
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageFileReader.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFPagedImage.h"
+#include "itkOMEZarrNGFFTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = unsigned short;
+using ImageType = itk::Image<PixelType, 3>;
+using PagedImageType = itk::OMEZarrNGFFPagedImage<PixelType, 3>;
+
+const auto imageSize = itk::MakeSize(48, 40, 32);
+} // namespace
+
+int
+itkOMEZarrNGFFPagedImageTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char * outputFileName = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  // 3 x 3 x 2 chunks
+  const auto image = OMEZarrNGFFTest::MakeImage<ImageType>(imageSize);
+  auto       writeIO = itk::OMEZarrNGFFImageIO::New();
+  writeIO->SetChunkSize({ 16, 16, 16 });
+  ITK_TRY_EXPECT_NO_EXCEPTION(OMEZarrNGFFTest::WriteImage<ImageType>(image, outputFileName, writeIO));
+
+  auto pagedImage = PagedImageType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(pagedImage, OMEZarrNGFFPagedImage, Object);
+  ITK_TRY_EXPECT_EXCEPTION(pagedImage->GetPixel(itk::MakeIndex(0, 0, 0))); // not opened
+  pagedImage->SetMaximumNumberOfPages(4);
+  ITK_TEST_SET_GET_VALUE(4u, pagedImage->GetMaximumNumberOfPages());
+  ITK_TRY_EXPECT_NO_EXCEPTION(pagedImage->Open(outputFileName));
+  ITK_TEST_EXPECT_EQUAL(pagedImage->GetLargestPossibleRegion(), image->GetLargestPossibleRegion());
+  ITK_TEST_EXPECT_EQUAL(pagedImage->GetPageSize(), itk::MakeSize(16, 16, 16));
+
+  // A sweep in memory order faults in each page once per row of pages it intersects
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    itkAssertOrThrowMacro(pagedImage->GetPixel(it.GetIndex()) == it.Get(), "Pixel value mismatch at " << it.GetIndex());
+  }
+  std::cout << "Hits: " << pagedImage->GetNumberOfPageHits() << ", faults: " << pagedImage->GetNumberOfPageFaults()
+            << std::endl;
+  ITK_TEST_EXPECT_EQUAL(pagedImage->GetNumberOfPageHits() + pagedImage->GetNumberOfPageFaults(),
+                        image->GetLargestPossibleRegion().GetNumberOfPixels());
+  ITK_TEST_EXPECT_TRUE(pagedImage->GetNumberOfPageFaults() >= 18);
+  ITK_TEST_EXPECT_TRUE(pagedImage->GetNumberOfPageFaults() < 1000);
+  ITK_TEST_EXPECT_TRUE(pagedImage->GetNumberOfResidentPages() <= 4);
+
+  ITK_TRY_EXPECT_EXCEPTION(pagedImage->GetPixel(itk::MakeIndex(48, 0, 0)));
+  ITK_TRY_EXPECT_EXCEPTION(pagedImage->SetPixel(itk::MakeIndex(0, 0, 0), 0)); // not writable
+
+  // Modify pixels spread over all pages, evicting dirty pages along the way
+  pagedImage->WritableOn();
+  const auto modified = [](const ImageType::IndexType & index) {
+    return index[0] % 7 == 0 && index[1] % 5 == 0 && index[2] % 3 == 0;
+  };
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    if (modified(it.GetIndex()))
+    {
+      pagedImage->SetPixel(it.GetIndex(), 1);
+    }
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(pagedImage->Flush());
+
+  auto modifiedImage = itk::ReadImage<ImageType>(outputFileName);
+  itk::ImageRegionIteratorWithIndex<ImageType> modifiedIt(modifiedImage, modifiedImage->GetLargestPossibleRegion());
+  for (modifiedIt.GoToBegin(); !modifiedIt.IsAtEnd(); ++modifiedIt)
+  {
+    const auto &    index = modifiedIt.GetIndex();
+    const PixelType expected = modified(index) ? 1 : OMEZarrNGFFTest::ExpectedValue<PixelType>(index, imageSize);
+    itkAssertOrThrowMacro(modifiedIt.Get() == expected, "Pixel value mismatch after write back at " << index);
+  }
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Creates a store, then fills it from several writers with their own IO objects,
+/// as separate processes would, each writing a chunk-aligned slab.
+
+#include <atomic>
+#include <thread>
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageFileReader.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = unsigned short;
+using ImageType = itk::Image<PixelType, 3>;
+
+const auto     imageSize = itk::MakeSize(20, 18, 30);
+constexpr auto ChunkSize = 8;
+
+// Image information shared by the coordinator and the writers
+itk::OMEZarrNGFFImageIO::Pointer
+makeIO(const char * fileName)
+{
+  auto zarrIO = itk::OMEZarrNGFFImageIO::New();
+  zarrIO->SetFileName(fileName);
+  zarrIO->SetNumberOfDimensions(3);
+  for (unsigned d = 0; d < 3; ++d)
+  {
+    zarrIO->SetDimensions(d, imageSize[d]);
+    zarrIO->SetSpacing(d, 0.5);
+  }
+  zarrIO->SetPixelType(itk::IOPixelEnum::SCALAR);
+  zarrIO->SetComponentType(itk::IOComponentEnum::USHORT);
+  zarrIO->SetChunkSize({ ChunkSize, ChunkSize, ChunkSize });
+  return zarrIO;
+}
+
+// Writes slices [zBegin, zEnd) of the image
+void
+writeSlab(itk::OMEZarrNGFFImageIO * zarrIO, const itk::IndexValueType zBegin, const itk::IndexValueType zEnd)
+{
+  itk::ImageIORegion region(3);
+  region.SetSize(0, imageSize[0]);
+  region.SetSize(1, imageSize[1]);
+  region.SetIndex(2, zBegin);
+  region.SetSize(2, zEnd - zBegin);
+
+  std::vector<PixelType> buffer;
+  for (auto z = zBegin; z < zEnd; ++z)
+  {
+    for (itk::IndexValueType y = 0; y < static_cast<itk::IndexValueType>(imageSize[1]); ++y)
+    {
+      for (itk::IndexValueType x = 0; x < static_cast<itk::IndexValueType>(imageSize[0]); ++x)
+      {
+        buffer.push_back(OMEZarrNGFFTest::ExpectedValue<PixelType>(itk::MakeIndex(x, y, z), imageSize));
+      }
+    }
+  }
+  zarrIO->SetWriteMode(itk::OMEZarrNGFFImageIOEnums::WriteMode::Parallel);
+  zarrIO->SetIORegion(region);
+  zarrIO->Write(buffer.data());
+}
+} // namespace
+
+int
+itkOMEZarrNGFFParallelWriteTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char * outputFileName = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  // The coordinator writes the metadata only
+  auto coordinatorIO = makeIO(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(coordinatorIO->CreateStore());
+
+  // Each writer fills a slab of one or two chunks along z, the last one ending at the image boundary
+  std::atomic<unsigned>    failures{ 0 };
+  std::vector<std::thread> writers;
+  for (itk::IndexValueType zBegin = 0; zBegin < static_cast<itk::IndexValueType>(imageSize[2]);)
+  {
+    const itk::IndexValueType zEnd =
+      std::min<itk::IndexValueType>(zBegin + (writers.size() % 2 + 1) * ChunkSize, imageSize[2]);
+    writers.emplace_back([&failures, outputFileName, zBegin, zEnd]() {
+      try
+      {
+        auto writerIO = makeIO(outputFileName);
+        writeSlab(writerIO, zBegin, zEnd);
+      }
+      catch (const itk::ExceptionObject & e)
+      {
+        std::cerr << e << std::endl;
+        ++failures;
+      }
+    });
+    zBegin = zEnd;
+  }
+  for (auto & writer : writers)
+  {
+    writer.join();
+  }
+  ITK_TEST_EXPECT_EQUAL(failures.load(), 0u);
+
+  // Regions which are not aligned to the chunk grid are rejected
+  auto misalignedIO = makeIO(outputFileName);
+  ITK_TRY_EXPECT_EXCEPTION(writeSlab(misalignedIO, 4, 12));
+  ITK_TRY_EXPECT_EXCEPTION(writeSlab(misalignedIO, 8, 12));
+
+  // Without a chunk size, each chunk holds one channel and time point, as each parallel write does
+  const std::string tczyxFileName = std::string(outputFileName) + ".tczyx.zarr";
+  auto              tczyxIO = makeIO(tczyxFileName.c_str());
+  tczyxIO->SetChunkSize({});
+  tczyxIO->SetNumberOfDimensions(5);
+  tczyxIO->SetDimensions(3, 3);
+  tczyxIO->SetDimensions(4, 4);
+  tczyxIO->SetSpacing(3, 1.0);
+  tczyxIO->SetSpacing(4, 1.0);
+  ITK_TRY_EXPECT_NO_EXCEPTION(tczyxIO->CreateStore());
+  auto tczyxReadIO = itk::OMEZarrNGFFImageIO::New();
+  tczyxReadIO->SetFileName(tczyxFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(tczyxReadIO->ReadImageInformation());
+  const auto storeChunkSize = tczyxReadIO->GetStoreChunkSize();
+  ITK_TEST_EXPECT_EQUAL(storeChunkSize.size(), 5u);
+  ITK_TEST_EXPECT_EQUAL(storeChunkSize[3], 1u);
+  ITK_TEST_EXPECT_EQUAL(storeChunkSize[4], 1u);
+
+  // Zip archives cannot be written in parallel
+  auto zipIO = makeIO("parallel.zarr.zip");
+  ITK_TRY_EXPECT_EXCEPTION(zipIO->CreateStore());
+
+  // The slabs together make up the image
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  auto image = reader->GetOutput();
+  ITK_TEST_EXPECT_EQUAL(image->GetLargestPossibleRegion().GetSize(), imageSize);
+  ITK_TEST_EXPECT_EQUAL(image->GetSpacing()[2], 0.5);
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    itkAssertOrThrowMacro(it.Get() == OMEZarrNGFFTest::ExpectedValue<PixelType>(index, imageSize),
+                          "Pixel value mismatch at index " << index);
+  }
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
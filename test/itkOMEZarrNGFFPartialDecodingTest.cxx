@@ -0,0 +1,198 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Reads small regions of large blosc chunks, decoding only the blocks they overlap,
+/// and compares them with the image, including a missing chunk and a zstd store.
+/// Counts the chunks decoded block-wise, which are none when the blosc path is not taken.
+
+#include "itkImageFileReader.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFTestUtilities.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+namespace
+{
+using PixelType = int;
+using ImageType = itk::Image<PixelType, 3>;
+
+const auto imageSize = itk::MakeSize(96, 80, 72);
+
+// The chunk with key 1.0.1 (z, y, x) is removed from the blosc store
+bool
+inMissingChunk(const itk::IndexValueType x, const itk::IndexValueType y, const itk::IndexValueType z)
+{
+  return x >= 64 && y < 64 && z >= 64;
+}
+
+void
+checkRegion(const itk::OMEZarrNGFFImageIO * imageIO, const itk::ImageIORegion & region, bool missingChunk)
+{
+  std::vector<PixelType> buffer(region.GetNumberOfPixels());
+  imageIO->ReadRegion(region, 0, 0, buffer.data());
+  size_t offset = 0;
+  for (itk::SizeValueType k = 0; k < region.GetSize(2); ++k)
+  {
+    for (itk::SizeValueType j = 0; j < region.GetSize(1); ++j)
+    {
+      for (itk::SizeValueType i = 0; i < region.GetSize(0); ++i, ++offset)
+      {
+        const auto      x = region.GetIndex(0) + static_cast<itk::IndexValueType>(i);
+        const auto      y = region.GetIndex(1) + static_cast<itk::IndexValueType>(j);
+        const auto      z = region.GetIndex(2) + static_cast<itk::IndexValueType>(k);
+        const PixelType expected = missingChunk && inMissingChunk(x, y, z)
+                                     ? 0
+                                     : OMEZarrNGFFTest::ExpectedValue<PixelType>(itk::MakeIndex(x, y, z), imageSize);
+        itkAssertOrThrowMacro(buffer[offset] == expected,
+                              "Pixel (" << x << ", " << y << ", " << z << ") is " << buffer[offset] << " instead of "
+                                        << expected << ", partial decoding "
+                                        << (imageIO->GetPartialChunkDecoding() ? "on" : "off"));
+      }
+    }
+  }
+}
+
+// Number of the stored chunks which `region` covers in part, that is those decoded block-wise,
+// or none when it covers no chunk in part, as it is then read through tensorstore
+itk::SizeValueType
+countPartlyCoveredChunks(const itk::ImageIORegion & region, bool missingChunk)
+{
+  const auto end = [&region](unsigned d) {
+    return region.GetIndex(d) + static_cast<itk::IndexValueType>(region.GetSize(d));
+  };
+  const auto isCovered = [&region, &end](unsigned d, itk::IndexValueType chunk) {
+    const auto chunkEnd = std::min<itk::IndexValueType>(64 * (chunk + 1), imageSize[d]);
+    return region.GetIndex(d) <= 64 * chunk && end(d) >= chunkEnd;
+  };
+  itk::SizeValueType count = 0;
+  for (auto z = region.GetIndex(2) / 64; z <= (end(2) - 1) / 64; ++z)
+  {
+    for (auto y = region.GetIndex(1) / 64; y <= (end(1) - 1) / 64; ++y)
+    {
+      for (auto x = region.GetIndex(0) / 64; x <= (end(0) - 1) / 64; ++x)
+      {
+        const bool covered = isCovered(0, x) && isCovered(1, y) && isCovered(2, z);
+        count += covered || (missingChunk && inMissingChunk(64 * x, 64 * y, 64 * z)) ? 0 : 1;
+      }
+    }
+  }
+  return count;
+}
+
+itk::ImageIORegion
+makeRegion(itk::IndexValueType x, itk::IndexValueType y, itk::IndexValueType z, itk::SizeValueType size)
+{
+  itk::ImageIORegion region(3);
+  region.SetIndex(0, x);
+  region.SetIndex(1, y);
+  region.SetIndex(2, z);
+  for (unsigned d = 0; d < 3; ++d)
+  {
+    region.SetSize(d, size);
+  }
+  return region;
+}
+} // namespace
+
+int
+itkOMEZarrNGFFPartialDecodingTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " OutputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  // 2 x 2 x 2 chunks of 1 MiB, cropped at the far edges
+  const auto image = OMEZarrNGFFTest::MakeImage<ImageType>(imageSize);
+
+  // Small regions inside of one chunk, straddling chunks, at the cropped edges, a region covering
+  // the first chunk and part of the others, and all of the image, which covers every chunk
+  std::vector<itk::ImageIORegion> regions{ makeRegion(3, 5, 7, 4),     makeRegion(40, 10, 20, 16),
+                                           makeRegion(60, 60, 60, 8),  makeRegion(90, 74, 66, 6),
+                                           makeRegion(70, 30, 62, 10), makeRegion(0, 63, 0, 2),
+                                           makeRegion(0, 0, 0, 70) };
+  itk::ImageIORegion              all(3);
+  for (unsigned d = 0; d < 3; ++d)
+  {
+    all.SetSize(d, imageSize[d]);
+  }
+  regions.push_back(all);
+
+  for (const std::string compressor : { "blosc", "zstd" })
+  {
+    const std::string fileName = outputDirectory + "/partialDecoding_" + compressor + ".zarr";
+    auto              writeIO = itk::OMEZarrNGFFImageIO::New();
+    writeIO->SetChunkSize({ 64, 64, 64 });
+    writeIO->SetCompressor(compressor);
+    ITK_TRY_EXPECT_NO_EXCEPTION(OMEZarrNGFFTest::WriteImage<ImageType>(image, fileName, writeIO));
+
+    // Missing chunks are filled with the fill value
+    const bool missingChunk = compressor == "blosc";
+    if (missingChunk)
+    {
+      ITK_TEST_EXPECT_TRUE(itksys::SystemTools::RemoveFile(fileName + "/s0/1.0.1"));
+    }
+
+    auto imageIO = itk::OMEZarrNGFFImageIO::New();
+    ITK_TEST_SET_GET_BOOLEAN(imageIO, PartialChunkDecoding, true);
+    imageIO->SetFileName(fileName);
+    ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+    for (const bool partialChunkDecoding : { true, false })
+    {
+      imageIO->SetPartialChunkDecoding(partialChunkDecoding);
+      for (const auto & region : regions)
+      {
+        const itk::SizeValueType decodedBefore = imageIO->GetNumberOfChunksDecodedBlockwise();
+        ITK_TRY_EXPECT_NO_EXCEPTION(checkRegion(imageIO, region, missingChunk));
+        const itk::SizeValueType decoded = imageIO->GetNumberOfChunksDecodedBlockwise() - decodedBefore;
+        const itk::SizeValueType expectedDecoded =
+          partialChunkDecoding && compressor == "blosc" ? countPartlyCoveredChunks(region, missingChunk) : 0;
+        ITK_TEST_EXPECT_EQUAL(decoded, expectedDecoded);
+      }
+    }
+
+    // Reading the whole image through ImageFileReader reads whole chunks through tensorstore
+    imageIO->SetPartialChunkDecoding(true);
+    imageIO->ResetReadStatistics();
+    auto reader = itk::ImageFileReader<ImageType>::New();
+    reader->SetFileName(fileName);
+    reader->SetImageIO(imageIO);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+    const ImageType *        readImage = reader->GetOutput();
+    ITK_TEST_EXPECT_EQUAL(imageIO->GetNumberOfChunksDecodedBlockwise(), 0u);
+    itk::ImageRegionConstIteratorWithIndex<ImageType> readIt(readImage, readImage->GetLargestPossibleRegion());
+    for (readIt.GoToBegin(); !readIt.IsAtEnd(); ++readIt)
+    {
+      const auto & index = readIt.GetIndex();
+      const bool   missing = missingChunk && inMissingChunk(index[0], index[1], index[2]);
+      itkAssertOrThrowMacro(readIt.Get() == (missing ? 0 : OMEZarrNGFFTest::ExpectedValue<PixelType>(index, imageSize)),
+                            "Pixel value mismatch at " << index);
+    }
+  }
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Reads physical bounding boxes from the datasets of a multiscale volume,
+/// checking the selected region, its geometry and its pixels.
+
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFPyramidTestUtilities.h"
+#include "itkOMEZarrNGFFTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = unsigned short;
+using ImageType = itk::Image<PixelType, 3>;
+
+const auto imageSize = itk::MakeSize(40, 36, 20);
+
+// Reads the box from `datasetIndex`, which is subsampled by `factor`, and checks
+// that it is the region starting at `index` with `size`.
+void
+checkPhysicalRegion(const itk::OMEZarrNGFFImageIO * imageIO,
+                    unsigned                        datasetIndex,
+                    itk::IndexValueType             factor,
+                    const std::vector<double> &     lower,
+                    const std::vector<double> &     upper,
+                    const itk::IndexValueType       index[3],
+                    const itk::SizeValueType        size[3])
+{
+  const itk::ImageIORegion region = imageIO->ComputePhysicalRegion(datasetIndex, lower, upper);
+  itkAssertOrThrowMacro(region.GetImageDimension() == 3, "The region must span the spatial axes");
+  for (unsigned d = 0; d < 3; ++d)
+  {
+    itkAssertOrThrowMacro(region.GetIndex(d) == index[d] && region.GetSize(d) == size[d],
+                          "Unexpected region " << region << " of dataset " << datasetIndex);
+  }
+
+  std::vector<PixelType> buffer(region.GetNumberOfPixels());
+  const itk::OMEZarrNGFFDatasetGeometry geometry =
+    imageIO->ReadPhysicalRegion(datasetIndex, lower, upper, 0, 0, buffer.data());
+  const auto datasetGeometry = imageIO->GetDatasetGeometry(datasetIndex);
+  for (unsigned d = 0; d < 3; ++d)
+  {
+    itkAssertOrThrowMacro(geometry.size[d] == size[d] && geometry.spacing[d] == datasetGeometry.spacing[d] &&
+                            geometry.origin[d] == datasetGeometry.origin[d] + index[d] * datasetGeometry.spacing[d],
+                          "Unexpected geometry along axis " << d << " of the box read from dataset " << datasetIndex);
+  }
+
+  size_t offset = 0;
+  for (itk::SizeValueType k = 0; k < size[2]; ++k)
+  {
+    for (itk::SizeValueType j = 0; j < size[1]; ++j)
+    {
+      for (itk::SizeValueType i = 0; i < size[0]; ++i, ++offset)
+      {
+        const auto imageIndex =
+          itk::MakeIndex(factor * (index[0] + i), factor * (index[1] + j), factor * (index[2] + k));
+        const PixelType expected = OMEZarrNGFFTest::ExpectedValue<PixelType>(imageIndex, imageSize);
+        itkAssertOrThrowMacro(buffer[offset] == expected,
+                              "Pixel (" << i << ", " << j << ", " << k << ") of dataset " << datasetIndex << " is "
+                                        << buffer[offset] << " instead of " << expected);
+      }
+    }
+  }
+}
+} // namespace
+
+int
+itkOMEZarrNGFFPhysicalRegionTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputFileName = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  auto image = OMEZarrNGFFTest::MakeImage<ImageType>(imageSize);
+  image->SetSpacing(itk::MakeVector(0.5, 0.5, 1.0));
+  image->SetOrigin(itk::MakePoint(10.0, -5.0, 3.0));
+  ITK_TRY_EXPECT_NO_EXCEPTION(OMEZarrNGFFPyramidTest::WritePyramid(outputFileName, image.GetPointer(), 3, 8));
+
+  auto imageIO = itk::OMEZarrNGFFImageIO::New();
+  imageIO->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetNumberOfSpatialDimensions(), 3u);
+
+  // The coarsest dataset which resolves the target spacing
+  ITK_TEST_EXPECT_EQUAL(imageIO->SelectDataset({ 0.5, 0.5, 1.0 }), 0u);
+  ITK_TEST_EXPECT_EQUAL(imageIO->SelectDataset({ 1.5, 1.5, 3.0 }), 1u);
+  ITK_TEST_EXPECT_EQUAL(imageIO->SelectDataset({ 2.0, 2.0, 4.0 }), 2u);
+  ITK_TEST_EXPECT_EQUAL(imageIO->SelectDataset({ 8.0, 8.0, 1.5 }), 0u);
+  ITK_TEST_EXPECT_EQUAL(imageIO->SelectDataset({ 0.1, 0.1, 0.1 }), 0u);
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->SelectDataset({ 1.0, 1.0 }));
+
+  // A box inside of the volume, spanning several chunks of each dataset
+  const std::vector<double> lower{ 12.2, -3.0, 5.4 };
+  const std::vector<double> upper{ 14.0, 0.1, 9.6 };
+  {
+    const itk::IndexValueType index[] = { 4, 4, 2 };
+    const itk::SizeValueType  size[] = { 5, 7, 6 };
+    ITK_TRY_EXPECT_NO_EXCEPTION(checkPhysicalRegion(imageIO, 0, 1, lower, upper, index, size));
+  }
+  {
+    const itk::IndexValueType index[] = { 2, 2, 1 };
+    const itk::SizeValueType  size[] = { 3, 4, 3 };
+    ITK_TRY_EXPECT_NO_EXCEPTION(checkPhysicalRegion(imageIO, 1, 2, lower, upper, index, size));
+  }
+
+  // The corners may be given in any order, and a box overlapping the volume is cropped to it
+  {
+    const itk::IndexValueType index[] = { 0, 0, 0 };
+    const itk::SizeValueType  size[] = { 1, 1, 1 };
+    ITK_TRY_EXPECT_NO_EXCEPTION(
+      checkPhysicalRegion(imageIO, 2, 4, { 10.2, -100.0, 3.0 }, { 0.0, -4.9, -10.0 }, index, size));
+  }
+  {
+    const itk::IndexValueType index[] = { 0, 0, 0 };
+    const itk::SizeValueType  size[] = { 10, 9, 5 };
+    ITK_TRY_EXPECT_NO_EXCEPTION(
+      checkPhysicalRegion(imageIO, 2, 4, { 0.0, -100.0, 0.0 }, { 100.0, 100.0, 100.0 }, index, size));
+  }
+
+  // Boxes outside of the volume, and corners with the wrong number of entries
+  std::vector<PixelType> buffer(1);
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ComputePhysicalRegion(0, { 40.0, 0.0, 5.0 }, { 50.0, 1.0, 6.0 }));
+  ITK_TRY_EXPECT_EXCEPTION(
+    imageIO->ReadPhysicalRegion(0, { 10.0, -5.0, -8.0 }, { 11.0, -4.0, 2.0 }, 0, 0, buffer.data()));
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ComputePhysicalRegion(0, { 10.0, -5.0 }, { 11.0, -4.0 }));
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ComputePhysicalRegion(3, lower, upper));
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,185 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Discovers the fields of view of a high-content screening plate and of one of its wells,
+/// and reads the same region from several fields at once.
+
+#include <fstream>
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = unsigned short;
+using ImageType = itk::Image<PixelType, 3>;
+
+const std::vector<std::string> WellPaths{ "A/1", "A/2", "B/1" };
+constexpr unsigned             FieldsPerWell = 2;
+
+const auto imageSize = itk::MakeSize(16, 12, 5);
+
+// Each field holds other values
+itk::SizeValueType
+fieldBase(const unsigned fieldIndex)
+{
+  return 1000 * fieldIndex;
+}
+
+void
+writeFile(const std::string & fileName, const std::string & contents)
+{
+  std::ofstream file(fileName);
+  file << contents;
+  itkAssertOrThrowMacro(file.good(), "Failed to write " << fileName);
+}
+
+void
+writePlate(const std::string & plateName)
+{
+  for (unsigned fieldIndex = 0; fieldIndex < WellPaths.size() * FieldsPerWell; ++fieldIndex)
+  {
+    // Field images do not have the .zarr extension, so the IO is given explicitly
+    OMEZarrNGFFTest::WriteImage<ImageType>(
+      OMEZarrNGFFTest::MakeImage<ImageType>(imageSize, fieldBase(fieldIndex)),
+      plateName + "/" + WellPaths[fieldIndex / FieldsPerWell] + "/" + std::to_string(fieldIndex % FieldsPerWell),
+      itk::OMEZarrNGFFImageIO::New());
+  }
+
+  const std::string zgroup = R"({ "zarr_format": 2 })";
+  writeFile(plateName + "/.zgroup", zgroup);
+  writeFile(plateName + "/.zattrs", R"({ "plate": { "version": "0.4", "name": "test",
+    "rows": [ { "name": "A" }, { "name": "B" } ],
+    "columns": [ { "name": "1" }, { "name": "2" } ],
+    "wells": [ { "path": "A/1", "rowIndex": 0, "columnIndex": 0 },
+               { "path": "A/2", "rowIndex": 0, "columnIndex": 1 },
+               { "path": "B/1", "rowIndex": 1, "columnIndex": 0 } ],
+    "field_count": 2 } })");
+  writeFile(plateName + "/A/.zgroup", zgroup);
+  writeFile(plateName + "/B/.zgroup", zgroup);
+  for (const auto & wellPath : WellPaths)
+  {
+    writeFile(plateName + "/" + wellPath + "/.zgroup", zgroup);
+    writeFile(plateName + "/" + wellPath + "/.zattrs",
+              R"({ "well": { "version": "0.4", "images": [ { "path": "0", "acquisition": 0 }, { "path": "1" } ] } })");
+  }
+}
+
+void
+checkRegion(const std::vector<char> & buffer, const itk::ImageIORegion & region, const unsigned fieldIndex)
+{
+  itkAssertOrThrowMacro(buffer.size() == region.GetNumberOfPixels() * sizeof(PixelType), "Buffer size mismatch");
+  const auto * pixels = reinterpret_cast<const PixelType *>(buffer.data());
+  for (unsigned k = 0; k < region.GetSize(2); ++k)
+  {
+    for (unsigned j = 0; j < region.GetSize(1); ++j)
+    {
+      for (unsigned i = 0; i < region.GetSize(0); ++i, ++pixels)
+      {
+        const auto index = itk::MakeIndex(region.GetIndex(0) + i, region.GetIndex(1) + j, region.GetIndex(2) + k);
+        const auto expected = OMEZarrNGFFTest::ExpectedValue<PixelType>(index, imageSize, fieldBase(fieldIndex));
+        itkAssertOrThrowMacro(*pixels == expected, "Pixel value mismatch at " << index << " of field " << fieldIndex);
+      }
+    }
+  }
+}
+} // namespace
+
+int
+itkOMEZarrNGFFPlateTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string plateName = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writePlate(plateName));
+
+  auto imageIO = itk::OMEZarrNGFFImageIO::New();
+  ITK_TEST_EXPECT_TRUE(imageIO->CanReadFile(plateName.c_str()));
+  imageIO->SetFileName(plateName);
+  imageIO->SetFieldIndex(3);
+  ITK_TEST_SET_GET_VALUE(3u, imageIO->GetFieldIndex());
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+
+  const auto & fields = imageIO->GetFields();
+  ITK_TEST_EXPECT_EQUAL(fields.size(), WellPaths.size() * FieldsPerWell);
+  ITK_TEST_EXPECT_EQUAL(fields[3].path, "A/2/1");
+  ITK_TEST_EXPECT_EQUAL(fields[3].row, "A");
+  ITK_TEST_EXPECT_EQUAL(fields[3].column, "2");
+  ITK_TEST_EXPECT_EQUAL(fields[3].acquisition, -1);
+  ITK_TEST_EXPECT_EQUAL(fields[4].path, "B/1/0");
+  ITK_TEST_EXPECT_EQUAL(fields[4].row, "B");
+  ITK_TEST_EXPECT_EQUAL(fields[4].column, "1");
+  ITK_TEST_EXPECT_EQUAL(fields[4].acquisition, 0);
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetDimensions(0), 16);
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetDatasetGeometry(0).path.find('/'), std::string::npos);
+
+  // The selected field is the opened image
+  itk::ImageIORegion region(3);
+  region.SetIndex({ 3, 2, 1 });
+  region.SetSize({ 9, 7, 3 });
+  std::vector<char> buffer(region.GetNumberOfPixels() * sizeof(PixelType));
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadRegion(region, 0, 0, buffer.data()));
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkRegion(buffer, region, 3));
+
+  // The same region of several fields, twice to reuse the opened arrays
+  const std::vector<unsigned> fieldIndices{ 5, 0, 3, 2 };
+  for (unsigned pass = 0; pass < 2; ++pass)
+  {
+    std::vector<std::vector<char>> buffers;
+    ITK_TRY_EXPECT_NO_EXCEPTION(buffers = imageIO->ReadFieldsRegion(fieldIndices, 0, region, 0, 0));
+    ITK_TEST_EXPECT_EQUAL(buffers.size(), fieldIndices.size());
+    for (size_t k = 0; k < fieldIndices.size(); ++k)
+    {
+      ITK_TRY_EXPECT_NO_EXCEPTION(checkRegion(buffers[k], region, fieldIndices[k]));
+    }
+  }
+  const std::vector<unsigned> invalidFieldIndices{ 0, 6 };
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ReadFieldsRegion(invalidFieldIndices, 0, region, 0, 0));
+  const std::vector<unsigned> firstField{ 0 };
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ReadFieldsRegion(firstField, imageIO->GetNumberOfDatasets(), region, 0, 0));
+  itk::ImageIORegion outside(region);
+  outside.SetIndex(0, 10);
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ReadFieldsRegion(firstField, 0, outside, 0, 0));
+
+  imageIO->SetFieldIndex(6);
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ReadImageInformation());
+
+  // A single well lists its own fields
+  auto wellIO = itk::OMEZarrNGFFImageIO::New();
+  const std::string wellName = plateName + "/B/1";
+  ITK_TEST_EXPECT_TRUE(wellIO->CanReadFile(wellName.c_str()));
+  wellIO->SetFileName(wellName);
+  wellIO->SetFieldIndex(1);
+  ITK_TRY_EXPECT_NO_EXCEPTION(wellIO->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(wellIO->GetFields().size(), FieldsPerWell);
+  ITK_TEST_EXPECT_EQUAL(wellIO->GetFields()[1].path, "1");
+  ITK_TEST_EXPECT_TRUE(wellIO->GetFields()[1].row.empty());
+  ITK_TRY_EXPECT_NO_EXCEPTION(wellIO->ReadRegion(region, 0, 0, buffer.data()));
+  ITK_TRY_EXPECT_NO_EXCEPTION(checkRegion(buffer, region, 5));
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
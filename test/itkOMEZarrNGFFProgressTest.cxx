@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Validates chunk-level progress of writes and reads,
+/// and cancellation of a read through the reader's AbortGenerateData.
+
+#include "itkCommand.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Records the progress values reported by an object
+class ProgressRecorder : public itk::Command
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ProgressRecorder);
+  using Self = ProgressRecorder;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro(Self);
+
+  void
+  Execute(itk::Object * caller, const itk::EventObject & event) override
+  {
+    this->Execute(static_cast<const itk::Object *>(caller), event);
+  }
+
+  void
+  Execute(const itk::Object * caller, const itk::EventObject & event) override
+  {
+    if (itk::ProgressEvent().CheckEvent(&event))
+    {
+      m_Progress.push_back(dynamic_cast<const itk::LightProcessObject *>(caller)->GetProgress());
+    }
+  }
+
+  std::vector<float> m_Progress;
+
+protected:
+  ProgressRecorder() = default;
+};
+} // namespace
+
+int
+itkOMEZarrNGFFProgressTest(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Input Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char * inputFileName = argv[1];
+  const char * outputFileName = argv[2];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  using ImageType = itk::Image<unsigned char, 2>;
+  auto image = itk::ReadImage<ImageType>(inputFileName);
+  const auto size = image->GetLargestPossibleRegion().GetSize();
+  const auto numberOfChunks = ((size[0] + 31) / 32) * ((size[1] + 31) / 32);
+
+  // Write with 32x32 chunks, reporting progress once per chunk
+  auto writeIO = itk::OMEZarrNGFFImageIO::New();
+  writeIO->SetChunkSize({ 32, 32 });
+  auto writeRecorder = ProgressRecorder::New();
+  writeIO->AddObserver(itk::ProgressEvent(), writeRecorder);
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(outputFileName);
+  writer->SetImageIO(writeIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TEST_EXPECT_EQUAL(writeRecorder->m_Progress.size(), numberOfChunks + 1); // including the initial 0
+  ITK_TEST_EXPECT_EQUAL(writeRecorder->m_Progress.back(), 1.0f);
+
+  // Read, forwarding progress to the reader
+  auto readIO = itk::OMEZarrNGFFImageIO::New();
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(outputFileName);
+  reader->SetImageIO(readIO);
+  readIO->SetProgressSource(reader);
+  ITK_TEST_SET_GET_VALUE(static_cast<itk::ProcessObject *>(reader), readIO->GetProgressSource());
+  auto readRecorder = ProgressRecorder::New();
+  readIO->AddObserver(itk::ProgressEvent(), readRecorder);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_EQUAL(readRecorder->m_Progress.size(), numberOfChunks + 1);
+  for (size_t i = 1; i < readRecorder->m_Progress.size(); ++i)
+  {
+    ITK_TEST_EXPECT_TRUE(readRecorder->m_Progress[i] > readRecorder->m_Progress[i - 1]);
+  }
+
+  // Abort the read through the reader as soon as the IO reports progress
+  auto abortingReader = itk::ImageFileReader<ImageType>::New();
+  abortingReader->SetFileName(outputFileName);
+  abortingReader->SetImageIO(readIO);
+  readIO->SetProgressSource(abortingReader);
+  auto abortCommand = itk::SimpleMemberCommand<itk::ProcessObject>::New();
+  abortCommand->SetCallbackFunction(abortingReader.GetPointer(), &itk::ProcessObject::AbortGenerateDataOn);
+  readIO->AddObserver(itk::ProgressEvent(), abortCommand);
+  readRecorder->m_Progress.clear();
+  ITK_TRY_EXPECT_EXCEPTION(abortingReader->Update());
+  ITK_TEST_EXPECT_TRUE(readRecorder->m_Progress.size() < numberOfChunks + 1);
+  readIO->SetProgressSource(nullptr);
+
+  // A progress source deleted before the IO is forgotten
+  {
+    auto temporaryReader = itk::ImageFileReader<ImageType>::New();
+    readIO->SetProgressSource(temporaryReader);
+  }
+  ITK_TEST_EXPECT_TRUE(readIO->GetProgressSource() == nullptr);
+  reader->Modified();
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
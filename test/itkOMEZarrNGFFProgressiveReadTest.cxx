@@ -0,0 +1,120 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Reads a physical box progressively from a multiscale volume, from the coarsest dataset
+/// to the finest, checking each level and the cancellation of the finer ones.
+
+#include "itkMath.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFPyramidTestUtilities.h"
+#include "itkOMEZarrNGFFTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = unsigned short;
+using ImageType = itk::Image<PixelType, 3>;
+
+const auto imageSize = itk::MakeSize(48, 32, 24);
+} // namespace
+
+int
+itkOMEZarrNGFFProgressiveReadTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputFileName = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  auto image = OMEZarrNGFFTest::MakeImage<ImageType>(imageSize);
+  image->SetSpacing(itk::MakeVector(1.0, 1.0, 2.0));
+  image->SetOrigin(itk::MakePoint(-20.0, 0.0, 5.0));
+  ITK_TRY_EXPECT_NO_EXCEPTION(OMEZarrNGFFPyramidTest::WritePyramid(outputFileName, image.GetPointer(), 4, 8));
+
+  auto imageIO = itk::OMEZarrNGFFImageIO::New();
+  imageIO->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetNumberOfDatasets(), 4u);
+
+  // Checks the pixels of each level against the image, and records the order of the levels
+  const std::vector<double> lower{ -12.5, 3.0, 9.0 };
+  const std::vector<double> upper{ 10.0, 27.5, 40.0 };
+  std::vector<unsigned>     levels;
+  const auto                checkLevel =
+    [&](unsigned datasetIndex, const itk::OMEZarrNGFFDatasetGeometry & geometry, const void * buffer) {
+      levels.push_back(datasetIndex);
+      const itk::IndexValueType factor = 1 << datasetIndex;
+      const auto *              pixels = static_cast<const PixelType *>(buffer);
+      for (itk::SizeValueType k = 0; k < geometry.size[2]; ++k)
+      {
+        for (itk::SizeValueType j = 0; j < geometry.size[1]; ++j)
+        {
+          for (itk::SizeValueType i = 0; i < geometry.size[0]; ++i)
+          {
+            // Pixels of every dataset are pixels of the image at the same physical point
+            ImageType::IndexType     index;
+            const itk::SizeValueType offsets[] = { i, j, k };
+            for (unsigned d = 0; d < 3; ++d)
+            {
+              index[d] = itk::Math::Round<itk::IndexValueType>(
+                (geometry.origin[d] + offsets[d] * geometry.spacing[d] - image->GetOrigin()[d]) /
+                image->GetSpacing()[d]);
+              itkAssertOrThrowMacro(index[d] % factor == 0, "Pixel is not on the grid of dataset " << datasetIndex);
+            }
+            const PixelType expected = OMEZarrNGFFTest::ExpectedValue<PixelType>(index, imageSize);
+            itkAssertOrThrowMacro(*pixels++ == expected,
+                                  "Pixel (" << i << ", " << j << ", " << k << ") of dataset " << datasetIndex
+                                            << " does not match the image");
+          }
+        }
+      }
+      return true;
+    };
+
+  ITK_TEST_EXPECT_EQUAL(imageIO->ReadProgressive(lower, upper, 0, 0, checkLevel), 4u);
+  ITK_TEST_EXPECT_TRUE((levels == std::vector<unsigned>{ 3, 2, 1, 0 }));
+
+  // Stop before the finest dataset
+  levels.clear();
+  ITK_TEST_EXPECT_EQUAL(imageIO->ReadProgressive(lower, upper, 0, 0, checkLevel, 2), 2u);
+  ITK_TEST_EXPECT_TRUE((levels == std::vector<unsigned>{ 3, 2 }));
+
+  // Cancel the finer datasets once the coarser ones have been shown
+  levels.clear();
+  const auto cancelAfterTwoLevels = [&](unsigned                                datasetIndex,
+                                        const itk::OMEZarrNGFFDatasetGeometry & geometry,
+                                        const void *                            buffer) {
+    checkLevel(datasetIndex, geometry, buffer);
+    return levels.size() < 2;
+  };
+  ITK_TEST_EXPECT_EQUAL(imageIO->ReadProgressive(lower, upper, 0, 0, cancelAfterTwoLevels), 2u);
+  ITK_TEST_EXPECT_TRUE((levels == std::vector<unsigned>{ 3, 2 }));
+
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ReadProgressive(lower, upper, 0, 0, checkLevel, 4));
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ReadProgressive({ 100.0, 0.0, 0.0 }, { 101.0, 1.0, 1.0 }, 0, 0, checkLevel));
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
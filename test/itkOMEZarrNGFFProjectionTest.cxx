@@ -0,0 +1,212 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Projects regions of a 4D store along each of its axes, chunk by chunk,
+/// and compares the results with projections of the image in memory.
+/// Then checks that Sum and Mean skip NaN pixels.
+
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageFileWriter.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = short;
+using ImageType = itk::Image<PixelType, 4>; // x, y, z, c
+using ProjectionEnum = itk::OMEZarrNGFFImageIOEnums::Projection;
+
+// Projection of the image in memory, as doubles, in ITK order with the projected axis collapsed
+std::vector<double>
+projectInMemory(const ImageType * image, const ImageType::RegionType & region, unsigned axis, ProjectionEnum projection)
+{
+  auto outputRegion = region;
+  outputRegion.SetSize(axis, 1);
+  std::vector<double> output;
+  itk::ImageRegionConstIteratorWithIndex<ImageType> outputIt(image, outputRegion);
+  for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); ++outputIt)
+  {
+    auto   index = outputIt.GetIndex();
+    double result = projection == ProjectionEnum::Maximum   ? -1e300
+                    : projection == ProjectionEnum::Minimum ? 1e300
+                                                            : 0.0;
+    for (itk::SizeValueType k = 0; k < region.GetSize(axis); ++k)
+    {
+      index[axis] = region.GetIndex(axis) + k;
+      const double value = image->GetPixel(index);
+      result = projection == ProjectionEnum::Maximum   ? std::max(result, value)
+               : projection == ProjectionEnum::Minimum ? std::min(result, value)
+                                                       : result + value;
+    }
+    output.push_back(projection == ProjectionEnum::Mean ? result / region.GetSize(axis) : result);
+  }
+  return output;
+}
+
+itk::ImageIORegion
+toIORegion(const ImageType::RegionType & region)
+{
+  itk::ImageIORegion ioRegion(4);
+  for (unsigned d = 0; d < 4; ++d)
+  {
+    ioRegion.SetIndex(d, region.GetIndex(d));
+    ioRegion.SetSize(d, region.GetSize(d));
+  }
+  return ioRegion;
+}
+} // namespace
+
+int
+itkOMEZarrNGFFProjectionTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char * outputFileName = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  auto image = ImageType::New();
+  image->SetRegions(itk::MakeSize(30, 21, 17, 2));
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    it.Set(static_cast<PixelType>((index[0] * 37 + index[1] * 101 + index[2] * 53 + index[3] * 11) % 3001 - 1500));
+  }
+  auto writeIO = itk::OMEZarrNGFFImageIO::New();
+  writeIO->SetChunkSize({ 8, 8, 8, 1 });
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetImageIO(writeIO);
+  writer->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  auto imageIO = itk::OMEZarrNGFFImageIO::New();
+  imageIO->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+
+  const ImageType::RegionType unalignedRegion(itk::MakeIndex(3, 5, 2, 1), itk::MakeSize(20, 11, 13, 1));
+  const std::vector<std::string> axisNames{ "x", "y", "z", "c" };
+  for (const auto & region : { image->GetLargestPossibleRegion(), unalignedRegion })
+  {
+    for (unsigned axis = 0; axis < 4; ++axis)
+    {
+      for (const auto projection :
+           { ProjectionEnum::Maximum, ProjectionEnum::Minimum, ProjectionEnum::Mean, ProjectionEnum::Sum })
+      {
+        const auto expected = projectInMemory(image, region, axis, projection);
+        std::vector<double> actual(expected.size());
+        if (projection == ProjectionEnum::Maximum || projection == ProjectionEnum::Minimum)
+        {
+          std::vector<PixelType> pixels(expected.size());
+          imageIO->ComputeProjection(toIORegion(region), axisNames[axis], projection, pixels.data(), 3);
+          std::copy(pixels.begin(), pixels.end(), actual.begin());
+        }
+        else
+        {
+          imageIO->ComputeProjection(toIORegion(region), axisNames[axis], projection, actual.data(), 3);
+        }
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+          itkAssertOrThrowMacro(std::abs(actual[i] - expected[i]) < 1e-9,
+                                projection << " along " << axisNames[axis] << " of " << region.GetIndex() << " "
+                                           << region.GetSize() << " differs at output pixel " << i << ": "
+                                           << actual[i] << " instead of " << expected[i]);
+        }
+      }
+    }
+  }
+
+  // A maximum-intensity projection of one channel along z, with the default number of threads
+  const ImageType::RegionType channelRegion(itk::MakeIndex(0, 0, 0, 1), itk::MakeSize(30, 21, 17, 1));
+  std::vector<PixelType>      mip(30 * 21);
+  ITK_TRY_EXPECT_NO_EXCEPTION(
+    imageIO->ComputeProjection(toIORegion(channelRegion), "z", ProjectionEnum::Maximum, mip.data()));
+  const auto expectedMip = projectInMemory(image, channelRegion, 2, ProjectionEnum::Maximum);
+  ITK_TEST_EXPECT_TRUE(std::equal(mip.begin(), mip.end(), expectedMip.begin()));
+
+  ITK_TRY_EXPECT_EXCEPTION(
+    imageIO->ComputeProjection(toIORegion(channelRegion), "t", ProjectionEnum::Maximum, mip.data()));
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ComputeProjection(itk::ImageIORegion(3), "z", ProjectionEnum::Maximum, mip.data()));
+
+  // NaN pixels are skipped by Sum and Mean, and Mean is NaN where every pixel is NaN
+  using FloatImageType = itk::Image<float, 3>;
+  auto floatImage = FloatImageType::New();
+  floatImage->SetRegions(itk::MakeSize(5, 4, 6));
+  floatImage->Allocate();
+  itk::ImageRegionIteratorWithIndex<FloatImageType> floatIt(floatImage, floatImage->GetLargestPossibleRegion());
+  for (floatIt.GoToBegin(); !floatIt.IsAtEnd(); ++floatIt)
+  {
+    const auto & index = floatIt.GetIndex();
+    const bool   isNaN = (index[0] == 0 && index[1] == 0) || (index[0] + index[1] + index[2]) % 3 == 0;
+    floatIt.Set(isNaN ? std::numeric_limits<float>::quiet_NaN() : static_cast<float>(index[2] + 1));
+  }
+  const std::string nanFileName = std::string(outputFileName) + ".nan.zarr";
+  auto              nanWriteIO = itk::OMEZarrNGFFImageIO::New();
+  nanWriteIO->SetChunkSize({ 2, 2, 4 });
+  auto floatWriter = itk::ImageFileWriter<FloatImageType>::New();
+  floatWriter->SetInput(floatImage);
+  floatWriter->SetImageIO(nanWriteIO);
+  floatWriter->SetFileName(nanFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(floatWriter->Update());
+
+  auto nanIO = itk::OMEZarrNGFFImageIO::New();
+  nanIO->SetFileName(nanFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(nanIO->ReadImageInformation());
+  itk::ImageIORegion nanRegion(3);
+  for (unsigned d = 0; d < 3; ++d)
+  {
+    nanRegion.SetSize(d, floatImage->GetLargestPossibleRegion().GetSize(d));
+  }
+  std::vector<double> sums(5 * 4);
+  std::vector<double> means(5 * 4);
+  nanIO->ComputeProjection(nanRegion, "z", ProjectionEnum::Sum, sums.data());
+  nanIO->ComputeProjection(nanRegion, "z", ProjectionEnum::Mean, means.data());
+  for (itk::IndexValueType y = 0; y < 4; ++y)
+  {
+    for (itk::IndexValueType x = 0; x < 5; ++x)
+    {
+      double   sum = 0.0;
+      unsigned count = 0;
+      for (itk::IndexValueType z = 0; z < 6; ++z)
+      {
+        const float value = floatImage->GetPixel(itk::MakeIndex(x, y, z));
+        if (value == value)
+        {
+          sum += value;
+          ++count;
+        }
+      }
+      const double mean = means[y * 5 + x];
+      itkAssertOrThrowMacro(sums[y * 5 + x] == sum, "Sum at " << x << ", " << y << " is " << sums[y * 5 + x]);
+      itkAssertOrThrowMacro(count > 0 ? mean == sum / count : mean != mean,
+                            "Mean at " << x << ", " << y << " is " << mean);
+    }
+  }
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
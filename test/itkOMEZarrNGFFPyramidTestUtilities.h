@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkOMEZarrNGFFPyramidTestUtilities_h
+#define itkOMEZarrNGFFPyramidTestUtilities_h
+
+/// Writes a multiscale OME-Zarr store for tests of multi-resolution reads,
+/// as the writer itself only produces one dataset per image.
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkOMEZarrNGFFImageIO.h"
+
+namespace OMEZarrNGFFPyramidTest
+{
+/** Writes `image` as dataset s0 of `fileName`, and datasets s1, s2, ... subsampled by 2, 4, ...
+ * along the spatial axes, so the pixels of each dataset are pixels of the image at the same
+ * physical points. Then replaces .zattrs with one listing all the datasets. */
+template <typename TImage>
+void
+WritePyramid(const std::string & fileName, const TImage * image, unsigned numberOfDatasets, unsigned chunkSize)
+{
+  constexpr unsigned Dimension = TImage::ImageDimension;
+  constexpr unsigned SpatialDimension = Dimension < 3 ? Dimension : 3;
+  const std::string  names[] = { "x", "y", "z", "c", "t" };
+  const std::string  types[] = { "space", "space", "space", "channel", "time" };
+
+  std::ostringstream datasets;
+  datasets.precision(17);
+  for (unsigned level = 0; level < numberOfDatasets; ++level)
+  {
+    const unsigned factor = 1u << level;
+    auto           levelImage = TImage::New();
+    auto           size = image->GetLargestPossibleRegion().GetSize();
+    auto           spacing = image->GetSpacing();
+    for (unsigned d = 0; d < SpatialDimension; ++d)
+    {
+      size[d] = (size[d] + factor - 1) / factor;
+      spacing[d] *= factor;
+    }
+    levelImage->SetRegions(size);
+    levelImage->SetSpacing(spacing);
+    levelImage->SetOrigin(image->GetOrigin());
+    levelImage->Allocate();
+    itk::ImageRegionIteratorWithIndex<TImage> it(levelImage, levelImage->GetLargestPossibleRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      auto index = it.GetIndex();
+      for (unsigned d = 0; d < SpatialDimension; ++d)
+      {
+        index[d] *= factor;
+      }
+      it.Set(image->GetPixel(index));
+    }
+
+    auto imageIO = itk::OMEZarrNGFFImageIO::New();
+    imageIO->SetDatasetIndex(level);
+    imageIO->SetChunkSize(std::vector<itk::SizeValueType>(SpatialDimension, chunkSize));
+    auto writer = itk::ImageFileWriter<TImage>::New();
+    writer->SetInput(levelImage);
+    writer->SetImageIO(imageIO);
+    writer->SetFileName(fileName);
+    writer->Update();
+
+    // Transformations in the reverse (store) axis order
+    datasets << (level > 0 ? ", " : "") << R"({ "path": "s)" << level
+             << R"(", "coordinateTransformations": [ { "type": "scale", "scale": [)";
+    for (unsigned d = Dimension; d > 0; --d)
+    {
+      datasets << spacing[d - 1] << (d > 1 ? ", " : "");
+    }
+    datasets << R"(] }, { "type": "translation", "translation": [)";
+    for (unsigned d = Dimension; d > 0; --d)
+    {
+      datasets << image->GetOrigin()[d - 1] << (d > 1 ? ", " : "");
+    }
+    datasets << "] } ] }";
+  }
+
+  std::ofstream zattrs(fileName + "/.zattrs");
+  zattrs << R"({ "multiscales": [ { "version": "0.4", "axes": [)";
+  for (unsigned d = Dimension; d > 0; --d)
+  {
+    zattrs << R"({ "name": ")" << names[d - 1] << R"(", "type": ")" << types[d - 1] << R"(" })" << (d > 1 ? ", " : "");
+  }
+  zattrs << R"(], "datasets": [ )" << datasets.str() << " ] } ] }" << std::endl;
+}
+} // namespace OMEZarrNGFFPyramidTest
+
+#endif // itkOMEZarrNGFFPyramidTestUtilities_h
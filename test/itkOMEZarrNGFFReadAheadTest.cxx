@@ -0,0 +1,151 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Reads a volume slice by slice with read-ahead, forwards, backwards and out of order,
+/// checking the pixels and the read-ahead statistics.
+
+#include "itkMetaDataObject.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = unsigned short;
+using ImageType = itk::Image<PixelType, 3>;
+
+constexpr itk::SizeValueType sizeX = 32;
+constexpr itk::SizeValueType sizeY = 24;
+constexpr itk::SizeValueType sizeZ = 40;
+
+const auto imageSize = itk::MakeSize(sizeX, sizeY, sizeZ);
+
+// Reads the slices in the given order, checking their pixels
+void
+readSlices(itk::OMEZarrNGFFImageIO * imageIO, const std::vector<itk::IndexValueType> & slices)
+{
+  std::vector<PixelType> buffer(sizeX * sizeY);
+  for (const itk::IndexValueType z : slices)
+  {
+    itk::ImageIORegion region(3);
+    region.SetIndex(2, z);
+    region.SetSize(0, sizeX);
+    region.SetSize(1, sizeY);
+    region.SetSize(2, 1);
+    imageIO->SetIORegion(region);
+    imageIO->Read(buffer.data());
+    for (itk::SizeValueType y = 0; y < sizeY; ++y)
+    {
+      for (itk::SizeValueType x = 0; x < sizeX; ++x)
+      {
+        const auto expected = OMEZarrNGFFTest::ExpectedValue<PixelType>(itk::MakeIndex(x, y, z), imageSize);
+        itkAssertOrThrowMacro(buffer[x + sizeX * y] == expected,
+                              "Pixel (" << x << ", " << y << ", " << z << ") does not match");
+      }
+    }
+  }
+}
+
+std::vector<itk::IndexValueType>
+sliceRange(itk::IndexValueType first, itk::IndexValueType last, itk::IndexValueType step)
+{
+  std::vector<itk::IndexValueType> slices;
+  for (auto z = first; step > 0 ? z <= last : z >= last; z += step)
+  {
+    slices.push_back(z);
+  }
+  return slices;
+}
+} // namespace
+
+int
+itkOMEZarrNGFFReadAheadTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char * outputFileName = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  // 4 x 3 chunks per layer of 8 slices, 5 layers
+  auto writeIO = itk::OMEZarrNGFFImageIO::New();
+  writeIO->SetChunkSize({ 8, 8, 8 });
+  ITK_TRY_EXPECT_NO_EXCEPTION(
+    OMEZarrNGFFTest::WriteImage<ImageType>(OMEZarrNGFFTest::MakeImage<ImageType>(imageSize), outputFileName, writeIO));
+  constexpr uint64_t chunksPerLayer = 4 * 3;
+
+  // Without read-ahead, sequential reads are not tracked
+  auto imageIO = itk::OMEZarrNGFFImageIO::New();
+  ITK_TEST_SET_GET_VALUE(0u, imageIO->GetReadAheadDepth());
+  imageIO->SetFileName(outputFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+  ITK_TRY_EXPECT_NO_EXCEPTION(readSlices(imageIO, sliceRange(0, 39, 1)));
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetCumulativeReadStatistics().readAheadHits, 0u);
+  ITK_TEST_EXPECT_EQUAL(imageIO->GetCumulativeReadStatistics().chunksReadAhead, 0u);
+
+  // Forwards along z, each layer is requested ahead at most once. The reads of
+  // the 7 later slices of each layer always hit, whether or not its first slice did.
+  imageIO->SetReadAheadDepth(2);
+  ITK_TEST_SET_GET_VALUE(2u, imageIO->GetReadAheadDepth());
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+  imageIO->ResetReadStatistics();
+  ITK_TRY_EXPECT_NO_EXCEPTION(readSlices(imageIO, sliceRange(0, 39, 1)));
+  auto statistics = imageIO->GetCumulativeReadStatistics();
+  std::cout << "Forwards: " << statistics << std::endl;
+  ITK_TEST_EXPECT_EQUAL(statistics.readAheadHits + statistics.readAheadMisses, 39u);
+  ITK_TEST_EXPECT_TRUE(statistics.readAheadHits >= 35);
+  ITK_TEST_EXPECT_TRUE(statistics.chunksReadAhead > 0);
+  ITK_TEST_EXPECT_TRUE(statistics.chunksReadAhead <= 4 * chunksPerLayer);
+  uint64_t hits = 0;
+  ITK_TEST_EXPECT_TRUE(
+    itk::ExposeMetaData<uint64_t>(imageIO->GetMetaDataDictionary(), "OMEZarrNGFFLastReadReadAheadHits", hits));
+  ITK_TEST_EXPECT_EQUAL(hits, imageIO->GetLastReadStatistics().readAheadHits);
+
+  // Backwards along z. Reading the last slice again restarts the detection.
+  imageIO->ResetReadStatistics();
+  ITK_TRY_EXPECT_NO_EXCEPTION(readSlices(imageIO, sliceRange(39, 0, -1)));
+  statistics = imageIO->GetCumulativeReadStatistics();
+  std::cout << "Backwards: " << statistics << std::endl;
+  ITK_TEST_EXPECT_EQUAL(statistics.readAheadHits + statistics.readAheadMisses, 38u);
+  ITK_TEST_EXPECT_TRUE(statistics.readAheadHits >= 34);
+
+  // Slices which do not adjoin the previous ones are not sequential
+  imageIO->ResetReadStatistics();
+  ITK_TRY_EXPECT_NO_EXCEPTION(readSlices(imageIO, sliceRange(0, 39, 3)));
+  statistics = imageIO->GetCumulativeReadStatistics();
+  ITK_TEST_EXPECT_EQUAL(statistics.readAheadHits + statistics.readAheadMisses, 0u);
+  ITK_TEST_EXPECT_EQUAL(statistics.chunksReadAhead, 0u);
+
+  // A cache which only holds the layer being read leaves no room for reading ahead
+  imageIO->SetReadAheadCacheSize(chunksPerLayer * 8 * 8 * 8 * sizeof(PixelType));
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+  imageIO->ResetReadStatistics();
+  ITK_TRY_EXPECT_NO_EXCEPTION(readSlices(imageIO, sliceRange(0, 39, 1)));
+  statistics = imageIO->GetCumulativeReadStatistics();
+  ITK_TEST_EXPECT_EQUAL(statistics.chunksReadAhead, 0u);
+  ITK_TEST_EXPECT_EQUAL(statistics.readAheadHits + statistics.readAheadMisses, 39u);
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
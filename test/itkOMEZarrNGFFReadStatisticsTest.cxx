@@ -0,0 +1,105 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Validates the statistics recorded by full and subregion reads.
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMetaDataObject.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkTestingMacros.h"
+
+int
+itkOMEZarrNGFFReadStatisticsTest(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Input Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char * inputFileName = argv[1];
+  const char * outputFileName = argv[2];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  // Store the 256x256 input with 64x64 chunks
+  using ImageType = itk::Image<unsigned char, 2>;
+  auto image = itk::ReadImage<ImageType>(inputFileName);
+  auto writeIO = itk::OMEZarrNGFFImageIO::New();
+  writeIO->SetChunkSize({ 64, 64 });
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetFileName(outputFileName);
+  writer->SetImageIO(writeIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // A full read requests all chunks, and includes the time taken to open the store
+  auto zarrIO = itk::OMEZarrNGFFImageIO::New();
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetFileName(outputFileName);
+  reader->SetImageIO(zarrIO);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+
+  const auto fullRead = zarrIO->GetLastReadStatistics();
+  std::cout << "Full read: " << fullRead << std::endl;
+  const auto size = image->GetLargestPossibleRegion().GetSize();
+  ITK_TEST_EXPECT_EQUAL(fullRead.chunksRequested, ((size[0] + 63) / 64) * ((size[1] + 63) / 64));
+  ITK_TEST_EXPECT_TRUE(fullRead.openSeconds > 0.0);
+  ITK_TEST_EXPECT_TRUE(fullRead.readSeconds > 0.0);
+
+  // The full read covers whole chunks, which tensorstore fetches and decodes
+  ITK_TEST_EXPECT_EQUAL(fullRead.chunksDecodedBlockwise, 0u);
+  ITK_TEST_EXPECT_EQUAL(fullRead.bytesFetched, 0u);
+  ITK_TEST_EXPECT_EQUAL(fullRead.cacheHits + fullRead.cacheMisses, 0u);
+
+  uint64_t chunksRequested = 0;
+  ITK_TEST_EXPECT_TRUE(itk::ExposeMetaData<uint64_t>(
+    zarrIO->GetMetaDataDictionary(), "OMEZarrNGFFLastReadChunksRequested", chunksRequested));
+  ITK_TEST_EXPECT_EQUAL(chunksRequested, fullRead.chunksRequested);
+
+  // A region straddling the corner of four chunks requests exactly those
+  ImageType::RegionType region(itk::MakeIndex(60, 60), itk::MakeSize(8, 8));
+  auto                  subregionReader = itk::ImageFileReader<ImageType>::New();
+  subregionReader->SetFileName(outputFileName);
+  subregionReader->SetImageIO(zarrIO);
+  subregionReader->GetOutput()->SetRequestedRegion(region);
+  ITK_TRY_EXPECT_NO_EXCEPTION(subregionReader->Update());
+
+  const auto & subregionRead = zarrIO->GetLastReadStatistics();
+  std::cout << "Subregion read: " << subregionRead << std::endl;
+  ITK_TEST_EXPECT_EQUAL(subregionRead.chunksRequested, 4u);
+
+  // It covers part of each of them, so the chunks of the default blosc compressor
+  // are fetched and decoded by the IO, which measures them for each read
+  ITK_TEST_EXPECT_EQUAL(subregionRead.chunksDecodedBlockwise, 4u);
+  ITK_TEST_EXPECT_TRUE(subregionRead.bytesFetched > 0);
+
+  const auto & cumulative = zarrIO->GetCumulativeReadStatistics();
+  std::cout << "Cumulative: " << cumulative << std::endl;
+  ITK_TEST_EXPECT_TRUE(cumulative.chunksRequested >= chunksRequested + 4);
+  ITK_TEST_EXPECT_EQUAL(cumulative.bytesFetched, subregionRead.bytesFetched);
+
+  zarrIO->ResetReadStatistics();
+  ITK_TEST_EXPECT_EQUAL(zarrIO->GetCumulativeReadStatistics().chunksRequested, 0u);
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
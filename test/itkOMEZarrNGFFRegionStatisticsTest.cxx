@@ -0,0 +1,161 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Reduces regions of a 4D store chunk by chunk with different numbers of threads,
+/// and compares the results with a reduction of the image in memory.
+
+#include <cmath>
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageFileWriter.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<unsigned short, 4>; // x, y, z, c
+
+itk::OMEZarrNGFFRegionStatistics
+reduceInMemory(const ImageType * image, const ImageType::RegionType & region, unsigned bins, double low, double high)
+{
+  itk::OMEZarrNGFFRegionStatistics statistics;
+  statistics.histogram.assign(bins, 0);
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const double value = it.Get();
+    ++statistics.count;
+    statistics.minimum = std::min(statistics.minimum, value);
+    statistics.maximum = std::max(statistics.maximum, value);
+    statistics.sum += value;
+    statistics.sumOfSquares += value * value;
+    if (bins > 0)
+    {
+      const auto bin = static_cast<long>((value - low) * (bins / (high - low)));
+      ++statistics.histogram[std::clamp(bin, 0L, static_cast<long>(bins) - 1)];
+    }
+  }
+  return statistics;
+}
+
+itk::ImageIORegion
+toIORegion(const ImageType::RegionType & region)
+{
+  itk::ImageIORegion ioRegion(4);
+  for (unsigned d = 0; d < 4; ++d)
+  {
+    ioRegion.SetIndex(d, region.GetIndex(d));
+    ioRegion.SetSize(d, region.GetSize(d));
+  }
+  return ioRegion;
+}
+} // namespace
+
+int
+itkOMEZarrNGFFRegionStatisticsTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " OutputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  auto image = ImageType::New();
+  image->SetRegions(itk::MakeSize(30, 21, 17, 3));
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    it.Set(static_cast<unsigned short>((index[0] * 97 + index[1] * 31 + index[2] * 7) % 4000 + index[3] * 10000));
+  }
+  const std::string fileName = outputDirectory + "/regionStatistics.zarr";
+  auto              writeIO = itk::OMEZarrNGFFImageIO::New();
+  writeIO->SetChunkSize({ 8, 8, 8, 1 });
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetImageIO(writeIO);
+  writer->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  auto imageIO = itk::OMEZarrNGFFImageIO::New();
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ComputeRegionStatistics(toIORegion(image->GetLargestPossibleRegion())));
+  imageIO->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageIO->ReadImageInformation());
+
+  ImageType::RegionType unalignedRegion(itk::MakeIndex(3, 5, 2, 1), itk::MakeSize(20, 11, 9, 2));
+  for (const auto & region : { image->GetLargestPossibleRegion(), unalignedRegion })
+  {
+    for (const unsigned numberOfThreads : { 1u, 4u, 0u })
+    {
+      const auto statistics = imageIO->ComputeRegionStatistics(toIORegion(region), 64, 0.0, 32000.0, numberOfThreads);
+      const auto expected = reduceInMemory(image, region, 64, 0.0, 32000.0);
+      std::cout << region.GetIndex() << " " << region.GetSize() << ", " << numberOfThreads
+                << " threads: " << statistics << std::endl;
+      ITK_TEST_EXPECT_EQUAL(statistics.count, expected.count);
+      ITK_TEST_EXPECT_EQUAL(statistics.minimum, expected.minimum);
+      ITK_TEST_EXPECT_EQUAL(statistics.maximum, expected.maximum);
+      ITK_TEST_EXPECT_EQUAL(statistics.sum, expected.sum);
+      ITK_TEST_EXPECT_EQUAL(statistics.sumOfSquares, expected.sumOfSquares);
+      ITK_TEST_EXPECT_TRUE(statistics.histogram == expected.histogram);
+      ITK_TEST_EXPECT_TRUE(std::abs(statistics.GetMean() - expected.GetMean()) < 1e-9);
+    }
+  }
+
+  // Without a histogram
+  const auto noHistogram = imageIO->ComputeRegionStatistics(toIORegion(unalignedRegion));
+  ITK_TEST_EXPECT_TRUE(noHistogram.histogram.empty());
+  ITK_TEST_EXPECT_EQUAL(noHistogram.count, unalignedRegion.GetNumberOfPixels());
+
+  // Invalid requests
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ComputeRegionStatistics(itk::ImageIORegion(3)));
+  ITK_TRY_EXPECT_EXCEPTION(
+    imageIO->ComputeRegionStatistics(toIORegion({ itk::MakeIndex(0, 0, 0, 1), itk::MakeSize(30, 21, 17, 3) })));
+  ITK_TRY_EXPECT_EXCEPTION(imageIO->ComputeRegionStatistics(toIORegion(unalignedRegion), 16, 5.0, 5.0));
+
+  // NaN pixels are skipped
+  using FloatImageType = itk::Image<float, 3>;
+  auto floatImage = FloatImageType::New();
+  floatImage->SetRegions(itk::MakeSize(9, 9, 9));
+  floatImage->Allocate();
+  floatImage->FillBuffer(-2.5f);
+  floatImage->SetPixel(itk::MakeIndex(4, 4, 4), std::nanf(""));
+  floatImage->SetPixel(itk::MakeIndex(8, 8, 8), 3.5f);
+  const std::string floatFileName = outputDirectory + "/regionStatisticsFloat.zarr";
+  itk::WriteImage(floatImage, floatFileName);
+  auto floatIO = itk::OMEZarrNGFFImageIO::New();
+  floatIO->SetFileName(floatFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(floatIO->ReadImageInformation());
+  itk::ImageIORegion floatRegion(3);
+  floatRegion.SetSize({ 9, 9, 9 });
+  const auto floatStatistics = floatIO->ComputeRegionStatistics(floatRegion, 4, -4.0, 4.0);
+  ITK_TEST_EXPECT_EQUAL(floatStatistics.count, 9 * 9 * 9 - 1);
+  ITK_TEST_EXPECT_EQUAL(floatStatistics.minimum, -2.5);
+  ITK_TEST_EXPECT_EQUAL(floatStatistics.maximum, 3.5);
+  ITK_TEST_EXPECT_EQUAL(floatStatistics.histogram[0], 9 * 9 * 9 - 2);
+  ITK_TEST_EXPECT_EQUAL(floatStatistics.histogram[3], 1);
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
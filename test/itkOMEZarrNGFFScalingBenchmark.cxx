@@ -0,0 +1,301 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Measures how the throughput of concurrent region reads from one
+/// OMEZarrNGFFImageIO scales with the number of reading threads.
+/// For each storage driver, every thread count from 1 up to the maximum (doubling)
+/// and both chunk-aligned and unaligned regions of interest, all threads read
+/// random regions through ReadRegion of a single shared IO object.
+/// Results are written as JSON, one record per combination.
+
+#include "itkOMEZarrNGFFBenchmarkUtilities.h"
+
+#include "itkImageFileWriter.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itksys/SystemTools.hxx"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace
+{
+using namespace OMEZarrNGFFBenchmark;
+using PixelType = uint16_t;
+
+struct Configuration
+{
+  std::string              outputDirectory;
+  itk::SizeValueType       volumeSize = 256;
+  itk::SizeValueType       chunkSize = 64;
+  unsigned                 maximumNumberOfThreads = 64;
+  unsigned                 readsPerThread = 64;
+  std::vector<std::string> drivers{ "file", "zip", "memory" };
+};
+
+/** Runs `numberOfThreads` threads which each read `readsPerThread` random regions of one chunk's size,
+ * either aligned to the chunk grid or at arbitrary offsets, and adds the measurements to the record.
+ * Returns the aggregate throughput in MB/s. */
+double
+measureConcurrentReads(const Configuration &           config,
+                       const itk::OMEZarrNGFFImageIO * zarrIO,
+                       const unsigned                  numberOfThreads,
+                       const bool                      aligned,
+                       JSONRecord &                    record)
+{
+  const itk::SizeValueType n = config.volumeSize;
+  const itk::SizeValueType roiSize = std::min(config.chunkSize, n); // one chunk
+
+  std::vector<std::vector<double>> latencies(numberOfThreads);
+  std::atomic<unsigned>            failures{ 0 };
+  std::atomic<unsigned>            ready{ 0 };
+  std::atomic<bool>                go{ false };
+  const auto                       readRandomRegions = [&](const unsigned threadId) {
+    std::mt19937                                       generator(1000 * threadId + (aligned ? 1 : 0));
+    std::uniform_int_distribution<itk::IndexValueType> offset(0, n - roiSize);
+    std::uniform_int_distribution<itk::IndexValueType> cell(0, n / roiSize - 1);
+    std::vector<PixelType>                             buffer(roiSize * roiSize * roiSize);
+    itk::ImageIORegion                                 region(3);
+    latencies[threadId].reserve(config.readsPerThread);
+
+    // Start all threads together, so the measurement is not skewed by thread creation
+    ++ready;
+    while (!go.load())
+    {
+      std::this_thread::yield();
+    }
+    for (unsigned r = 0; r < config.readsPerThread; ++r)
+    {
+      for (unsigned d = 0; d < 3; ++d)
+      {
+        region.SetIndex(d, aligned ? cell(generator) * roiSize : offset(generator));
+        region.SetSize(d, roiSize);
+      }
+      const auto start = Clock::now();
+      try
+      {
+        zarrIO->ReadRegion(region, 0, 0, buffer.data());
+      }
+      catch (const itk::ExceptionObject & e)
+      {
+        std::cerr << e << std::endl;
+        ++failures;
+        return;
+      }
+      latencies[threadId].push_back(SecondsSince(start));
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < numberOfThreads; ++t)
+  {
+    threads.emplace_back(readRandomRegions, t);
+  }
+  while (ready.load() < numberOfThreads)
+  {
+    std::this_thread::yield();
+  }
+  const auto start = Clock::now();
+  go = true;
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+  const double seconds = SecondsSince(start);
+  if (failures.load() > 0)
+  {
+    itkGenericExceptionMacro(<< failures.load() << " of " << numberOfThreads << " reading threads failed");
+  }
+
+  std::vector<double> allLatencies;
+  for (const auto & threadLatencies : latencies)
+  {
+    allLatencies.insert(allLatencies.end(), threadLatencies.begin(), threadLatencies.end());
+  }
+  const double megabytes =
+    double(allLatencies.size()) * roiSize * roiSize * roiSize * sizeof(PixelType) / (1024.0 * 1024.0);
+  record.Add("reads", uint64_t(allLatencies.size()));
+  record.Add("wall_s", seconds);
+  record.Add("MBps", megabytes / seconds);
+  record.Add("reads_per_s", allLatencies.size() / seconds);
+  record.Add("p50_s", Percentile(allLatencies, 50));
+  record.Add("p99_s", Percentile(allLatencies, 99));
+  return megabytes / seconds;
+}
+
+void
+runDriver(const Configuration & config, const std::string & driver, std::vector<JSONRecord> & results)
+{
+  using ImageType = itk::Image<PixelType, 3>;
+  const itk::SizeValueType n = config.volumeSize;
+  const itk::SizeValueType c = std::min(config.chunkSize, n);
+
+  itk::OMEZarrNGFFImageIO::BufferInfo bufferInfo{ nullptr, 0 };
+  std::string                         fileName;
+  if (driver == "memory")
+  {
+    fileName = itk::OMEZarrNGFFImageIO::MakeMemoryFileName(bufferInfo);
+  }
+  else
+  {
+    fileName = config.outputDirectory + "/scaling" + (driver == "zip" ? ".zarr.zip" : ".zarr");
+  }
+
+  auto writeIO = itk::OMEZarrNGFFImageIO::New();
+  writeIO->SetChunkSize({ c, c, c });
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(MakeSyntheticVolume<PixelType>(itk::Size<3>{ { n, n, n } }));
+  writer->SetFileName(fileName);
+  writer->SetImageIO(writeIO);
+  writer->Update();
+  writeIO->FinalizeWrite();
+
+  // One IO object, opened once, is shared by all threads and thread counts
+  auto zarrIO = itk::OMEZarrNGFFImageIO::New();
+  zarrIO->SetFileName(fileName);
+  zarrIO->ReadImageInformation();
+
+  for (const bool aligned : { true, false })
+  {
+    double singleThreadMBps = 0.0;
+    for (unsigned numberOfThreads = 1; numberOfThreads <= config.maximumNumberOfThreads; numberOfThreads *= 2)
+    {
+      std::cout << driver << (aligned ? " aligned " : " unaligned ") << numberOfThreads << " threads" << std::endl;
+      JSONRecord record;
+      record.Add("driver", driver);
+      record.Add("aligned", aligned);
+      record.Add("threads", uint64_t(numberOfThreads));
+      record.Add("roi_size", std::vector<itk::SizeValueType>{ c, c, c });
+      const double MBps = measureConcurrentReads(config, zarrIO, numberOfThreads, aligned, record);
+      if (numberOfThreads == 1)
+      {
+        singleThreadMBps = MBps;
+      }
+      record.Add("speedup", MBps / singleThreadMBps);
+      results.push_back(record);
+    }
+  }
+
+  zarrIO = nullptr;
+  if (driver == "memory")
+  {
+    free(bufferInfo.pointer);
+  }
+  else if (driver == "zip")
+  {
+    itksys::SystemTools::RemoveFile(fileName);
+  }
+  else
+  {
+    itksys::SystemTools::RemoveADirectory(fileName);
+  }
+}
+} // namespace
+
+int
+main(int argc, char * argv[])
+{
+  if (argc < 3)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << argv[0]
+              << " outputDirectory results.json [--quick] [--size N] [--chunk-size N] [--max-threads N] [--reads N]"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Configuration config;
+  config.outputDirectory = argv[1];
+  const std::string resultsFileName = argv[2];
+  bool              quick = false;
+  for (int i = 3; i < argc; ++i)
+  {
+    if (!strcmp(argv[i], "--quick"))
+    {
+      // a small run, suitable as a smoke test
+      quick = true;
+      config.volumeSize = 64;
+      config.chunkSize = 16;
+      config.maximumNumberOfThreads = 4;
+      config.readsPerThread = 8;
+    }
+    else if (!strcmp(argv[i], "--size") && i + 1 < argc)
+    {
+      config.volumeSize = std::stoul(argv[++i]);
+    }
+    else if (!strcmp(argv[i], "--chunk-size") && i + 1 < argc)
+    {
+      config.chunkSize = std::stoul(argv[++i]);
+    }
+    else if (!strcmp(argv[i], "--max-threads") && i + 1 < argc)
+    {
+      config.maximumNumberOfThreads = std::stoul(argv[++i]);
+    }
+    else if (!strcmp(argv[i], "--reads") && i + 1 < argc)
+    {
+      config.readsPerThread = std::stoul(argv[++i]);
+    }
+    else
+    {
+      std::cerr << "Unknown argument: " << argv[i] << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+  itksys::SystemTools::MakeDirectory(config.outputDirectory);
+
+  std::vector<JSONRecord> results;
+  try
+  {
+    for (const auto & driver : config.drivers)
+    {
+      runDriver(config, driver, results);
+    }
+  }
+  catch (const itk::ExceptionObject & e)
+  {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  JSONRecord header;
+  header.Add("benchmark", "OMEZarrNGFFImageIO concurrent ReadRegion scaling");
+  header.Add("quick", quick);
+  header.Add("pixel_type", "uint16");
+  header.Add("volume_size", uint64_t(config.volumeSize));
+  header.Add("chunk_size", uint64_t(config.chunkSize));
+  header.Add("reads_per_thread", uint64_t(config.readsPerThread));
+  header.Add("hardware_concurrency", uint64_t(std::thread::hardware_concurrency()));
+
+  std::ofstream resultsFile(resultsFileName);
+  resultsFile << MakeJSONDocument(header, results);
+  if (!resultsFile.good())
+  {
+    std::cerr << "Could not write results to " << resultsFileName << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Wrote " << results.size() << " results to " << resultsFileName << std::endl;
+  return EXIT_SUCCESS;
+}
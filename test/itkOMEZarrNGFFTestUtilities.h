@@ -0,0 +1,76 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef itkOMEZarrNGFFTestUtilities_h
+#define itkOMEZarrNGFFTestUtilities_h
+
+/// Makes and writes test images whose pixels each hold a value computed from their index,
+/// so that the pixels read back can be checked wherever they came from.
+
+#include <string>
+
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace OMEZarrNGFFTest
+{
+/** The value of the pixel at `index` of a test image of `size`: its offset in the buffer plus `base`.
+ * The pixels of one image differ as long as the pixel type holds the number of pixels. */
+template <typename TPixel, unsigned VDimension>
+TPixel
+ExpectedValue(const itk::Index<VDimension> & index, const itk::Size<VDimension> & size, itk::SizeValueType base = 0)
+{
+  itk::SizeValueType offset = 0;
+  for (unsigned d = VDimension; d > 0; --d)
+  {
+    offset = offset * size[d - 1] + static_cast<itk::SizeValueType>(index[d - 1]);
+  }
+  return static_cast<TPixel>(base + offset);
+}
+
+/** Allocates an image of `size` with the spacing `spacing`, each pixel holding its ExpectedValue. */
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const typename TImage::SizeType & size, itk::SizeValueType base = 0, double spacing = 1.0)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->SetSpacing(spacing);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    it.Set(ExpectedValue<typename TImage::PixelType>(it.GetIndex(), size, base));
+  }
+  return image;
+}
+
+/** Writes `image` to `fileName` through `imageIO`, with ImageFileWriter. Throws if it fails. */
+template <typename TImage>
+void
+WriteImage(const TImage * image, const std::string & fileName, itk::ImageIOBase * imageIO)
+{
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(imageIO);
+  writer->Update();
+}
+} // namespace OMEZarrNGFFTest
+
+#endif // itkOMEZarrNGFFTestUtilities_h
@@ -0,0 +1,112 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Writes and reads an image with tracing enabled,
+/// and checks the expected spans are in the trace file.
+/// A trace file which cannot be opened through the environment disables tracing.
+
+#include <fstream>
+#include <sstream>
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+int
+itkOMEZarrNGFFTraceTest(int argc, char * argv[])
+{
+  if (argc < 4)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Input Output.zarr Trace.json" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char * inputFileName = argv[1];
+  const char * outputFileName = argv[2];
+  const char * traceFileName = argv[3];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  using ImageType = itk::Image<unsigned char, 2>;
+  auto image = itk::ReadImage<ImageType>(inputFileName);
+
+  {
+    auto zarrIO = itk::OMEZarrNGFFImageIO::New();
+    zarrIO->SetChunkSize({ 64, 64 });
+    zarrIO->SetTraceFileName(traceFileName);
+    ITK_TEST_EXPECT_EQUAL(std::string(zarrIO->GetTraceFileName()), std::string(traceFileName));
+
+    auto writer = itk::ImageFileWriter<ImageType>::New();
+    writer->SetInput(image);
+    writer->SetFileName(outputFileName);
+    writer->SetImageIO(zarrIO);
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+    // Blosc chunks which the region covers in part are fetched and decoded by the IO, the others by tensorstore
+    for (const bool partialChunkDecoding : { true, false })
+    {
+      zarrIO->SetPartialChunkDecoding(partialChunkDecoding);
+      auto reader = itk::ImageFileReader<ImageType>::New();
+      reader->SetFileName(outputFileName);
+      reader->SetImageIO(zarrIO);
+      reader->GetOutput()->SetRequestedRegion(ImageType::RegionType(itk::MakeIndex(60, 60), itk::MakeSize(8, 8)));
+      ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+    }
+  } // the trace file is completed once the IO is destroyed
+
+  std::ifstream     traceFile(traceFileName);
+  std::stringstream trace;
+  trace << traceFile.rdbuf();
+  const std::string traceText = trace.str();
+  std::cout << traceText.substr(0, 1000) << std::endl;
+
+  ITK_TEST_EXPECT_TRUE(!traceText.empty() && traceText.front() == '[');
+  ITK_TEST_EXPECT_TRUE(traceText.find(']') != std::string::npos);
+  for (const char * name : { "\"Write\"",
+                             "\"write chunk\"",
+                             "\"ReadImageInformation\"",
+                             "\"jsonRead\"",
+                             "\"ReadArrayMetadata\"",
+                             "\"Read\"",
+                             "\"fetch chunk\"",
+                             "\"decode chunk\"",
+                             "\"copy chunk\"",
+                             "\"read chunk\"" })
+  {
+    if (traceText.find(name) == std::string::npos)
+    {
+      std::cerr << "Missing span " << name << " in trace " << traceFileName << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Tracing to a directory fails, which disables it
+  const std::string unwritable = std::string(outputFileName) + "/trace.json/";
+  itksys::SystemTools::PutEnv("ITK_OMEZARRNGFF_TRACE=" + unwritable);
+  itk::OMEZarrNGFFImageIO::Pointer untracedIO;
+  ITK_TRY_EXPECT_NO_EXCEPTION(untracedIO = itk::OMEZarrNGFFImageIO::New());
+  ITK_TEST_EXPECT_TRUE(std::string(untracedIO->GetTraceFileName()).empty());
+  ITK_TRY_EXPECT_EXCEPTION(untracedIO->SetTraceFileName(unwritable));
+  itksys::SystemTools::UnPutEnv("ITK_OMEZARRNGFF_TRACE");
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
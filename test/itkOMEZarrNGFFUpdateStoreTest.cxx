@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Appends time points one at a time to an existing TCZYX store,
+/// then reads each of them back.
+
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkOMEZarrNGFFImageIO.h"
+#include "itkOMEZarrNGFFImageIOFactory.h"
+#include "itkOMEZarrNGFFTestUtilities.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using PixelType = unsigned short;
+using VolumeType = itk::Image<PixelType, 3>;
+
+constexpr unsigned NumberOfTimePoints = 4;
+
+const auto volumeSize = itk::MakeSize(9, 7, 5);
+
+// Each time point holds other values
+itk::SizeValueType
+timePointBase(const unsigned timeIndex)
+{
+  return 1000 * timeIndex;
+}
+} // namespace
+
+int
+itkOMEZarrNGFFUpdateStoreTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " Output" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char * outputFileName = argv[1];
+
+  itk::OMEZarrNGFFImageIOFactory::RegisterOneFactory();
+
+  // Create a TCZYX store holding a single time point
+  using TCZYXImageType = itk::Image<PixelType, 5>;
+  auto initialImage = TCZYXImageType::New();
+  initialImage->SetRegions(itk::MakeSize(volumeSize[0], volumeSize[1], volumeSize[2], 1, 1));
+  initialImage->Allocate(true);
+  auto zarrIO = itk::OMEZarrNGFFImageIO::New();
+  ITK_TRY_EXPECT_NO_EXCEPTION(OMEZarrNGFFTest::WriteImage<TCZYXImageType>(initialImage, outputFileName, zarrIO));
+
+  // Append (and overwrite the first) time points one volume at a time,
+  // through the image IO which created the store, which reopens it for updating
+  zarrIO->SetWriteMode(itk::OMEZarrNGFFImageIOEnums::WriteMode::Update);
+  ITK_TEST_SET_GET_VALUE(itk::OMEZarrNGFFImageIOEnums::WriteMode::Update, zarrIO->GetWriteMode());
+  zarrIO->SetChannelIndex(0);
+  for (unsigned t = 0; t < NumberOfTimePoints; ++t)
+  {
+    zarrIO->SetTimeIndex(t);
+    const auto volume = OMEZarrNGFFTest::MakeImage<VolumeType>(volumeSize, timePointBase(t));
+    ITK_TRY_EXPECT_NO_EXCEPTION(OMEZarrNGFFTest::WriteImage<VolumeType>(volume, outputFileName, zarrIO));
+  }
+
+  // A store without a selected time point cannot be updated
+  zarrIO->SetTimeIndex(itk::OMEZarrNGFFImageIO::INVALID_INDEX);
+  const auto invalidVolume = OMEZarrNGFFTest::MakeImage<VolumeType>(volumeSize);
+  ITK_TRY_EXPECT_EXCEPTION(OMEZarrNGFFTest::WriteImage<VolumeType>(invalidVolume, outputFileName, zarrIO));
+
+  // Validate the time axis has grown and each time point holds its own volume
+  for (unsigned t = 0; t < NumberOfTimePoints; ++t)
+  {
+    auto readIO = itk::OMEZarrNGFFImageIO::New();
+    readIO->SetTimeIndex(t);
+    readIO->SetChannelIndex(0);
+    auto reader = itk::ImageFileReader<VolumeType>::New();
+    reader->SetFileName(outputFileName);
+    reader->SetImageIO(readIO);
+    ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+    ITK_TEST_EXPECT_EQUAL(readIO->GetNumberOfDimensions(), 5);
+    ITK_TEST_EXPECT_EQUAL(readIO->GetDimensions(4), NumberOfTimePoints);
+
+    auto                                          volume = reader->GetOutput();
+    itk::ImageRegionIteratorWithIndex<VolumeType> it(volume, volume->GetBufferedRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const auto expected = OMEZarrNGFFTest::ExpectedValue<PixelType>(it.GetIndex(), volumeSize, timePointBase(t));
+      itkAssertOrThrowMacro(it.Get() == expected,
+                            "Pixel value mismatch at index " << it.GetIndex() << " of time point " << t);
+    }
+  }
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+/*=========================================================================
+ *
+ *  Copyright NumFOCUS
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         https://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+/// Writes zip archives with OMEZarrNGFFZipStreamWriter, and parses them back: the local headers
+/// at the offsets listed by the central directory, the entry contents and CRCs, the end of central
+/// directory record, and the ZIP64 records of an archive with more entries than fit its 16-bit count.
+
+#include "itkOMEZarrNGFFZipStreamWriter.h"
+#include "itkTestingMacros.h"
+#include "itk_zlib.h"
+
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+uint64_t
+readLE(const std::string & bytes, size_t offset, unsigned size)
+{
+  itkAssertOrThrowMacro(offset + size <= bytes.size(), "Record at " << offset << " is past the end of the archive");
+  uint64_t value = 0;
+  for (unsigned b = 0; b < size; ++b)
+  {
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[offset + b])) << (8 * b);
+  }
+  return value;
+}
+
+std::string
+readFile(const std::string & fileName)
+{
+  std::ifstream stream(fileName, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+uint32_t
+computeCRC32(const std::string & data)
+{
+  return static_cast<uint32_t>(
+    crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(data.data()), static_cast<uInt>(data.size())));
+}
+
+// Throws unless `value` is `expected`, as the ITK_TEST_EXPECT macros return from the test function
+void
+expectEqual(const uint64_t value, const uint64_t expected, const std::string & what)
+{
+  itkAssertOrThrowMacro(value == expected, what << " is " << value << " instead of " << expected);
+}
+
+// Checks that the archive holds exactly `entries` (name, content), in order,
+// and returns whether its end of central directory needed the ZIP64 records
+bool
+checkArchive(const std::string & fileName, const std::vector<std::pair<std::string, std::string>> & entries)
+{
+  const std::string archive = readFile(fileName);
+
+  // The end of central directory record is last, as there is no archive comment
+  itkAssertOrThrowMacro(archive.size() >= 22, "Archive " << fileName << " is too short");
+  const size_t endOffset = archive.size() - 22;
+  expectEqual(readLE(archive, endOffset, 4), 0x06054b50, "End of central directory signature");
+  uint64_t entryCount = readLE(archive, endOffset + 10, 2);
+  uint64_t centralDirectorySize = readLE(archive, endOffset + 12, 4);
+  uint64_t centralDirectoryOffset = readLE(archive, endOffset + 16, 4);
+
+  const bool zip64 = entryCount == 0xFFFF || centralDirectorySize == 0xFFFFFFFF || centralDirectoryOffset == 0xFFFFFFFF;
+  if (zip64)
+  {
+    // The locator precedes the end of central directory record, and points to the ZIP64 record before it
+    const size_t locatorOffset = endOffset - 20;
+    expectEqual(readLE(archive, locatorOffset, 4), 0x07064b50, "ZIP64 locator signature");
+    const uint64_t zip64EndOffset = readLE(archive, locatorOffset + 8, 8);
+    expectEqual(zip64EndOffset, locatorOffset - 56, "ZIP64 end of central directory offset");
+    expectEqual(readLE(archive, zip64EndOffset, 4), 0x06064b50, "ZIP64 end of central directory signature");
+    expectEqual(readLE(archive, zip64EndOffset + 4, 8), 44, "ZIP64 end of central directory size");
+    entryCount = readLE(archive, zip64EndOffset + 32, 8);
+    expectEqual(readLE(archive, zip64EndOffset + 24, 8), entryCount, "ZIP64 entry count of this disk");
+    centralDirectorySize = readLE(archive, zip64EndOffset + 40, 8);
+    centralDirectoryOffset = readLE(archive, zip64EndOffset + 48, 8);
+    expectEqual(centralDirectoryOffset + centralDirectorySize, zip64EndOffset, "End of the central directory");
+  }
+  else
+  {
+    expectEqual(centralDirectoryOffset + centralDirectorySize, endOffset, "End of the central directory");
+  }
+  expectEqual(entryCount, entries.size(), "Entry count");
+
+  // Each central directory header points to the local header of its entry, and the entries are contiguous
+  size_t   offset = centralDirectoryOffset;
+  uint64_t expectedLocalOffset = 0;
+  for (const auto & entry : entries)
+  {
+    const std::string & name = entry.first;
+    const std::string & content = entry.second;
+    const uint32_t      crc = computeCRC32(content);
+
+    expectEqual(readLE(archive, offset, 4), 0x02014b50, "Central directory signature of " + name);
+    expectEqual(readLE(archive, offset + 10, 2), 0, "Compression method of " + name);
+    expectEqual(readLE(archive, offset + 16, 4), crc, "Central directory CRC of " + name);
+    expectEqual(readLE(archive, offset + 20, 4), content.size(), "Central directory compressed size of " + name);
+    expectEqual(readLE(archive, offset + 24, 4), content.size(), "Central directory size of " + name);
+    const uint64_t nameLength = readLE(archive, offset + 28, 2);
+    const uint64_t extraLength = readLE(archive, offset + 30, 2);
+    const uint64_t commentLength = readLE(archive, offset + 32, 2);
+    const uint64_t localOffset = readLE(archive, offset + 42, 4);
+    itkAssertOrThrowMacro(archive.compare(offset + 46, nameLength, name) == 0,
+                          "Central directory name of " << name << " differs");
+    expectEqual(extraLength, 0, "Central directory extra field length of " + name);
+    expectEqual(localOffset, expectedLocalOffset, "Local header offset of " + name);
+    offset += 46 + nameLength + extraLength + commentLength;
+
+    expectEqual(readLE(archive, localOffset, 4), 0x04034b50, "Local header signature of " + name);
+    expectEqual(readLE(archive, localOffset + 14, 4), crc, "Local header CRC of " + name);
+    expectEqual(readLE(archive, localOffset + 18, 4), content.size(), "Local header compressed size of " + name);
+    expectEqual(readLE(archive, localOffset + 26, 2), name.size(), "Local header name length of " + name);
+    const uint64_t localExtraLength = readLE(archive, localOffset + 28, 2);
+    itkAssertOrThrowMacro(archive.compare(localOffset + 30, name.size(), name) == 0,
+                          "Local header name of " << name << " differs");
+    const size_t dataOffset = localOffset + 30 + name.size() + localExtraLength;
+    itkAssertOrThrowMacro(archive.compare(dataOffset, content.size(), content) == 0,
+                          "Content of " << name << " differs");
+    expectedLocalOffset = dataOffset + content.size();
+  }
+  expectEqual(offset, centralDirectoryOffset + centralDirectorySize, "End of the central directory headers");
+  expectEqual(expectedLocalOffset, centralDirectoryOffset, "End of the entries");
+  return zip64;
+}
+} // namespace
+
+int
+itkOMEZarrNGFFZipStreamWriterTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << itkNameOfTestExecutableMacro(argv) << " OutputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  // A few entries, including an empty one and binary content
+  std::vector<std::pair<std::string, std::string>> entries{
+    { ".zgroup", "{\"zarr_format\":2}" },
+    { "s0/0.0", std::string("\x00\x01\x02\xff\x80 binary", 12) },
+    { "s0/0.1", "" },
+    { "s0/.zarray", std::string(1000, 'a') },
+  };
+  const std::string fileName = outputDirectory + "/zipStreamWriter.zip";
+  {
+    itk::OMEZarrNGFFZipStreamWriter writer(fileName);
+    ITK_TEST_EXPECT_TRUE(writer.IsOpen());
+    ITK_TEST_EXPECT_EQUAL(writer.GetFileName(), fileName);
+    for (const auto & entry : entries)
+    {
+      ITK_TRY_EXPECT_NO_EXCEPTION(writer.AddEntry(entry.first, entry.second.data(), entry.second.size()));
+    }
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer.Close());
+    ITK_TEST_EXPECT_TRUE(!writer.IsOpen());
+    ITK_TRY_EXPECT_EXCEPTION(writer.AddEntry("late", "", 0));
+    ITK_TRY_EXPECT_EXCEPTION(writer.Close());
+  }
+  bool zip64 = true;
+  ITK_TRY_EXPECT_NO_EXCEPTION(zip64 = checkArchive(fileName, entries));
+  ITK_TEST_EXPECT_TRUE(!zip64);
+
+  // The destructor closes an archive which was not closed
+  {
+    itk::OMEZarrNGFFZipStreamWriter writer(fileName);
+    writer.AddEntry(entries[0].first, entries[0].second.data(), entries[0].second.size());
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(zip64 = checkArchive(fileName, { entries[0] }));
+  ITK_TEST_EXPECT_TRUE(!zip64);
+
+  // More entries than the 16-bit count of the end of central directory record holds
+  std::vector<std::pair<std::string, std::string>> manyEntries;
+  for (unsigned i = 0; i < 0x10000; ++i)
+  {
+    manyEntries.emplace_back("s0/" + std::to_string(i), std::to_string(i % 7));
+  }
+  const std::string zip64FileName = outputDirectory + "/zipStreamWriter64.zip";
+  {
+    itk::OMEZarrNGFFZipStreamWriter writer(zip64FileName);
+    for (const auto & entry : manyEntries)
+    {
+      writer.AddEntry(entry.first, entry.second.data(), entry.second.size());
+    }
+    ITK_TRY_EXPECT_NO_EXCEPTION(writer.Close());
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(zip64 = checkArchive(zip64FileName, manyEntries));
+  ITK_TEST_EXPECT_TRUE(zip64);
+
+  // An archive which cannot be created
+  ITK_TRY_EXPECT_EXCEPTION(itk::OMEZarrNGFFZipStreamWriter(outputDirectory + "/missing/directory/archive.zip"));
+
+  std::cout << "Test finished" << std::endl;
+  return EXIT_SUCCESS;
+}
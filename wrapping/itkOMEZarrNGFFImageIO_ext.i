@@ -0,0 +1,242 @@
+%{
+#include <exception>
+#include <stdexcept>
+%}
+
+%extend itkOMEZarrNGFFImageIO {
+  // Shape, chunk shape, NumPy type string and axis names of a dataset of the opened image,
+  // in store (NumPy) order
+  PyObject *
+  GetDatasetArrayInfo(unsigned datasetIndex)
+  {
+    const itk::OMEZarrNGFFDatasetGeometry geometry = self->GetDatasetGeometry(datasetIndex);
+    const auto &                          axes = self->GetStoreAxes(); // ITK order
+    const Py_ssize_t                      dimension = geometry.size.size();
+    PyObject *                            shape = PyTuple_New(dimension);
+    PyObject *                            chunks = PyTuple_New(dimension);
+    PyObject *                            names = PyTuple_New(dimension);
+    for (Py_ssize_t d = 0; d < dimension; ++d)
+    {
+      PyTuple_SET_ITEM(shape, dimension - 1 - d, PyLong_FromSize_t(geometry.size[d]));
+      PyTuple_SET_ITEM(chunks, dimension - 1 - d, PyLong_FromSize_t(geometry.chunkSize[d]));
+      PyTuple_SET_ITEM(names, dimension - 1 - d, PyUnicode_FromString(axes[d].name.c_str()));
+    }
+
+    char kind = 'i';
+    switch (self->GetComponentType())
+    {
+      case itk::IOComponentEnum::FLOAT:
+      case itk::IOComponentEnum::DOUBLE:
+        kind = 'f';
+        break;
+      case itk::IOComponentEnum::UCHAR:
+      case itk::IOComponentEnum::USHORT:
+      case itk::IOComponentEnum::UINT:
+      case itk::IOComponentEnum::ULONG:
+      case itk::IOComponentEnum::ULONGLONG:
+        kind = 'u';
+        break;
+      default:
+        break;
+    }
+    const std::string typestr = std::string("=") + kind + std::to_string(self->GetComponentSize());
+    return Py_BuildValue("(NNsN)", shape, chunks, typestr.c_str(), names);
+  }
+
+  // Reads a region of a dataset, as ReadDatasetRegion, into an object supporting the writable,
+  // C-contiguous buffer protocol, such as a NumPy array. The index and size are sequences in ITK order.
+  // The global interpreter lock is released during the read, so reads from several threads run concurrently.
+  void
+  ReadDatasetRegionIntoBuffer(unsigned datasetIndex,
+                              PyObject * index,
+                              PyObject * size,
+                              int timeIndex,
+                              int channelIndex,
+                              PyObject * buffer)
+  {
+    const Py_ssize_t dimension = PySequence_Size(index);
+    if (dimension < 0 || PySequence_Size(size) != dimension)
+    {
+      PyErr_Clear();
+      throw std::invalid_argument("index and size must be sequences of the same length");
+    }
+    itk::ImageIORegion region(dimension);
+    for (Py_ssize_t d = 0; d < dimension; ++d)
+    {
+      PyObject * indexItem = PySequence_GetItem(index, d);
+      PyObject * sizeItem = PySequence_GetItem(size, d);
+      if (indexItem != nullptr && sizeItem != nullptr)
+      {
+        region.SetIndex(d, PyLong_AsLongLong(indexItem));
+        region.SetSize(d, PyLong_AsUnsignedLongLong(sizeItem));
+      }
+      Py_XDECREF(indexItem);
+      Py_XDECREF(sizeItem);
+    }
+    if (PyErr_Occurred())
+    {
+      PyErr_Clear();
+      throw std::invalid_argument("index and size must hold non-negative integers");
+    }
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(buffer, &view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0)
+    {
+      PyErr_Clear();
+      throw std::invalid_argument("buffer must be a writable, C-contiguous array");
+    }
+    const auto requiredLength = region.GetNumberOfPixels() * self->GetComponentSize(); // of one channel
+    if (static_cast<size_t>(view.len) < requiredLength)
+    {
+      PyBuffer_Release(&view);
+      throw std::length_error("buffer is smaller than the region");
+    }
+
+    std::exception_ptr failure;
+    Py_BEGIN_ALLOW_THREADS
+    try
+    {
+      self->ReadDatasetRegion(datasetIndex, region, timeIndex, channelIndex, view.buf);
+    }
+    catch (...)
+    {
+      failure = std::current_exception();
+    }
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&view);
+    if (failure)
+    {
+      std::rethrow_exception(failure);
+    }
+  }
+
+  %pythoncode %{
+    def GetLazyArray(self, dataset_index=None):
+        """A dataset of the image opened by ReadImageInformation as a lazy array,
+        DatasetIndex by default. See OMEZarrNGFFLazyArray."""
+        if dataset_index is None:
+            dataset_index = self.GetDatasetIndex()
+        return OMEZarrNGFFLazyArray(self, dataset_index)
+  %}
+}
+
+%pythoncode %{
+class OMEZarrNGFFLazyArray:
+    """A dataset of an OME-Zarr image as a lazy, NumPy-like array.
+
+    The axes are in store order, as in NumPy, e.g. ("t", "c", "z", "y", "x"), and named by `dims`.
+    Indexing with integers and slices reads only the selected region from the store,
+    directly into the returned NumPy array, through the chunk cache of the image IO.
+    `chunks` is the chunk shape of the array, so that dask can map over whole chunks:
+
+        lazy = image_io.GetLazyArray()
+        array = dask.array.from_array(lazy, chunks=lazy.chunks)
+        data = xarray.DataArray(array, dims=lazy.dims)
+
+    The reads release the global interpreter lock, so they run concurrently from several threads.
+    """
+
+    def __init__(self, image_io, dataset_index):
+        import numpy as np
+
+        shape, chunks, typestr, dims = image_io.GetDatasetArrayInfo(dataset_index)
+        self._image_io = image_io
+        self._dataset_index = dataset_index
+        self.shape = shape
+        self.chunks = chunks
+        self.dtype = np.dtype(typestr)
+        self.dims = dims
+
+    @property
+    def ndim(self):
+        return len(self.shape)
+
+    @property
+    def size(self):
+        size = 1
+        for n in self.shape:
+            size *= n
+        return size
+
+    @property
+    def nbytes(self):
+        return self.size * self.dtype.itemsize
+
+    def __len__(self):
+        return self.shape[0]
+
+    def __repr__(self):
+        return f"OMEZarrNGFFLazyArray(shape={self.shape}, dtype={self.dtype}, chunks={self.chunks}, dims={self.dims})"
+
+    def __array__(self, dtype=None, copy=None):
+        array = self[...]
+        return array if dtype is None else array.astype(dtype, copy=False)
+
+    def __getitem__(self, key):
+        if not isinstance(key, tuple):
+            key = (key,)
+        if any(k is Ellipsis for k in key):
+            e = key.index(Ellipsis)
+            key = key[:e] + (slice(None),) * (self.ndim - len(key) + 1) + key[e + 1 :]
+        if len(key) > self.ndim:
+            raise IndexError(f"too many indices for an array of {self.ndim} dimensions")
+        key = key + (slice(None),) * (self.ndim - len(key))
+
+        # The bounding box of the selection is read, then stepped through and squeezed
+        lower, upper, selection = [], [], []
+        for axis, (k, n) in enumerate(zip(key, self.shape)):
+            if isinstance(k, slice):
+                r = range(*k.indices(n))
+                if len(r) == 0:
+                    lower.append(0)
+                    upper.append(0)
+                    selection.append(slice(None))
+                    continue
+                lo, hi = min(r[0], r[-1]), max(r[0], r[-1]) + 1
+                stop = r.stop - lo
+                lower.append(lo)
+                upper.append(hi)
+                selection.append(slice(r.start - lo, None if stop < 0 else stop, r.step))
+            elif isinstance(k, int) or hasattr(k, "__index__"):
+                i = k.__index__()
+                if i < -n or i >= n:
+                    raise IndexError(f"index {i} is out of bounds for axis {axis} with size {n}")
+                i %= n
+                lower.append(i)
+                upper.append(i + 1)
+                selection.append(0)
+            else:
+                raise TypeError("only integers, slices and ellipsis are valid indices of a lazy array")
+        return self._read(lower, upper)[tuple(selection)]
+
+    def _read(self, lower, upper):
+        import numpy as np
+
+        out = np.empty([hi - lo for lo, hi in zip(lower, upper)], dtype=self.dtype)
+        if out.size == 0:
+            return out
+
+        # One region read per selected time point and channel, over the spatial axes in ITK order
+        sliced = {name: self.dims.index(name) for name in ("t", "c") if name in self.dims}
+        spatial = [axis for axis in range(self.ndim) if axis not in sliced.values()]
+        index = [lower[axis] for axis in reversed(spatial)]
+        size = [upper[axis] - lower[axis] for axis in reversed(spatial)]
+        t_axis, c_axis = sliced.get("t"), sliced.get("c")
+        t_range = range(lower[t_axis], upper[t_axis]) if t_axis is not None else [0]
+        c_range = range(lower[c_axis], upper[c_axis]) if c_axis is not None else [0]
+        for ti, t in enumerate(t_range):
+            for ci, c in enumerate(c_range):
+                target = [slice(None)] * self.ndim
+                if t_axis is not None:
+                    target[t_axis] = ti
+                if c_axis is not None:
+                    target[c_axis] = ci
+                view = out[tuple(target)]
+                if view.flags.c_contiguous:
+                    self._image_io.ReadDatasetRegionIntoBuffer(self._dataset_index, index, size, t, c, view)
+                else:
+                    contiguous = np.empty(view.shape, dtype=self.dtype)
+                    self._image_io.ReadDatasetRegionIntoBuffer(self._dataset_index, index, size, t, c, contiguous)
+                    view[...] = contiguous
+        return out
+%}
@@ -0,0 +1,75 @@
+#==========================================================================
+#
+#   Copyright NumFOCUS
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#          https://www.apache.org/licenses/LICENSE-2.0.txt
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+#
+#==========================================================================*/
+
+# Test indexing a dataset of an OME-Zarr store as a lazy array,
+# and wrapping it in a dask array when dask is available.
+
+import sys
+
+import itk
+import numpy as np
+
+if(len(sys.argv) < 3):
+    raise ValueError('Expected arguments: <path/to/input.png> <path/to/output.zarr>')
+
+image = itk.imread(sys.argv[1], itk.UC)
+expected = itk.array_view_from_image(image)
+
+imageio = itk.OMEZarrNGFFImageIO.New()
+itk.imwrite(image, sys.argv[2], imageio=imageio, compression=False)
+
+imageio = itk.OMEZarrNGFFImageIO.New()
+imageio.SetFileName(sys.argv[2])
+imageio.ReadImageInformation()
+lazy = imageio.GetLazyArray()
+print(lazy)
+
+assert lazy.shape == expected.shape, f'{lazy.shape} != {expected.shape}'
+assert lazy.dtype == expected.dtype, f'{lazy.dtype} != {expected.dtype}'
+assert lazy.dims == ('y', 'x'), lazy.dims
+assert len(lazy.chunks) == lazy.ndim
+
+for key in [
+    (slice(10, 50), slice(100, 180)),
+    (slice(None, None, 3), slice(5, None, 7)),
+    (slice(None, None, -2), slice(200, 20, -5)),
+    (17, slice(None)),
+    (slice(3, 9), -1),
+    (40, 60),
+    Ellipsis,
+    (Ellipsis, 33),
+    (slice(30, 30), slice(None)),
+]:
+    np.testing.assert_array_equal(lazy[key], expected[key], err_msg=str(key))
+np.testing.assert_array_equal(np.asarray(lazy), expected)
+
+try:
+    lazy[lazy.shape[0]]
+    raise AssertionError('Expected IndexError')
+except IndexError:
+    pass
+
+try:
+    import dask.array as da
+except ImportError:
+    print('dask is not available')
+else:
+    array = da.from_array(lazy, chunks=lazy.chunks)
+    np.testing.assert_array_equal(array[::2, 7:].compute(scheduler='threads'), expected[::2, 7:])
+
+print("Test finished")